@@ -0,0 +1,94 @@
+#include "Instrumentation.h"
+#include "JSONStreamWriter.h"
+
+namespace Utilities
+{
+#if INSTRUMENTATION_ENABLED
+    // Some 0.5 KiB per probe, in .bss.
+    std::array<ProbeHistogram_t, static_cast<std::size_t>(Probe_t::COUNT)> g_ProbeHistograms{};
+#endif
+
+    ProbeStatistics_t GetProbeStatistics(const Probe_t& probe)
+    {
+        ProbeStatistics_t statistics{};
+
+#if INSTRUMENTATION_ENABLED
+        const auto& histogram = g_ProbeHistograms[static_cast<std::size_t>(probe)];
+
+        // The walk is of but 124 buckets; short enough to hold off the
+        // probes, and ISRs, for, so that the figures are consistent.
+        core_util_critical_section_enter();
+        statistics.count   = histogram.count;
+        statistics.minimum = histogram.minimum;
+        statistics.maximum = histogram.maximum;
+
+        if (histogram.count > 0)
+        {
+            statistics.mean = static_cast<uint32_t>(histogram.total / histogram.count);
+
+            // The rank of the p99, rounded up.
+            const uint64_t rank = ((static_cast<uint64_t>(histogram.count) * 99) + 99) / 100;
+            uint64_t cumulative = 0;
+
+            for (std::size_t i = 0; i < PROBE_BUCKET_COUNT; ++i)
+            {
+                cumulative += histogram.buckets[i];
+
+                if (cumulative >= rank)
+                {
+                    statistics.p99 = std::min(ProbeBucketUpperBound(i), histogram.maximum);
+                    break;
+                }
+            }
+        }
+        core_util_critical_section_exit();
+#else
+        (void)probe;
+#endif
+
+        return statistics;
+    }
+
+    void ResetProbes()
+    {
+#if INSTRUMENTATION_ENABLED
+        for (auto& histogram : g_ProbeHistograms)
+        {
+            core_util_critical_section_enter();
+            histogram = ProbeHistogram_t{};
+            core_util_critical_section_exit();
+        }
+#endif
+    }
+
+    void WriteProbeStatistics(JSONStreamWriter& writer)
+    {
+        // Cycles to ns, as per the processor clock that NucleoF767ZIClock_t models.
+        auto nanoseconds = [](const uint32_t& cycles)
+        {
+            return std::chrono::duration_cast<NanoSecs_t>(NucleoF767ZIClock_t::duration(cycles)).count();
+        };
+
+        writer.BeginObject();
+
+        for (std::size_t i = 0; i < PROBE_NAMES.size(); ++i)
+        {
+            const auto statistics = GetProbeStatistics(static_cast<Probe_t>(i));
+
+            if (statistics.count == 0)
+            {
+                continue;
+            }
+
+            writer.Key(PROBE_NAMES[i]).BeginObject()
+                  .Member("n", statistics.count)
+                  .Member("minNs", nanoseconds(statistics.minimum))
+                  .Member("maxNs", nanoseconds(statistics.maximum))
+                  .Member("meanNs", nanoseconds(statistics.mean))
+                  .Member("p99Ns", nanoseconds(statistics.p99))
+                  .EndObject();
+        }
+
+        writer.EndObject();
+    }
+} // namespace
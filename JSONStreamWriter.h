@@ -0,0 +1,380 @@
+/***********************************************************************
+* @file      JSONStreamWriter.h
+*
+*    Streaming, zero-allocation JSON writer. Output is emitted directly
+*    into a fixed caller-provided buffer as it is written, rather than
+*    first building a picojson::value tree only to then serialize that
+*    into a std::string.
+*
+*    Should a sink be supplied (e.g. a function that sends to a socket),
+*    the buffer is handed to it and reused whenever it fills, hence
+*    documents larger than the buffer may be streamed as well.
+*
+*    Records may be described by a compile-time schema; a tuple of
+*    key/member-pointer fields, from which the members are written
+*    without any runtime lookup:
+*
+*    constexpr auto SCHEMA = std::make_tuple(
+*        JSONField_t<Record_t, uint32_t>{"seq", &Record_t::sequenceNumber}, ...);
+*
+*    WriteJSONMembers(writer, SCHEMA, record);
+*
+* @brief
+*
+* @note    The buffer is always kept NUL-terminated, so that View().data()
+*          may be handed straight to printf("%s").
+*
+* @warning Nesting is limited to MAXIMUM_DEPTH levels. Exceeding it, or
+*          running out of room without a sink, latches Good() false.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include "Utilities.h"
+
+namespace Utilities
+{
+    class JSONStreamWriter
+    {
+    public:
+        using Sink_t = mbed::Callback<bool(std::string_view)>;
+
+        static constexpr uint8_t MAXIMUM_DEPTH = 16;
+
+        // Pretty output is as per picojson's serialize(true): one member
+        // per line, indented by two spaces per level.
+        explicit JSONStreamWriter(std::span<char> buffer,
+                                  const bool& pretty = false,
+                                  const Sink_t& sink = nullptr)
+            : m_Buffer(buffer)
+            , m_Offset(0)
+            , m_Sink(sink)
+            , m_Depth(0)
+            , m_HasMembers(0)
+            , m_AfterKey(false)
+            , m_Pretty(pretty)
+            , m_Good(!buffer.empty())
+        {
+            Terminate();
+        }
+
+        JSONStreamWriter(const JSONStreamWriter&) = delete;
+        JSONStreamWriter& operator=(const JSONStreamWriter&) = delete;
+
+        JSONStreamWriter& BeginObject() { return Open('{'); }
+        JSONStreamWriter& EndObject()   { return Close('}'); }
+        JSONStreamWriter& BeginArray()  { return Open('['); }
+        JSONStreamWriter& EndArray()    { return Close(']'); }
+
+        JSONStreamWriter& Key(const std::string_view& key)
+        {
+            Separate();
+            PutString(key);
+            Put(':');
+            if (m_Pretty)
+            {
+                Put(' ');
+            }
+            m_AfterKey = true;
+            return *this;
+        }
+
+        JSONStreamWriter& Value(const std::string_view& value)
+        {
+            Separate();
+            PutString(value);
+            return *this;
+        }
+
+        JSONStreamWriter& Value(const char* value)
+        {
+            return Value(std::string_view(value ? value : ""));
+        }
+
+        JSONStreamWriter& Value(const bool& value)
+        {
+            Separate();
+            Put(value ? std::string_view("true") : std::string_view("false"));
+            return *this;
+        }
+
+        template <std::integral T>
+            requires (!std::is_same_v<T, bool>)
+        JSONStreamWriter& Value(const T& value)
+        {
+            FormatBuffer_t buffer{};
+
+            Separate();
+            Put(FormatInteger(buffer, value));
+            return *this;
+        }
+
+        template <std::floating_point T>
+        JSONStreamWriter& Value(const T& value, const int& decimalDigits = 2)
+        {
+            FormatBuffer_t buffer{};
+
+            Separate();
+
+            // JSON has no representation for NaN or the infinities.
+            if (std::isfinite(value))
+            {
+                Put(FormatFixed(buffer, value, decimalDigits));
+            }
+            else
+            {
+                Put(std::string_view("null"));
+            }
+            return *this;
+        }
+
+        // Time points are written as the count of their clock's ticks.
+        template <typename C, typename D>
+        JSONStreamWriter& Value(const std::chrono::time_point<C, D>& value)
+        {
+            return Value(value.time_since_epoch().count());
+        }
+
+        JSONStreamWriter& Null()
+        {
+            Separate();
+            Put(std::string_view("null"));
+            return *this;
+        }
+
+        template <typename T>
+        JSONStreamWriter& Member(const std::string_view& key, const T& value)
+        {
+            Key(key);
+            return Value(value);
+        }
+
+        // Hands everything buffered so far over to the sink, if any.
+        bool Flush()
+        {
+            if (m_Sink && (m_Offset > 0))
+            {
+                if (!m_Sink(std::string_view(m_Buffer.data(), m_Offset)))
+                {
+                    m_Good = false;
+                }
+                m_Offset = 0;
+                Terminate();
+            }
+            return m_Good;
+        }
+
+        // Complete, well-formed and nothing lost.
+        bool        Good() const { return (m_Good && (m_Depth == 0) && !m_AfterKey); }
+        std::size_t Size() const { return m_Offset; }
+
+        // What is buffered and not yet flushed.
+        std::string_view View() const { return std::string_view(m_Buffer.data(), m_Offset); }
+
+    private:
+        JSONStreamWriter& Open(const char& bracket)
+        {
+            Separate();
+            Put(bracket);
+
+            if (m_Depth >= MAXIMUM_DEPTH)
+            {
+                m_Good = false;
+                return *this;
+            }
+
+            m_Depth++;
+            m_HasMembers &= ~DepthBit();
+            return *this;
+        }
+
+        JSONStreamWriter& Close(const char& bracket)
+        {
+            if ((m_Depth == 0) || m_AfterKey)
+            {
+                m_Good = false;
+                return *this;
+            }
+
+            const bool hadMembers = (m_HasMembers & DepthBit());
+
+            m_Depth--;
+            if (m_Pretty && hadMembers)
+            {
+                NewLine();
+            }
+            Put(bracket);
+            return *this;
+        }
+
+        // Emits the comma, and the line break, that go before a key or a
+        // value, unless of course the value is that of a key just written.
+        void Separate()
+        {
+            if (m_AfterKey)
+            {
+                m_AfterKey = false;
+                return;
+            }
+
+            if (m_Depth > 0)
+            {
+                if (m_HasMembers & DepthBit())
+                {
+                    Put(',');
+                }
+                m_HasMembers |= DepthBit();
+
+                if (m_Pretty)
+                {
+                    NewLine();
+                }
+            }
+        }
+
+        void NewLine()
+        {
+            Put('\n');
+            for (uint8_t i = 0; i < m_Depth; ++i)
+            {
+                Put(std::string_view("  "));
+            }
+        }
+
+        void PutString(const std::string_view& text)
+        {
+            constexpr char DIGITS[] = "0123456789abcdef";
+
+            Put('"');
+            for (const auto& c : text)
+            {
+                const auto byte = static_cast<uint8_t>(c);
+
+                if ((c == '"') || (c == '\\'))
+                {
+                    Put('\\');
+                    Put(c);
+                }
+                else if (c == '\n')
+                {
+                    Put(std::string_view("\\n"));
+                }
+                else if (byte < 0x20)
+                {
+                    Put(std::string_view("\\u00"));
+                    Put(DIGITS[byte >> 4]);
+                    Put(DIGITS[byte & 0x0F]);
+                }
+                else
+                {
+                    Put(c);
+                }
+            }
+            Put('"');
+        }
+
+        void Put(const std::string_view& text)
+        {
+            for (const auto& c : text)
+            {
+                Put(c);
+            }
+        }
+
+        void Put(const char& c)
+        {
+            if (!m_Good)
+            {
+                return;
+            }
+
+            // The last byte is reserved for the NUL.
+            if ((m_Offset + 1) >= m_Buffer.size())
+            {
+                if (!m_Sink || !Flush() || ((m_Offset + 1) >= m_Buffer.size()))
+                {
+                    m_Good = false;
+                    return;
+                }
+            }
+
+            m_Buffer[m_Offset++] = c;
+            Terminate();
+        }
+
+        void Terminate()
+        {
+            if (m_Offset < m_Buffer.size())
+            {
+                m_Buffer[m_Offset] = '\0';
+            }
+        }
+
+        uint32_t DepthBit() const { return (uint32_t{1} << m_Depth); }
+
+        std::span<char>       m_Buffer;
+        std::size_t           m_Offset;
+        Sink_t                m_Sink;
+        uint8_t               m_Depth;
+        uint32_t              m_HasMembers; // One bit per nesting level.
+        bool                  m_AfterKey;
+        bool                  m_Pretty;
+        bool                  m_Good;
+    };
+
+    // One field of a compile-time record schema.
+    template <typename R, typename T>
+    struct JSONField_t
+    {
+        std::string_view   key;
+        T R::*             member;
+    };
+
+    // Schema keys are checked at compile-time to need no escaping.
+    constexpr bool IsPlainJSONKey(const std::string_view& key)
+    {
+        return !key.empty() && std::none_of(key.begin(), key.end(), [](const char& c)
+        {
+            return ((c == '"') || (c == '\\') || (static_cast<uint8_t>(c) < 0x20));
+        });
+    }
+
+    template <typename... F>
+    constexpr bool IsPlainJSONSchema(const std::tuple<F...>& schema)
+    {
+        return std::apply([](const auto&... field)
+        {
+            return (IsPlainJSONKey(field.key) && ...);
+        }, schema);
+    }
+
+    // Writes the record's members, in schema order, into the object that
+    // the writer currently has open.
+    template <typename R, typename... F>
+    JSONStreamWriter& WriteJSONMembers(JSONStreamWriter& writer,
+                                       const std::tuple<F...>& schema,
+                                       const R& record)
+    {
+        std::apply([&](const auto&... field)
+        {
+            (writer.Member(field.key, record.*(field.member)), ...);
+        }, schema);
+
+        return writer;
+    }
+
+    template <typename R, typename... F>
+    JSONStreamWriter& WriteJSONRecord(JSONStreamWriter& writer,
+                                      const std::tuple<F...>& schema,
+                                      const R& record)
+    {
+        writer.BeginObject();
+        WriteJSONMembers(writer, schema, record);
+        return writer.EndObject();
+    }
+} // End of namespace Utilities.
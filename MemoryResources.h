@@ -0,0 +1,269 @@
+/***********************************************************************
+* @file      MemoryResources.h
+*
+*    Fragmentation-free allocation for the long-running paths, as
+*    std::pmr::memory_resource implementations, so that any pmr container
+*    (std::pmr::string, std::pmr::vector, ...) may allocate from them
+*    simply by being handed one:
+*
+*    - FixedBlockPool, N blocks of B bytes apiece, each allocation taking
+*      one whole block off a free list. However the allocations churn,
+*      the pool can never fragment, and both allocating and freeing are
+*      a few instructions.
+*    - MonotonicArena, a bump allocator over C bytes in which freeing is
+*      a no-op; the lot is released at once, by Reset(). For results
+*      composed, used and discarded together, e.g. per message.
+*
+*    Both keep their occupancy, high-water mark and fallback count, for
+*    reporting alongside the heap statistics.
+*
+* @brief
+*
+* @note    An allocation that the resource cannot satisfy, for size or for
+*          want of room, falls back to the upstream resource, the heap by
+*          default, and is counted; a non-zero fallback count means the
+*          resource is undersized for its use.
+*
+*          The free list, and the bump pointer, are updated within a
+*          critical section, so that the one resource may be shared by
+*          any threads, and even ISRs, should the upstream be null. With
+*          no upstream, an allocation that cannot be satisfied returns
+*          nullptr, for allocate() called directly to check; hand a pmr
+*          container none such, for it cannot.
+*
+* @warning Reset() an arena only once nothing allocated from it is still
+*          in use.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <memory_resource>
+#include "mbed_critical.h"
+
+namespace Utilities
+{
+    struct MemoryResourceStatistics_t
+    {
+        uint32_t capacity;      // Bytes.
+        uint32_t inUse;         // Bytes; whole blocks, for a pool.
+        uint32_t highWater;     // Bytes.
+        uint32_t allocations;
+        uint32_t fallbacks;     // To the upstream resource.
+    };
+
+    template <std::size_t B, std::size_t N>
+    class FixedBlockPool : public std::pmr::memory_resource
+    {
+        static_assert(N > 0);
+        static_assert((B >= sizeof(void*)) && ((B % alignof(std::max_align_t)) == 0),
+                      "Blocks must hold a pointer, and keep every block maximally aligned.");
+
+    public:
+        explicit FixedBlockPool(std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource())
+            : m_pUpstream(pUpstream)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                m_Blocks[i].pNext = (i + 1 < N) ? &m_Blocks[i + 1] : nullptr;
+            }
+            m_pFree = &m_Blocks[0];
+        }
+
+        FixedBlockPool(const FixedBlockPool&) = delete;
+        FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+        static constexpr std::size_t GetBlockSize() { return B; }
+        static constexpr std::size_t GetBlockCount() { return N; }
+
+        MemoryResourceStatistics_t GetStatistics() const
+        {
+            core_util_critical_section_enter();
+            const MemoryResourceStatistics_t statistics{
+                static_cast<uint32_t>(B * N),
+                static_cast<uint32_t>(B * m_InUse),
+                static_cast<uint32_t>(B * m_HighWater),
+                m_Allocations,
+                m_Fallbacks};
+            core_util_critical_section_exit();
+
+            return statistics;
+        }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            Block_t* pBlock = nullptr;
+
+            if ((bytes <= B) && (alignment <= alignof(std::max_align_t)))
+            {
+                core_util_critical_section_enter();
+                pBlock = m_pFree;
+
+                if (pBlock)
+                {
+                    m_pFree = pBlock->pNext;
+                    m_HighWater = std::max(++m_InUse, m_HighWater);
+                    m_Allocations++;
+                }
+                core_util_critical_section_exit();
+            }
+
+            if (pBlock)
+            {
+                return pBlock->storage;
+            }
+
+            core_util_critical_section_enter();
+            m_Fallbacks++;
+            core_util_critical_section_exit();
+
+            return (m_pUpstream ? m_pUpstream->allocate(bytes, alignment) : nullptr);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            if (!Owns(p))
+            {
+                if (m_pUpstream)
+                {
+                    m_pUpstream->deallocate(p, bytes, alignment);
+                }
+                return;
+            }
+
+            Block_t* pBlock = static_cast<Block_t*>(p);
+
+            core_util_critical_section_enter();
+            pBlock->pNext = m_pFree;
+            m_pFree = pBlock;
+            m_InUse--;
+            core_util_critical_section_exit();
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return (this == &other);
+        }
+
+    private:
+        union Block_t
+        {
+            Block_t*                                pNext;
+            alignas(std::max_align_t) unsigned char storage[B];
+        };
+
+        bool Owns(const void* p) const
+        {
+            const auto address = reinterpret_cast<uintptr_t>(p);
+
+            return ((address >= reinterpret_cast<uintptr_t>(m_Blocks.data()))
+                 && (address < reinterpret_cast<uintptr_t>(m_Blocks.data() + N)));
+        }
+
+        std::array<Block_t, N>       m_Blocks{};
+        Block_t*                     m_pFree{nullptr};
+        std::pmr::memory_resource*   m_pUpstream;
+        std::size_t                  m_InUse{0};
+        std::size_t                  m_HighWater{0};
+        uint32_t                     m_Allocations{0};
+        uint32_t                     m_Fallbacks{0};
+    };
+
+    template <std::size_t C>
+    class MonotonicArena : public std::pmr::memory_resource
+    {
+        static_assert(C > 0);
+
+    public:
+        explicit MonotonicArena(std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource())
+            : m_pUpstream(pUpstream)
+        {
+        }
+
+        MonotonicArena(const MonotonicArena&) = delete;
+        MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+        // Releases everything allocated from the arena itself at once.
+        void Reset()
+        {
+            core_util_critical_section_enter();
+            m_Offset = 0;
+            core_util_critical_section_exit();
+        }
+
+        static constexpr std::size_t GetCapacity() { return C; }
+
+        MemoryResourceStatistics_t GetStatistics() const
+        {
+            core_util_critical_section_enter();
+            const MemoryResourceStatistics_t statistics{
+                static_cast<uint32_t>(C),
+                static_cast<uint32_t>(m_Offset),
+                static_cast<uint32_t>(m_HighWater),
+                m_Allocations,
+                m_Fallbacks};
+            core_util_critical_section_exit();
+
+            return statistics;
+        }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            void* p = nullptr;
+
+            core_util_critical_section_enter();
+            const auto base    = reinterpret_cast<uintptr_t>(m_Buffer.data());
+            const auto aligned = ((base + m_Offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+
+            if ((aligned <= C) && (bytes <= (C - aligned)))
+            {
+                p = m_Buffer.data() + aligned;
+                m_Offset = aligned + bytes;
+                m_HighWater = std::max(m_Offset, m_HighWater);
+                m_Allocations++;
+            }
+            else
+            {
+                m_Fallbacks++;
+            }
+            core_util_critical_section_exit();
+
+            return ((p || !m_pUpstream) ? p : m_pUpstream->allocate(bytes, alignment));
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            const auto address = reinterpret_cast<uintptr_t>(p);
+            const auto base    = reinterpret_cast<uintptr_t>(m_Buffer.data());
+
+            // Reclaimed only as of Reset().
+            if (((address < base) || (address >= (base + C))) && m_pUpstream)
+            {
+                m_pUpstream->deallocate(p, bytes, alignment);
+            }
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return (this == &other);
+        }
+
+    private:
+        alignas(std::max_align_t) std::array<unsigned char, C> m_Buffer{};
+        std::pmr::memory_resource*   m_pUpstream;
+        std::size_t                  m_Offset{0};
+        std::size_t                  m_HighWater{0};
+        uint32_t                     m_Allocations{0};
+        uint32_t                     m_Fallbacks{0};
+    };
+} // End of namespace Utilities.
@@ -0,0 +1,366 @@
+#include "NuerteyClockService.h"
+#include "Utilities.h"
+#include "Instrumentation.h"
+
+NuerteyClockService::NuerteyClockService(NuerteyNTPClient * pNTPClient,
+                                         events::EventQueue * pEventQueue,
+                                         const std::chrono::seconds & pollInterval)
+    : m_pNTPClient(pNTPClient)
+    , m_pEventQueue(pEventQueue)
+    , m_PollInterval(pollInterval)
+    , m_Anchor{0, 0, 0, 0}
+    , m_AdvancedCycles(0)
+    , m_RebaseTicker()
+    , m_LowPowerTimer()
+    , m_CoreClock(0)
+    , m_Synchronized(false)
+    , m_LinkUp(true)
+    , m_SynchronizedAt()
+    , m_LastOffset(0)
+    , m_LastRoundTripDelay(0)
+    , m_FrequencyCorrection(0)
+    , m_SlewRate(0)
+    , m_SlewRemaining(0)
+    , m_StepCount(0)
+    , m_FailedPollCount(0)
+    , m_PollExchangeCount(0)
+    , m_PollSampled(false)
+    , m_PollBestSample{}
+    , m_RebaseEventIdentifier(0)
+    , m_PollEventIdentifier(0)
+{
+}
+
+NuerteyClockService::~NuerteyClockService()
+{
+    Stop();
+    m_RebaseTicker.detach();
+}
+
+void NuerteyClockService::Anchor()
+{
+    if (m_Anchor.nanosecondsPerCycle)
+    {
+        return;
+    }
+
+    // Shared with the instrumentation probes, which never reset it either.
+    Utilities::EnableCycleCounter();
+
+    m_CoreClock = SystemCoreClock;
+
+    // Keeps counting in deep sleep, without holding it off.
+    m_LowPowerTimer.start();
+
+    core_util_critical_section_enter();
+    m_Anchor.cycles = CycleCount();
+    m_Anchor.lowPowerTime = m_LowPowerTimer.elapsed_time().count();
+    m_Anchor.utc = static_cast<int64_t>(time(NULL)) * 1'000'000'000;
+    m_Anchor.nanosecondsPerCycle = static_cast<uint32_t>(((1'000'000'000LL << 24) + (m_CoreClock / 2)) / m_CoreClock);
+    core_util_critical_section_exit();
+
+    m_RebaseTicker.attach(mbed::callback(this, &NuerteyClockService::OnRebaseTick), REBASE_PERIOD);
+}
+
+bool NuerteyClockService::Start()
+{
+    if (!m_pNTPClient || !m_pEventQueue || m_RebaseEventIdentifier)
+    {
+        return false;
+    }
+
+    Anchor();
+
+    m_RebaseEventIdentifier = m_pEventQueue->call_every(REBASE_PERIOD, this, &NuerteyClockService::OnRebase);
+    m_PollEventIdentifier = m_pEventQueue->call_every(
+        std::chrono::duration_cast<std::chrono::milliseconds>(m_PollInterval),
+        this, &NuerteyClockService::OnPoll);
+
+    m_pEventQueue->call(this, &NuerteyClockService::OnPoll);
+
+    if (!m_RebaseEventIdentifier || !m_PollEventIdentifier)
+    {
+        Utilities::g_STDIOMutex.lock();
+        printf("[%s]: Error! EventQueue could not schedule the clock discipline.\r\n", __PRETTY_FUNCTION__);
+        Utilities::g_STDIOMutex.unlock();
+
+        Stop();
+        return false;
+    }
+
+    return true;
+}
+
+void NuerteyClockService::Stop()
+{
+    if (m_RebaseEventIdentifier)
+    {
+        m_pEventQueue->cancel(m_RebaseEventIdentifier);
+        m_RebaseEventIdentifier = 0;
+    }
+
+    if (m_PollEventIdentifier)
+    {
+        m_pEventQueue->cancel(m_PollEventIdentifier);
+        m_PollEventIdentifier = 0;
+    }
+
+    if (m_PollExchangeCount)
+    {
+        m_pNTPClient->CancelExchange();
+        m_PollExchangeCount = 0;
+    }
+}
+
+bool NuerteyClockService::Synchronize()
+{
+    if (m_PollExchangeCount)
+    {
+        return false;
+    }
+
+    m_PollSampled = false;
+
+    if (!StartExchange())
+    {
+        m_FailedPollCount++;
+        return false;
+    }
+
+    return true;
+}
+
+int64_t NuerteyClockService::Now() const
+{
+    // CYCCNT is read within the critical section, so that it can never
+    // be older than the anchor.
+    core_util_critical_section_enter();
+    const uint32_t cycles = CycleCount();
+    const Anchor_t anchor = m_Anchor;
+    core_util_critical_section_exit();
+
+    if (!anchor.nanosecondsPerCycle)
+    {
+        return static_cast<int64_t>(time(NULL)) * 1'000'000'000;
+    }
+
+    return anchor.utc + static_cast<int64_t>(
+        (static_cast<uint64_t>(cycles - anchor.cycles) * anchor.nanosecondsPerCycle) >> 24);
+}
+
+void NuerteyClockService::OnRebaseTick()
+{
+    CatchUp();
+}
+
+void NuerteyClockService::CatchUp()
+{
+    core_util_critical_section_enter();
+    if (m_Anchor.nanosecondsPerCycle)
+    {
+        AdvanceAnchor(0);
+    }
+    core_util_critical_section_exit();
+}
+
+void NuerteyClockService::AdvanceAnchor(const int64_t & step)
+{
+    const uint32_t cycles = CycleCount();
+    const uint32_t elapsed = cycles - m_Anchor.cycles;
+    const int64_t  lowPowerTime = m_LowPowerTimer.elapsed_time().count();
+    const int64_t  lowPowerElapsed = lowPowerTime - m_Anchor.lowPowerTime;
+
+    int64_t  advance = static_cast<int64_t>((static_cast<uint64_t>(elapsed) * m_Anchor.nanosecondsPerCycle) >> 24);
+    uint64_t advancedCycles = elapsed;
+
+    // The CYCCNT halted, in deep sleep, for some of the while. At the
+    // nominal rate, hence none of it is slewed, and the slew carries on
+    // as of the next advance.
+    if (((lowPowerElapsed * 1'000) - advance) > (DEEP_SLEEP_THRESHOLD.count() * 1'000))
+    {
+        advance = lowPowerElapsed * 1'000;
+        advancedCycles = 0;
+    }
+
+    m_Anchor.utc += advance + step;
+    m_Anchor.cycles = cycles;
+    m_Anchor.lowPowerTime = lowPowerTime;
+    m_AdvancedCycles += advancedCycles;
+}
+
+void NuerteyClockService::OnRebase()
+{
+    Reanchor(0, m_FrequencyCorrection + m_SlewRate);
+
+    // However long since the EventQueue last got round to it.
+    const uint64_t elapsed = TakeAdvancedCycles();
+
+    if (m_SlewRate != 0)
+    {
+        const int64_t elapsedNanoseconds = static_cast<int64_t>(((elapsed / m_CoreClock) * 1'000'000'000)
+                                         + (((elapsed % m_CoreClock) * 1'000'000'000) / m_CoreClock));
+        const int64_t slewed = elapsedNanoseconds * m_SlewRate / 1'000'000'000;
+
+        m_SlewRemaining -= slewed;
+
+        // Done; the overshoot, of a REBASE_PERIOD's worth of slew at most,
+        // is for the next poll to take out.
+        if ((m_SlewRate > 0) == (m_SlewRemaining <= 0))
+        {
+            m_SlewRate = 0;
+            m_SlewRemaining = 0;
+            Reanchor(0, m_FrequencyCorrection);
+        }
+    }
+}
+
+void NuerteyClockService::OnLinkStateChanged(ConnectionState_t state)
+{
+    m_LinkUp = (state == ConnectionState_t::CONNECTED);
+
+    if (!m_RebaseEventIdentifier)
+    {
+        return;
+    }
+
+    if (m_LinkUp)
+    {
+        // No sense waiting out the poll interval; the outage may have
+        // been long enough for the clock to have drifted off.
+        Synchronize();
+    }
+    else if (m_PollExchangeCount)
+    {
+        // Abandoned, rather than failed.
+        m_PollExchangeCount = 0;
+        m_pNTPClient->CancelExchange();
+    }
+}
+
+void NuerteyClockService::OnPoll()
+{
+    if (m_LinkUp)
+    {
+        Synchronize();
+    }
+}
+
+void NuerteyClockService::OnExchange(bool success, const NTPSample_t & sample)
+{
+    if (success && (sample.delay >= 0) && (sample.delay <= MAXIMUM_ROUND_TRIP_DELAY_NSECS)
+        && (!m_PollSampled || (sample.delay < m_PollBestSample.delay)))
+    {
+        m_PollBestSample = sample;
+        m_PollSampled = true;
+    }
+
+    if ((m_PollExchangeCount < NTP_SAMPLES_PER_POLL) && StartExchange())
+    {
+        return;
+    }
+
+    // The poll is done.
+    m_PollExchangeCount = 0;
+
+    if (m_PollSampled)
+    {
+        Discipline(m_PollBestSample);
+    }
+    else
+    {
+        m_FailedPollCount++;
+    }
+}
+
+bool NuerteyClockService::StartExchange()
+{
+    // Counted beforehand, so that the poll stays bounded by
+    // NTP_SAMPLES_PER_POLL however soon the exchange completes.
+    m_PollExchangeCount++;
+
+    if (!m_pNTPClient->StartExchange([this]() { return Now(); },
+                                     mbed::callback(this, &NuerteyClockService::OnExchange)))
+    {
+        m_PollExchangeCount--;
+        return false;
+    }
+
+    return true;
+}
+
+void NuerteyClockService::Discipline(const NTPSample_t & sample)
+{
+    const auto now = Kernel::Clock::now();
+
+    m_LastOffset = sample.offset;
+    m_LastRoundTripDelay = sample.delay;
+
+    if (!m_Synchronized || (std::abs(sample.offset) >= STEP_THRESHOLD_NSECS))
+    {
+        m_SlewRate = 0;
+        m_SlewRemaining = 0;
+        Reanchor(sample.offset, m_FrequencyCorrection);
+        m_StepCount++;
+
+        Utilities::g_STDIOMutex.lock();
+        printf("\r\nStepped the clock by NTP offset: [%lld ns], round-trip delay: [%lld ns]\r\n",
+            sample.offset, sample.delay);
+        Utilities::g_STDIOMutex.unlock();
+    }
+    else
+    {
+        const int64_t interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_SynchronizedAt).count();
+
+        if (interval > 0)
+        {
+            // What a slew still in progress was yet to take out, is not
+            // of the crystal's doing.
+            const int64_t drift = (sample.offset - m_SlewRemaining) * 1'000 / interval;
+
+            m_FrequencyCorrection = static_cast<int32_t>(std::clamp<int64_t>(
+                m_FrequencyCorrection + (drift / 2), -MAXIMUM_FREQUENCY_PPB, MAXIMUM_FREQUENCY_PPB));
+        }
+
+        const int64_t pollInterval = std::chrono::duration_cast<std::chrono::milliseconds>(m_PollInterval).count();
+
+        m_SlewRate = static_cast<int32_t>(std::clamp<int64_t>(
+            sample.offset * 1'000 / pollInterval, -MAXIMUM_SLEW_PPB, MAXIMUM_SLEW_PPB));
+        m_SlewRemaining = (m_SlewRate != 0) ? sample.offset : 0;
+
+        Reanchor(0, m_FrequencyCorrection + m_SlewRate);
+    }
+
+    // The slew, if any, starts afresh from here.
+    TakeAdvancedCycles();
+
+    m_Synchronized = true;
+    m_SynchronizedAt = now;
+
+    // The RTC but counts whole seconds; it need only be thereabouts.
+    const std::time_t seconds = static_cast<std::time_t>(Now() / 1'000'000'000);
+
+    if (std::abs(static_cast<int64_t>(time(NULL) - seconds)) > 1)
+    {
+        set_time(seconds);
+    }
+}
+
+void NuerteyClockService::Reanchor(const int64_t & step, const int32_t & correction)
+{
+    const uint32_t rate = static_cast<uint32_t>((((1'000'000'000LL + correction) << 24) + (m_CoreClock / 2)) / m_CoreClock);
+
+    core_util_critical_section_enter();
+    AdvanceAnchor(step);
+    m_Anchor.nanosecondsPerCycle = rate;
+    core_util_critical_section_exit();
+}
+
+uint64_t NuerteyClockService::TakeAdvancedCycles()
+{
+    core_util_critical_section_enter();
+    const uint64_t cycles = m_AdvancedCycles;
+    m_AdvancedCycles = 0;
+    core_util_critical_section_exit();
+
+    return cycles;
+}
@@ -0,0 +1,182 @@
+/***********************************************************************
+* @file      NuerteyClockService.h
+*
+*    Sub-microsecond, drift-disciplined UTC, cheap enough to timestamp
+*    every single sample with.
+*
+*    The time is interpolated off the DWT cycle counter (CYCCNT) from an
+*    anchor, i.e. a (cycles, UTC) pair, and a rate, in ns per cycle as a
+*    Q8.24 fixed-point. Reading it is thus a register read, a subtraction
+*    and a 64-bit multiply, and is safe from any context, ISRs included.
+*
+*    The anchor is advanced every REBASE_PERIOD, well within the ~19.9 s
+*    that the 32-bit CYCCNT takes to wrap at 216 MHz, by a LowPowerTicker
+*    ISR, so that no EventQueue need be dispatched in time for it; the
+*    EventQueue merely keeps the slew's account. Every poll interval,
+*    NTP_SAMPLES_PER_POLL exchanges are made with the NTP server, and the
+*    one of least round-trip delay, hence of least offset error, is kept
+*    (as the clock filter of RFC 5905, section 10). Its offset is then:
+*
+*    - stepped, on the first poll or should it exceed STEP_THRESHOLD, or
+*    - slewed away, by way of the rate, over the next poll interval at
+*      most MAXIMUM_SLEW_PPB, much as adjtime() does. The part of each
+*      offset not due to a slew still in progress is a frequency error of
+*      the crystal, and is accumulated into a frequency correction.
+*
+*    The RTC is kept within a second or so of it, for time(NULL) and for
+*    Utilities::WhatTimeNow() and the like.
+*
+* @brief
+*
+* @note    The NTP exchanges of a poll are made one after the other, each
+*          asynchronously (see NuerteyNTPClient.h), so that a poll never
+*          blocks the EventQueue.
+*
+*          Whilst the link is down, as observed off the connection manager
+*          (see OnLinkStateChanged()), polls are skipped rather than left
+*          to time out and be counted as failed; a poll is made as soon as
+*          the link is back.
+*
+*          Anchor() is to be called at boot, network or no network; until
+*          then, Now() falls back to the RTC, to the second.
+*
+* @warning The CYCCNT halts in deep sleep; the LowPowerTimer, off the LSE,
+*          does not. Every advance of the anchor is thus checked against
+*          the low-power time elapsed and, should that exceed the cycles'
+*          by over DEEP_SLEEP_THRESHOLD, advanced by it instead. Until the
+*          anchor is next advanced, i.e. on waking, Now() is behind by the
+*          time slept; hence CatchUp(), ahead of timestamping anything.
+*          What remains is the low-power clock's own error over the sleep,
+*          its resolution, ~31 us of the LSE, plus its tolerance, some
+*          20 ppm, i.e. ~0.3 ms over a 15 s burst period, which the next
+*          poll, if any, takes out.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include "NuerteyNTPClient.h"
+#include "NuerteyConnectionManager.h"
+#include "mbed_events.h"
+#include "mbed.h"
+
+class NuerteyClockService
+{
+public:
+    static constexpr std::size_t               NTP_SAMPLES_PER_POLL = 4;
+    static constexpr std::chrono::seconds      DEFAULT_POLL_INTERVAL{64};
+    static constexpr std::chrono::milliseconds REBASE_PERIOD{5000};
+
+    // Beyond the low-power and cycle clocks' disagreement whilst awake.
+    static constexpr std::chrono::microseconds DEEP_SLEEP_THRESHOLD{1000};
+
+    static constexpr int64_t STEP_THRESHOLD_NSECS           = 128'000'000; // As ntpd.
+    static constexpr int64_t MAXIMUM_ROUND_TRIP_DELAY_NSECS = 500'000'000;
+    static constexpr int32_t MAXIMUM_SLEW_PPB               =     500'000; // As adjtime().
+    static constexpr int32_t MAXIMUM_FREQUENCY_PPB          =     500'000;
+
+    NuerteyClockService(NuerteyNTPClient * pNTPClient,
+                        events::EventQueue * pEventQueue,
+                        const std::chrono::seconds & pollInterval = DEFAULT_POLL_INTERVAL);
+
+    NuerteyClockService(const NuerteyClockService&) = delete;
+    NuerteyClockService& operator=(const NuerteyClockService&) = delete;
+
+    virtual ~NuerteyClockService();
+
+    // Enables the cycle counter and anchors to the RTC, as it stands, and
+    // keeps the anchor advancing thereafter; at once only.
+    void Anchor();
+
+    // Anchors, if not already, and polls straightaway and every poll
+    // interval thereafter. Stop() ends the discipline only; the time
+    // carries on, free-running at the rate last disciplined.
+    bool Start();
+    void Stop();
+
+    // Starts a poll, now, unless one is underway already.
+    bool Synchronize();
+
+    // A NuerteyConnectionManager::LinkObserver_t; in the EventQueue context.
+    void OnLinkStateChanged(ConnectionState_t state);
+
+    // ns since the UNIX epoch. Callable from any context.
+    int64_t Now() const;
+
+    // Advances the anchor now, rather than come the next rebase tick;
+    // on waking from deep sleep, that is. Callable from any context.
+    void CatchUp();
+
+    bool     IsSynchronized() const { return m_Synchronized; }
+    int64_t  GetLastOffset() const { return m_LastOffset; }
+    int64_t  GetLastRoundTripDelay() const { return m_LastRoundTripDelay; }
+    int32_t  GetFrequencyCorrection() const { return m_FrequencyCorrection; }
+    uint32_t GetStepCount() const { return m_StepCount; }
+    uint32_t GetFailedPollCount() const { return m_FailedPollCount; }
+
+protected:
+    // Read together, and written together, within critical sections.
+    struct Anchor_t
+    {
+        uint32_t cycles;
+        int64_t  utc;
+        uint32_t nanosecondsPerCycle; // Q8.24.
+        int64_t  lowPowerTime;        // us, off m_LowPowerTimer.
+    };
+
+    // Ticker ISR context; advances the anchor at the rate it has.
+    void OnRebaseTick();
+
+    // In the EventQueue context; accounts for the slew.
+    void OnRebase();
+    void OnPoll();
+    void OnExchange(bool success, const NTPSample_t & sample);
+
+    bool StartExchange();
+
+    void Discipline(const NTPSample_t & sample);
+
+    // Advances the anchor to now, stepping it by step ns and adopting the
+    // rate as corrected by correction ppb.
+    void Reanchor(const int64_t & step, const int32_t & correction);
+
+    // Within a critical section. By the cycles elapsed, or the low-power
+    // time should the cycle counter have halted meanwhile.
+    void AdvanceAnchor(const int64_t & step);
+
+    // The cycles the anchor has been advanced by since last taken.
+    uint64_t TakeAdvancedCycles();
+
+    static uint32_t CycleCount() { return DWT->CYCCNT; }
+
+private:
+    NuerteyNTPClient *              m_pNTPClient;
+    events::EventQueue *            m_pEventQueue;
+    std::chrono::seconds            m_PollInterval;
+    Anchor_t                        m_Anchor;              // Unanchored, whilst of zero rate.
+    uint64_t                        m_AdvancedCycles;
+    mbed::LowPowerTicker            m_RebaseTicker;
+    mbed::LowPowerTimer             m_LowPowerTimer;
+    uint32_t                        m_CoreClock;
+    bool                            m_Synchronized;
+    bool                            m_LinkUp;              // Presumed so, unless observed otherwise.
+    Kernel::Clock::time_point       m_SynchronizedAt;
+    int64_t                         m_LastOffset;
+    int64_t                         m_LastRoundTripDelay;
+    int32_t                         m_FrequencyCorrection; // ppb.
+    int32_t                         m_SlewRate;            // ppb.
+    int64_t                         m_SlewRemaining;       // ns.
+    uint32_t                        m_StepCount;
+    uint32_t                        m_FailedPollCount;
+    std::size_t                     m_PollExchangeCount;   // Of the poll underway, if any.
+    bool                            m_PollSampled;
+    NTPSample_t                     m_PollBestSample;
+    int                             m_RebaseEventIdentifier;
+    int                             m_PollEventIdentifier;
+};
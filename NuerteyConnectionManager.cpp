@@ -0,0 +1,294 @@
+#include "NuerteyConnectionManager.h"
+#include "Utilities.h"
+
+NuerteyConnectionManager::NuerteyConnectionManager(NetworkInterface * pNetworkInterface,
+                                                   events::EventQueue * pEventQueue,
+                                                   const std::chrono::milliseconds & initialBackoff,
+                                                   const std::chrono::milliseconds & maximumBackoff)
+    : m_pNetworkInterface(pNetworkInterface)
+    , m_pEventQueue(pEventQueue)
+    , m_Establish(nullptr)
+    , m_IsAlive(nullptr)
+    , m_Observers{}
+    , m_InitialBackoff(initialBackoff)
+    , m_MaximumBackoff(std::max(initialBackoff, maximumBackoff))
+    , m_Backoff(initialBackoff)
+    , m_State(ConnectionState_t::DISCONNECTED)
+    , m_AttemptEventIdentifier(0)
+    , m_SupervisionEventIdentifier(0)
+    , m_HasConnected(false)
+    , m_ConnectionAttemptCount(0)
+    , m_ReconnectionCount(0)
+{
+}
+
+NuerteyConnectionManager::~NuerteyConnectionManager()
+{
+    Stop();
+}
+
+void NuerteyConnectionManager::SetSession(const SessionCallback_t & establish,
+                                          const SessionCallback_t & isAlive)
+{
+    m_Establish = establish;
+    m_IsAlive = isAlive;
+}
+
+int NuerteyConnectionManager::Subscribe(const LinkObserver_t & observer)
+{
+    for (std::size_t i = 0; i < m_Observers.size(); ++i)
+    {
+        if (!m_Observers[i])
+        {
+            m_Observers[i] = observer;
+            return static_cast<int>(i + 1);
+        }
+    }
+
+    Utilities::g_STDIOMutex.lock();
+    printf("[%s]: Error! No room for another link observer.\n", __PRETTY_FUNCTION__);
+    Utilities::g_STDIOMutex.unlock();
+    return 0;
+}
+
+void NuerteyConnectionManager::Unsubscribe(const int & identifier)
+{
+    if ((identifier > 0) && (static_cast<std::size_t>(identifier) <= m_Observers.size()))
+    {
+        m_Observers[identifier - 1] = nullptr;
+    }
+}
+
+bool NuerteyConnectionManager::Start()
+{
+    if (m_SupervisionEventIdentifier || !m_pNetworkInterface || !m_pEventQueue)
+    {
+        return false;
+    }
+
+    // From here on, connect() merely kicks off the connection; its outcome
+    // is learnt of from the status callback, so that the EventQueue, and
+    // with it the store-and-forward, is never held up for the duration of
+    // DHCP or of the link coming back.
+    m_pNetworkInterface->set_blocking(false);
+
+    // The status callback is what tracks the link; this is the fallback.
+    m_SupervisionEventIdentifier = m_pEventQueue->call_every(
+        std::chrono::milliseconds(NETWORK_WATCHDOG_PERIOD_MSECS),
+        this, &NuerteyConnectionManager::Supervise);
+
+    if (!m_SupervisionEventIdentifier)
+    {
+        return false;
+    }
+
+    // A session without means of checking it must be established anew.
+    if (IsNetworkUp() && (!m_Establish || (m_IsAlive && m_IsAlive())))
+    {
+        m_State = ConnectionState_t::CONNECTED;
+        m_HasConnected = true;
+
+        // Posted, as are all the other notifications, so that the observers
+        // are called in the EventQueue context, rather than in Start()'s.
+        m_pEventQueue->call(this, &NuerteyConnectionManager::NotifyObservers, ConnectionState_t::CONNECTED);
+    }
+    else
+    {
+        ScheduleAttempt(std::chrono::milliseconds(0));
+    }
+
+    return true;
+}
+
+void NuerteyConnectionManager::Stop()
+{
+    if (m_SupervisionEventIdentifier)
+    {
+        m_pEventQueue->cancel(m_SupervisionEventIdentifier);
+        m_SupervisionEventIdentifier = 0;
+    }
+
+    if (m_AttemptEventIdentifier)
+    {
+        m_pEventQueue->cancel(m_AttemptEventIdentifier);
+        m_AttemptEventIdentifier = 0;
+    }
+}
+
+void NuerteyConnectionManager::OnNetworkStatus(nsapi_event_t status, intptr_t param)
+{
+    if ((status != NSAPI_EVENT_CONNECTION_STATUS_CHANGE) || !m_SupervisionEventIdentifier)
+    {
+        return;
+    }
+
+    // Defer to the EventQueue context, where all else happens.
+    if (param == NSAPI_STATUS_DISCONNECTED)
+    {
+        m_pEventQueue->call(this, &NuerteyConnectionManager::OnConnectionLost);
+    }
+    else if (param == NSAPI_STATUS_GLOBAL_UP)
+    {
+        // The link is back; no sense waiting out the backoff.
+        m_pEventQueue->call([this]()
+        {
+            if (m_State.load() != ConnectionState_t::CONNECTED)
+            {
+                if (m_AttemptEventIdentifier)
+                {
+                    m_pEventQueue->cancel(m_AttemptEventIdentifier);
+                    m_AttemptEventIdentifier = 0;
+                }
+                Attempt();
+            }
+        });
+    }
+}
+
+void NuerteyConnectionManager::ReportSessionLost()
+{
+    m_pEventQueue->call(this, &NuerteyConnectionManager::OnConnectionLost);
+}
+
+void NuerteyConnectionManager::Supervise()
+{
+    if (m_State.load() == ConnectionState_t::CONNECTED)
+    {
+        if (!IsNetworkUp() || (m_IsAlive && !m_IsAlive()))
+        {
+            OnConnectionLost();
+        }
+    }
+    else if (!m_AttemptEventIdentifier)
+    {
+        // Should ever an attempt have failed to be scheduled.
+        ScheduleAttempt(m_Backoff);
+    }
+}
+
+void NuerteyConnectionManager::Attempt()
+{
+    m_AttemptEventIdentifier = 0;
+
+    if (m_State.load() == ConnectionState_t::CONNECTED)
+    {
+        return;
+    }
+
+    m_State = ConnectionState_t::CONNECTING;
+    m_ConnectionAttemptCount++;
+
+    bool connected = IsNetworkUp();
+
+    if (!connected
+        && (m_pNetworkInterface->get_connection_status() == NSAPI_STATUS_DISCONNECTED))
+    {
+        nsapi_error_t status = m_pNetworkInterface->connect();
+
+        // The stack may yet consider itself connected to a link that is
+        // long gone; start it afresh.
+        if (status == NSAPI_ERROR_IS_CONNECTED)
+        {
+            m_pNetworkInterface->disconnect();
+            status = m_pNetworkInterface->connect();
+        }
+
+        if ((status < NSAPI_ERROR_OK) && (status != NSAPI_ERROR_IN_PROGRESS)
+            && (status != NSAPI_ERROR_ALREADY) && (status != NSAPI_ERROR_BUSY))
+        {
+            Utilities::g_STDIOMutex.lock();
+            printf("[%s]: Error! connect() returned: [%d] -> %s\n",
+                __PRETTY_FUNCTION__, status, ToString(status).data());
+            Utilities::g_STDIOMutex.unlock();
+        }
+    }
+
+    // The network being up, bring up the session riding upon it.
+    if (connected && m_Establish && !m_Establish())
+    {
+        Utilities::g_STDIOMutex.lock();
+        printf("[%s]: Error! Session could not be established.\n", __PRETTY_FUNCTION__);
+        Utilities::g_STDIOMutex.unlock();
+        connected = false;
+    }
+
+    if (connected)
+    {
+        m_State = ConnectionState_t::CONNECTED;
+        m_Backoff = m_InitialBackoff;
+
+        if (m_HasConnected)
+        {
+            m_ReconnectionCount++;
+        }
+        m_HasConnected = true;
+
+        Utilities::g_STDIOMutex.lock();
+        printf("Session established after [%lu] attempt(s)!\r\n", m_ConnectionAttemptCount);
+        Utilities::g_STDIOMutex.unlock();
+
+        NotifyObservers(ConnectionState_t::CONNECTED);
+        return;
+    }
+
+    // Should the link come up meanwhile, the status callback preempts this.
+    m_State = ConnectionState_t::DISCONNECTED;
+    ScheduleAttempt(m_Backoff);
+    m_Backoff = std::min(m_Backoff * 2, m_MaximumBackoff);
+}
+
+void NuerteyConnectionManager::ScheduleAttempt(const std::chrono::milliseconds & delay)
+{
+    if (m_AttemptEventIdentifier)
+    {
+        return;
+    }
+
+    if (delay.count() == 0)
+    {
+        m_AttemptEventIdentifier = m_pEventQueue->call(this, &NuerteyConnectionManager::Attempt);
+        return;
+    }
+
+    // Up to a further quarter of the delay, at random.
+    const auto jitter = std::chrono::milliseconds(
+        randLIB_get_32bit() % (static_cast<uint32_t>(delay.count() / 4) + 1));
+
+    m_AttemptEventIdentifier = m_pEventQueue->call_in(delay + jitter, this, &NuerteyConnectionManager::Attempt);
+}
+
+void NuerteyConnectionManager::OnConnectionLost()
+{
+    if (m_State.load() != ConnectionState_t::CONNECTED)
+    {
+        return;
+    }
+
+    m_State = ConnectionState_t::DISCONNECTED;
+    m_Backoff = m_InitialBackoff;
+
+    Utilities::g_STDIOMutex.lock();
+    printf("Session lost! Reconnecting with backoff; acquisition continues.\r\n");
+    Utilities::g_STDIOMutex.unlock();
+
+    NotifyObservers(ConnectionState_t::DISCONNECTED);
+
+    ScheduleAttempt(m_Backoff);
+    m_Backoff = std::min(m_Backoff * 2, m_MaximumBackoff);
+}
+
+void NuerteyConnectionManager::NotifyObservers(ConnectionState_t state)
+{
+    for (const auto & observer : m_Observers)
+    {
+        if (observer)
+        {
+            observer(state);
+        }
+    }
+}
+
+bool NuerteyConnectionManager::IsNetworkUp() const
+{
+    return (m_pNetworkInterface->get_connection_status() == NSAPI_STATUS_GLOBAL_UP);
+}
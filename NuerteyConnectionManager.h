@@ -0,0 +1,136 @@
+/***********************************************************************
+* @file      NuerteyConnectionManager.h
+*
+*    Persistent network session, kept up across link flaps by way of
+*    reconnection attempts with exponential backoff.
+*
+*    A disconnect no longer cancels the acquisition nor breaks the
+*    dispatch of the master EventQueue; acquisition carries on, and the
+*    telemetry publisher stores-and-forwards whilst the session is down
+*    (see NuerteyTelemetryPublisher.h). Meanwhile, reconnection of the
+*    network interface, and then of the session riding upon it (e.g. the
+*    MQTT connect), is attempted after 0.5 s, 1 s, 2 s, ... up to a cap,
+*    each delay randomly jittered so that a fleet of devices that lost
+*    the one broker together do not all reconnect in lockstep.
+*
+*    The link is tracked off the network stack's status callback, by way
+*    of OnNetworkStatus(), rather than by polling the interface; Supervise()
+*    is but a slow watchdog, every NETWORK_WATCHDOG_PERIOD_MSECS, against a
+*    status event gone missing, or a session that died quietly. Every time
+*    the session comes up, or goes down, the observers subscribed are told
+*    so, e.g. the publisher, to flush its backlog straightaway, and the
+*    clock service, to hold off polling NTP whilst there is no reaching it.
+*
+* @brief
+*
+* @note    Everything but OnNetworkStatus() runs in the EventQueue context.
+*          The observers are called in it too, one after the other, and so
+*          must not block for long.
+*          The connection attempts block that queue for as long as the
+*          underlying connect() calls take, which is acceptable as there
+*          is nothing to publish whilst disconnected anyway.
+*
+* @warning Retries never give up; it is 'embedded' after all and is meant
+*          to 'run forever'.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "NetworkInterface.h"
+#include "mbed_events.h"
+
+enum class ConnectionState_t : uint8_t
+{
+    DISCONNECTED,
+    CONNECTING,
+    CONNECTED
+};
+
+class NuerteyConnectionManager
+{
+public:
+    // Establishes, respectively checks, the session atop the network
+    // interface e.g. the MQTT connect or isConnected().
+    using SessionCallback_t = mbed::Callback<bool()>;
+
+    // Told of the session coming up, CONNECTED, or going down, DISCONNECTED.
+    using LinkObserver_t    = mbed::Callback<void(ConnectionState_t)>;
+
+    static constexpr std::size_t MAXIMUM_LINK_OBSERVERS = 4;
+
+    static constexpr std::chrono::milliseconds DEFAULT_INITIAL_BACKOFF{500};
+    static constexpr std::chrono::milliseconds DEFAULT_MAXIMUM_BACKOFF{60000};
+
+    NuerteyConnectionManager(NetworkInterface * pNetworkInterface,
+                             events::EventQueue * pEventQueue,
+                             const std::chrono::milliseconds & initialBackoff = DEFAULT_INITIAL_BACKOFF,
+                             const std::chrono::milliseconds & maximumBackoff = DEFAULT_MAXIMUM_BACKOFF);
+
+    NuerteyConnectionManager(const NuerteyConnectionManager&) = delete;
+    NuerteyConnectionManager& operator=(const NuerteyConnectionManager&) = delete;
+
+    virtual ~NuerteyConnectionManager();
+
+    // Optional; without a session, the manager keeps just the network
+    // interface itself up.
+    void SetSession(const SessionCallback_t & establish,
+                    const SessionCallback_t & isAlive = nullptr);
+
+    // Returns an identifier for Unsubscribe(), or zero should there be no
+    // room left. From the EventQueue context, or ahead of Start().
+    int  Subscribe(const LinkObserver_t & observer);
+    void Unsubscribe(const int & identifier);
+
+    // Starts supervising; should the session not be up already, the
+    // first attempt is made straightaway.
+    bool Start();
+    void Stop();
+
+    // From the network stack's status callback, in whatever its context.
+    void OnNetworkStatus(nsapi_event_t status, intptr_t param);
+
+    // The session is lost e.g. a publish failed. Triggers reconnection.
+    void ReportSessionLost();
+
+    // The watchdog; checks the interface, and the session, are still up.
+    void Supervise();
+
+    ConnectionState_t GetState() const { return m_State.load(); }
+    bool IsConnected() const { return (m_State.load() == ConnectionState_t::CONNECTED); }
+
+    std::chrono::milliseconds GetCurrentBackoff() const { return m_Backoff; }
+    uint32_t GetConnectionAttemptCount() const { return m_ConnectionAttemptCount; }
+    uint32_t GetReconnectionCount() const { return m_ReconnectionCount; }
+
+protected:
+    void Attempt();
+    void ScheduleAttempt(const std::chrono::milliseconds & delay);
+    void OnConnectionLost();
+    void NotifyObservers(ConnectionState_t state);
+    bool IsNetworkUp() const;
+
+private:
+    NetworkInterface *                 m_pNetworkInterface;
+    events::EventQueue *               m_pEventQueue;
+    SessionCallback_t                  m_Establish;
+    SessionCallback_t                  m_IsAlive;
+    std::array<LinkObserver_t, MAXIMUM_LINK_OBSERVERS> m_Observers;
+    std::chrono::milliseconds          m_InitialBackoff;
+    std::chrono::milliseconds          m_MaximumBackoff;
+    std::chrono::milliseconds          m_Backoff;
+    std::atomic<ConnectionState_t>     m_State;
+    int                                m_AttemptEventIdentifier;
+    int                                m_SupervisionEventIdentifier;
+    bool                               m_HasConnected;
+    uint32_t                           m_ConnectionAttemptCount;
+    uint32_t                           m_ReconnectionCount;
+};
@@ -0,0 +1,301 @@
+#include "NuerteyDNSCache.h"
+#include "Utilities.h"
+
+NuerteyDNSCache::NuerteyDNSCache(NetworkInterface * pNetworkInterface,
+                                 events::EventQueue * pEventQueue,
+                                 const std::chrono::seconds & timeToLive)
+    : m_pNetworkInterface(pNetworkInterface)
+    , m_pEventQueue(pEventQueue)
+    , m_TimeToLive(timeToLive)
+    , m_Entries{}
+    , m_Mutex()
+    , m_HitCount(0)
+    , m_MissCount(0)
+{
+    for (auto & entry : m_Entries)
+    {
+        entry.pCache = this;
+        entry.backoff = INITIAL_RETRY_BACKOFF;
+    }
+}
+
+NuerteyDNSCache::~NuerteyDNSCache()
+{
+}
+
+nsapi_error_t NuerteyDNSCache::Resolve(const char * pHostName, SocketAddress * pAddress)
+{
+    if (!pHostName || !pAddress)
+    {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if (pAddress->set_ip_address(pHostName))
+    {
+        return NSAPI_ERROR_OK;
+    }
+
+    m_Mutex.lock();
+    nsapi_error_t retVal = Check(Find(pHostName), pAddress);
+    m_Mutex.unlock();
+
+    if (retVal != NSAPI_ERROR_NO_ADDRESS)
+    {
+        return retVal;
+    }
+
+    // Not under the mutex, as this may well take seconds.
+    SocketAddress address;
+    retVal = m_pNetworkInterface->gethostbyname(pHostName, &address);
+
+    m_Mutex.lock();
+    Entry_t * pEntry = Find(pHostName);
+
+    if (!pEntry)
+    {
+        pEntry = Allocate(pHostName);
+    }
+
+    if (pEntry && !pEntry->pending)
+    {
+        Update(pEntry, retVal, address);
+    }
+    m_Mutex.unlock();
+
+    if (retVal < 0)
+    {
+        return retVal;
+    }
+
+    *pAddress = address;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t NuerteyDNSCache::ResolveAsync(const char * pHostName, SocketAddress * pAddress,
+                                            const ResolvedCallback_t & callback)
+{
+    if (!pHostName || !pAddress || !m_pEventQueue)
+    {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if (pAddress->set_ip_address(pHostName))
+    {
+        return NSAPI_ERROR_OK;
+    }
+
+    m_Mutex.lock();
+    Entry_t * pEntry = Find(pHostName);
+    nsapi_error_t retVal = Check(pEntry, pAddress);
+
+    if (retVal != NSAPI_ERROR_NO_ADDRESS)
+    {
+        m_Mutex.unlock();
+        return retVal;
+    }
+
+    if (!pEntry)
+    {
+        pEntry = Allocate(pHostName);
+    }
+
+    if (!pEntry)
+    {
+        m_Mutex.unlock();
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    // Should the outcome never make it back, e.g. the EventQueue was full,
+    // the entry is given up on after the maximum backoff.
+    pEntry->pending = true;
+    pEntry->retryAt = Kernel::Clock::now() + MAXIMUM_RETRY_BACKOFF;
+    pEntry->callback = callback;
+    m_Mutex.unlock();
+
+    nsapi_value_or_error_t result = m_pNetworkInterface->gethostbyname_async(pHostName,
+        mbed::Callback<void(nsapi_value_or_error_t, SocketAddress *)>(pEntry, &Entry_t::OnLookup));
+
+    if (result < 0)
+    {
+        m_Mutex.lock();
+        pEntry->pending = false;
+        pEntry->callback = nullptr;
+        Update(pEntry, result, SocketAddress());
+        m_Mutex.unlock();
+        return result;
+    }
+
+    return NSAPI_ERROR_IN_PROGRESS;
+}
+
+void NuerteyDNSCache::Invalidate(const char * pHostName)
+{
+    m_Mutex.lock();
+    Entry_t * pEntry = Find(pHostName);
+
+    if (pEntry && !pEntry->pending)
+    {
+        // Looked up afresh on the next resolve, without backing off.
+        pEntry->resolved = false;
+        pEntry->retryAt = Kernel::Clock::now();
+    }
+    m_Mutex.unlock();
+}
+
+void NuerteyDNSCache::Clear()
+{
+    m_Mutex.lock();
+    for (auto & entry : m_Entries)
+    {
+        if (!entry.pending)
+        {
+            entry.hostName[0] = '\0';
+            entry.resolved = false;
+            entry.backoff = INITIAL_RETRY_BACKOFF;
+        }
+    }
+    m_Mutex.unlock();
+}
+
+void NuerteyDNSCache::Entry_t::OnLookup(nsapi_value_or_error_t result, SocketAddress * pAddress)
+{
+    // Rather than dwell in the network stack's context:
+    pCache->m_pEventQueue->call(pCache, &NuerteyDNSCache::OnLookupComplete, this,
+        static_cast<nsapi_error_t>((result < 0) ? result : NSAPI_ERROR_OK),
+        pAddress ? *pAddress : SocketAddress());
+}
+
+NuerteyDNSCache::Entry_t * NuerteyDNSCache::Find(const char * pHostName)
+{
+    for (auto & entry : m_Entries)
+    {
+        if ((entry.hostName[0] != '\0') && (strcmp(entry.hostName.data(), pHostName) == 0))
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+NuerteyDNSCache::Entry_t * NuerteyDNSCache::Allocate(const char * pHostName)
+{
+    if (strlen(pHostName) > MAXIMUM_HOST_NAME_LENGTH)
+    {
+        return nullptr;
+    }
+
+    // A free entry, else the least recently used of those not pending.
+    Entry_t * pVictim = nullptr;
+
+    for (auto & entry : m_Entries)
+    {
+        if (entry.hostName[0] == '\0')
+        {
+            pVictim = &entry;
+            break;
+        }
+
+        if (!entry.pending && (!pVictim || (entry.lastUsedAt < pVictim->lastUsedAt)))
+        {
+            pVictim = &entry;
+        }
+    }
+
+    if (pVictim)
+    {
+        strcpy(pVictim->hostName.data(), pHostName);
+        pVictim->resolved = false;
+        pVictim->pending = false;
+        pVictim->backoff = INITIAL_RETRY_BACKOFF;
+        pVictim->retryAt = Kernel::Clock::time_point();
+        pVictim->lastUsedAt = Kernel::Clock::now();
+        pVictim->callback = nullptr;
+    }
+
+    return pVictim;
+}
+
+nsapi_error_t NuerteyDNSCache::Check(Entry_t * pEntry, SocketAddress * pAddress)
+{
+    if (!pEntry)
+    {
+        m_MissCount++;
+        return NSAPI_ERROR_NO_ADDRESS;
+    }
+
+    const auto now = Kernel::Clock::now();
+
+    if (pEntry->pending)
+    {
+        if (now < pEntry->retryAt)
+        {
+            return NSAPI_ERROR_BUSY;
+        }
+
+        // The outcome never made it back.
+        pEntry->pending = false;
+        pEntry->callback = nullptr;
+    }
+    else if (pEntry->resolved && (now < pEntry->expiresAt))
+    {
+        *pAddress = pEntry->address;
+        pEntry->lastUsedAt = now;
+        m_HitCount++;
+        return NSAPI_ERROR_OK;
+    }
+    else if (!pEntry->resolved && (now < pEntry->retryAt))
+    {
+        return NSAPI_ERROR_DNS_FAILURE;
+    }
+
+    m_MissCount++;
+    return NSAPI_ERROR_NO_ADDRESS;
+}
+
+void NuerteyDNSCache::Update(Entry_t * pEntry, const nsapi_error_t & result, const SocketAddress & address)
+{
+    const auto now = Kernel::Clock::now();
+
+    if (result == NSAPI_ERROR_OK)
+    {
+        pEntry->address = address;
+        pEntry->resolved = true;
+        pEntry->expiresAt = now + m_TimeToLive;
+        pEntry->backoff = INITIAL_RETRY_BACKOFF;
+    }
+    else
+    {
+        Utilities::g_STDIOMutex.lock();
+        printf("[%s]: Error! On DNS lookup of \"%s\", Network returned: [%d] -> %s. Retrying in %lld ms.\r\n",
+            __PRETTY_FUNCTION__, pEntry->hostName.data(), result, ToString(result).data(), pEntry->backoff.count());
+        Utilities::g_STDIOMutex.unlock();
+
+        pEntry->resolved = false;
+        pEntry->retryAt = now + pEntry->backoff;
+        pEntry->backoff = std::min(pEntry->backoff * 2, MAXIMUM_RETRY_BACKOFF);
+    }
+
+    pEntry->lastUsedAt = now;
+}
+
+void NuerteyDNSCache::OnLookupComplete(Entry_t * pEntry, nsapi_error_t result, SocketAddress address)
+{
+    m_Mutex.lock();
+    ResolvedCallback_t callback = pEntry->callback;
+    const bool pending = pEntry->pending;
+
+    pEntry->pending = false;
+    pEntry->callback = nullptr;
+
+    // Unless it was given up on, and since reused.
+    if (pending)
+    {
+        Update(pEntry, result, address);
+    }
+    m_Mutex.unlock();
+
+    if (pending && callback)
+    {
+        callback(result, address);
+    }
+}
@@ -0,0 +1,115 @@
+/***********************************************************************
+* @file      NuerteyDNSCache.h
+*
+*    Shared cache of DNS lookups, so that the MQTT broker, the HTTP and
+*    NTP servers etc. are each resolved but the once per time-to-live,
+*    rather than by every connect() and every poll.
+*
+*    A failed lookup is not repeated until a backoff has elapsed, 1 s, 2 s,
+*    ... up to MAXIMUM_RETRY_BACKOFF, so that an unreachable DNS server is
+*    not hammered, and the caller is not stalled, in a tight loop.
+*
+*    Resolve() blocks on a miss, for startup and for threads that can
+*    afford to. ResolveAsync() never blocks; a miss is looked up by way of
+*    gethostbyname_async(), and the outcome delivered on the EventQueue.
+*
+* @brief
+*
+* @note    mbed's gethostbyname() does not surface the TTL of the answer;
+*          entries thus expire after a configurable time-to-live instead.
+*
+* @warning A host name longer than MAXIMUM_HOST_NAME_LENGTH is not cached;
+*          Resolve() looks it up every time, and ResolveAsync() refuses it.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "NetworkInterface.h"
+#include "mbed_events.h"
+#include "mbed.h"
+
+class NuerteyDNSCache
+{
+public:
+    // In the EventQueue context.
+    using ResolvedCallback_t = mbed::Callback<void(nsapi_error_t, const SocketAddress &)>;
+
+    static constexpr std::size_t               MAXIMUM_ENTRIES          = 8;
+    static constexpr std::size_t               MAXIMUM_HOST_NAME_LENGTH = 63;
+    static constexpr std::chrono::seconds      DEFAULT_TIME_TO_LIVE{300};
+    static constexpr std::chrono::milliseconds INITIAL_RETRY_BACKOFF{1000};
+    static constexpr std::chrono::milliseconds MAXIMUM_RETRY_BACKOFF{60000};
+
+    NuerteyDNSCache(NetworkInterface * pNetworkInterface,
+                    events::EventQueue * pEventQueue,
+                    const std::chrono::seconds & timeToLive = DEFAULT_TIME_TO_LIVE);
+
+    NuerteyDNSCache(const NuerteyDNSCache&) = delete;
+    NuerteyDNSCache& operator=(const NuerteyDNSCache&) = delete;
+
+    virtual ~NuerteyDNSCache();
+
+    // IP address literals are 'resolved' as is. NSAPI_ERROR_DNS_FAILURE
+    // whilst backing off from a failed lookup.
+    nsapi_error_t Resolve(const char * pHostName, SocketAddress * pAddress);
+
+    // NSAPI_ERROR_OK, and pAddress filled in, on a hit. NSAPI_ERROR_IN_PROGRESS
+    // on a miss, in which case the callback is to be invoked later, on the
+    // EventQueue, with the outcome. Any other error, and it is not.
+    nsapi_error_t ResolveAsync(const char * pHostName, SocketAddress * pAddress,
+                               const ResolvedCallback_t & callback);
+
+    // E.g. the server at the cached address has stopped answering.
+    void Invalidate(const char * pHostName);
+    void Clear();
+
+    uint32_t GetHitCount() const { return m_HitCount; }
+    uint32_t GetMissCount() const { return m_MissCount; }
+
+protected:
+    struct Entry_t
+    {
+        NuerteyDNSCache *                              pCache;
+        std::array<char, MAXIMUM_HOST_NAME_LENGTH + 1> hostName;
+        SocketAddress                                  address;
+        Kernel::Clock::time_point                      expiresAt;
+        Kernel::Clock::time_point                      retryAt;
+        std::chrono::milliseconds                      backoff;
+        Kernel::Clock::time_point                      lastUsedAt;
+        bool                                           resolved;
+        bool                                           pending;       // Until retryAt, at the latest.
+        ResolvedCallback_t                             callback;
+
+        // From gethostbyname_async(), in the network stack's context.
+        void OnLookup(nsapi_value_or_error_t result, SocketAddress * pAddress);
+    };
+
+    // Of the cache mutex's holder.
+    Entry_t * Find(const char * pHostName);
+    Entry_t * Allocate(const char * pHostName);
+
+    // NSAPI_ERROR_OK on a hit, NSAPI_ERROR_DNS_FAILURE whilst backing off,
+    // NSAPI_ERROR_BUSY whilst an asynchronous lookup is underway, and
+    // NSAPI_ERROR_NO_ADDRESS should it be for looking up.
+    nsapi_error_t Check(Entry_t * pEntry, SocketAddress * pAddress);
+
+    void Update(Entry_t * pEntry, const nsapi_error_t & result, const SocketAddress & address);
+    void OnLookupComplete(Entry_t * pEntry, nsapi_error_t result, SocketAddress address);
+
+private:
+    NetworkInterface *                      m_pNetworkInterface;
+    events::EventQueue *                    m_pEventQueue;
+    std::chrono::seconds                    m_TimeToLive;
+    std::array<Entry_t, MAXIMUM_ENTRIES>    m_Entries;
+    PlatformMutex                           m_Mutex;
+    uint32_t                                m_HitCount;
+    uint32_t                                m_MissCount;
+};
@@ -0,0 +1,401 @@
+#include "NuerteyFlashJournal.h"
+#include "TelemetryEncoding.h"
+#include "kvstore_global_api.h"
+
+NuerteyFlashJournal::NuerteyFlashJournal(BlockDevice * pBlockDevice,
+                                         const char * pAcknowledgementKey)
+    : m_pBlockDevice(pBlockDevice)
+    , m_pAcknowledgementKey(pAcknowledgementKey)
+    , m_WriteBuffer{}
+    , m_ReadBuffer{}
+    , m_Mounted(false)
+    , m_PageCount(0)
+    , m_PagesPerEraseBlock(0)
+    , m_WritePage(0)
+    , m_ReplayPage(0)
+    , m_UnreplayedPageCount(0)
+    , m_BufferedCount(0)
+    , m_BufferedHeader{}
+    , m_NextSequenceNumber(0)
+    , m_AcknowledgedSequenceNumber(0)
+    , m_HasAcknowledgement(false)
+    , m_AcknowledgementDirty(false)
+    , m_AcknowledgementPersistedAt()
+    , m_ProgrammedPageCount(0)
+    , m_DiscardedPageCount(0)
+{
+}
+
+NuerteyFlashJournal::~NuerteyFlashJournal()
+{
+    Unmount();
+}
+
+bool NuerteyFlashJournal::Mount()
+{
+    if (m_Mounted)
+    {
+        return true;
+    }
+
+    if (!m_pBlockDevice || (m_pBlockDevice->init() != 0))
+    {
+        printf("[%s]: Error! Block device could not be initialized.\n", __PRETTY_FUNCTION__);
+        return false;
+    }
+
+    // Uniform erase blocks, each a whole number of pages, are assumed.
+    const bd_size_t eraseSize = m_pBlockDevice->get_erase_size();
+
+    if ((JOURNAL_PAGE_SIZE % m_pBlockDevice->get_program_size())
+        || (JOURNAL_PAGE_SIZE % m_pBlockDevice->get_read_size())
+        || (eraseSize % JOURNAL_PAGE_SIZE)
+        || ((m_pBlockDevice->size() / eraseSize) < 2))
+    {
+        printf("[%s]: Error! Block device geometry is unsuitable for the journal.\n", __PRETTY_FUNCTION__);
+        m_pBlockDevice->deinit();
+        return false;
+    }
+
+    m_PagesPerEraseBlock = static_cast<uint32_t>(eraseSize / JOURNAL_PAGE_SIZE);
+    m_PageCount = static_cast<uint32_t>(m_pBlockDevice->size() / eraseSize) * m_PagesPerEraseBlock;
+
+    std::size_t length = 0;
+    m_HasAcknowledgement = ((kv_get(m_pAcknowledgementKey, &m_AcknowledgedSequenceNumber,
+                                    sizeof(m_AcknowledgedSequenceNumber), &length) == MBED_SUCCESS)
+                            && (length == sizeof(m_AcknowledgedSequenceNumber)));
+
+    // Find the newest page, and the oldest one with readings yet to be
+    // acknowledged.
+    bool     hasNewest = false;
+    bool     hasOldest = false;
+    uint32_t newestPage = 0;
+    uint32_t oldestPage = 0;
+    JournalPageHeader_t newest{};
+    JournalPageHeader_t oldest{};
+    JournalPageHeader_t header{};
+
+    for (uint32_t page = 0; page < m_PageCount; ++page)
+    {
+        if (!ReadPage(page, header))
+        {
+            continue;
+        }
+
+        const uint32_t last = header.sequenceNumber + header.count - 1;
+
+        if (!hasNewest || SequenceAfter(last, newest.sequenceNumber + newest.count - 1))
+        {
+            hasNewest = true;
+            newestPage = page;
+            newest = header;
+        }
+
+        if ((!m_HasAcknowledgement || SequenceAfter(last, m_AcknowledgedSequenceNumber))
+            && (!hasOldest || SequenceAfter(oldest.sequenceNumber, header.sequenceNumber)))
+        {
+            hasOldest = true;
+            oldestPage = page;
+            oldest = header;
+        }
+    }
+
+    if (hasNewest)
+    {
+        // The remainder of the newest page's erase block may have been
+        // partly programmed by a write that was torn; resume at the next.
+        m_NextSequenceNumber = newest.sequenceNumber + newest.count;
+        m_WritePage = ((newestPage / m_PagesPerEraseBlock + 1) * m_PagesPerEraseBlock) % m_PageCount;
+    }
+    else
+    {
+        m_NextSequenceNumber = m_HasAcknowledgement ? (m_AcknowledgedSequenceNumber + 1) : 0;
+        m_WritePage = 0;
+    }
+
+    m_ReplayPage = hasOldest ? oldestPage : m_WritePage;
+    m_UnreplayedPageCount = 0;
+
+    if (hasOldest)
+    {
+        m_UnreplayedPageCount = PagesFromReplayToWrite();
+    }
+    m_BufferedCount = 0;
+    m_AcknowledgementDirty = false;
+    m_AcknowledgementPersistedAt = Kernel::Clock::now();
+    m_Mounted = true;
+
+    printf("Journal mounted: [%lu] pages, next sequence number [%lu], replay %s.\r\n",
+        m_PageCount, m_NextSequenceNumber, hasOldest ? "pending" : "not needed");
+
+    return true;
+}
+
+void NuerteyFlashJournal::Unmount()
+{
+    if (!m_Mounted)
+    {
+        return;
+    }
+
+    Sync();
+    PersistAcknowledgement();
+    m_pBlockDevice->sync();
+    m_pBlockDevice->deinit();
+    m_Mounted = false;
+}
+
+bool NuerteyFlashJournal::Append(const uint32_t & timestamp,
+                                 const uint32_t & samplePeriod,
+                                 std::span<const int16_t> readings)
+{
+    if (!m_Mounted)
+    {
+        return false;
+    }
+
+    bool result = true;
+
+    for (std::size_t i = 0; i < readings.size(); ++i)
+    {
+        if (m_BufferedCount == 0)
+        {
+            m_BufferedHeader.sequenceNumber = m_NextSequenceNumber;
+            m_BufferedHeader.timestamp      = timestamp + static_cast<uint32_t>((i * samplePeriod) / 1000);
+            m_BufferedHeader.samplePeriod   = samplePeriod;
+        }
+
+        Utilities::StoreLittleEndian(&m_WriteBuffer[JOURNAL_PAGE_HEADER_SIZE + (m_BufferedCount * sizeof(int16_t))],
+                                     static_cast<uint16_t>(readings[i]));
+        m_BufferedCount++;
+        m_NextSequenceNumber++;
+
+        if (m_BufferedCount == JOURNAL_READINGS_PER_PAGE)
+        {
+            result = ProgramPage() && result;
+        }
+    }
+
+    return result;
+}
+
+bool NuerteyFlashJournal::Sync()
+{
+    return (m_BufferedCount == 0) || ProgramPage();
+}
+
+std::size_t NuerteyFlashJournal::Replay(JournalPageHeader_t & header,
+                                        std::span<int16_t> readings)
+{
+    if (!m_Mounted || (readings.size() < JOURNAL_READINGS_PER_PAGE))
+    {
+        return 0;
+    }
+
+    while (m_UnreplayedPageCount > 0)
+    {
+        const uint32_t page = m_ReplayPage;
+        m_ReplayPage = NextPage(m_ReplayPage);
+        m_UnreplayedPageCount--;
+
+        // Erased, or skipped over after a reboot.
+        if (!ReadPage(page, header))
+        {
+            continue;
+        }
+
+        std::size_t skip = 0;
+
+        if (m_HasAcknowledgement && !SequenceAfter(header.sequenceNumber, m_AcknowledgedSequenceNumber))
+        {
+            skip = m_AcknowledgedSequenceNumber + 1 - header.sequenceNumber;
+        }
+
+        if (skip >= header.count)
+        {
+            continue;
+        }
+
+        const std::size_t count = header.count - skip;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            readings[i] = static_cast<int16_t>(Utilities::LoadLittleEndian<uint16_t>(
+                &m_ReadBuffer[JOURNAL_PAGE_HEADER_SIZE + ((skip + i) * sizeof(int16_t))]));
+        }
+
+        header.sequenceNumber += skip;
+        header.timestamp      += static_cast<uint32_t>((skip * header.samplePeriod) / 1000);
+        header.count           = static_cast<uint16_t>(count);
+        return count;
+    }
+
+    return 0;
+}
+
+void NuerteyFlashJournal::Acknowledge(const uint32_t & sequenceNumber)
+{
+    if (m_HasAcknowledgement && !SequenceAfter(sequenceNumber, m_AcknowledgedSequenceNumber))
+    {
+        return;
+    }
+
+    m_AcknowledgedSequenceNumber = sequenceNumber;
+    m_HasAcknowledgement = true;
+    m_AcknowledgementDirty = true;
+
+    // Rate-limited, so as to spare the KVStore's own flash.
+    if ((Kernel::Clock::now() - m_AcknowledgementPersistedAt) >= ACKNOWLEDGEMENT_PERSISTENCE_PERIOD)
+    {
+        PersistAcknowledgement();
+    }
+}
+
+void NuerteyFlashJournal::OnLinkStateChanged(ConnectionState_t state)
+{
+    if (m_Mounted && (state == ConnectionState_t::DISCONNECTED))
+    {
+        PersistAcknowledgement();
+    }
+}
+
+bool NuerteyFlashJournal::PersistAcknowledgement()
+{
+    if (!m_AcknowledgementDirty)
+    {
+        return true;
+    }
+
+    m_AcknowledgementPersistedAt = Kernel::Clock::now();
+
+    int status = kv_set(m_pAcknowledgementKey, &m_AcknowledgedSequenceNumber,
+                        sizeof(m_AcknowledgedSequenceNumber), 0);
+
+    if (status != MBED_SUCCESS)
+    {
+        printf("[%s]: Error! kv_set() returned: [%d]\n", __PRETTY_FUNCTION__, status);
+        return false;
+    }
+
+    m_AcknowledgementDirty = false;
+    return true;
+}
+
+bool NuerteyFlashJournal::ProgramPage()
+{
+    const std::size_t length = JOURNAL_PAGE_HEADER_SIZE + (m_BufferedCount * sizeof(int16_t));
+
+    auto p = m_WriteBuffer.data();
+    p = Utilities::StoreLittleEndian(p, JOURNAL_PAGE_MAGIC);
+    p = Utilities::StoreLittleEndian(p, m_BufferedHeader.sequenceNumber);
+    p = Utilities::StoreLittleEndian(p, m_BufferedHeader.timestamp);
+    p = Utilities::StoreLittleEndian(p, m_BufferedHeader.samplePeriod);
+    p = Utilities::StoreLittleEndian(p, m_BufferedCount);
+    Utilities::StoreLittleEndian(p, uint16_t{0});
+
+    // The unused remainder of a synced partial page is left as erased.
+    std::fill(m_WriteBuffer.begin() + length, m_WriteBuffer.end(),
+              static_cast<char>(m_pBlockDevice->get_erase_value()));
+
+    uint32_t crc = 0;
+    mbed::MbedCRC<POLY_16BIT_CCITT, 16> ct;
+    ct.compute(m_WriteBuffer.data(), length, &crc);
+    Utilities::StoreLittleEndian(p, static_cast<uint16_t>(crc));
+
+    m_BufferedCount = 0;
+
+    bool result = EraseAhead()
+        && (m_pBlockDevice->program(m_WriteBuffer.data(), PageAddress(m_WritePage), JOURNAL_PAGE_SIZE) == 0);
+
+    if (!result)
+    {
+        // Those readings are lost; the next page is tried afresh.
+        printf("[%s]: Error! Journal page [%lu] could not be programmed.\n",
+            __PRETTY_FUNCTION__, m_WritePage);
+        m_DiscardedPageCount++;
+    }
+    else
+    {
+        m_ProgrammedPageCount++;
+
+        // Nothing pending; replay resumes here, past any page that failed.
+        if (m_UnreplayedPageCount == 0)
+        {
+            m_ReplayPage = m_WritePage;
+        }
+    }
+
+    m_WritePage = NextPage(m_WritePage);
+
+    // Only a programmed page is to be replayed. Any failed ones before it
+    // are walked over on the way, their pages rejected by ReadPage().
+    if (result)
+    {
+        m_UnreplayedPageCount = PagesFromReplayToWrite();
+    }
+    return result;
+}
+
+bool NuerteyFlashJournal::ReadPage(const uint32_t & page, JournalPageHeader_t & header)
+{
+    if (m_pBlockDevice->read(m_ReadBuffer.data(), PageAddress(page), JOURNAL_PAGE_SIZE) != 0)
+    {
+        return false;
+    }
+
+    const char * p = m_ReadBuffer.data();
+
+    if (Utilities::LoadLittleEndian<uint32_t>(p) != JOURNAL_PAGE_MAGIC)
+    {
+        return false;
+    }
+
+    header.sequenceNumber = Utilities::LoadLittleEndian<uint32_t>(p + 4);
+    header.timestamp      = Utilities::LoadLittleEndian<uint32_t>(p + 8);
+    header.samplePeriod   = Utilities::LoadLittleEndian<uint32_t>(p + 12);
+    header.count          = Utilities::LoadLittleEndian<uint16_t>(p + 16);
+
+    const uint16_t expected = Utilities::LoadLittleEndian<uint16_t>(p + 18);
+
+    if ((header.count == 0) || (header.count > JOURNAL_READINGS_PER_PAGE))
+    {
+        return false;
+    }
+
+    // The CRC was computed with its own field zeroed.
+    const std::size_t length = JOURNAL_PAGE_HEADER_SIZE + (header.count * sizeof(int16_t));
+    Utilities::StoreLittleEndian(&m_ReadBuffer[18], uint16_t{0});
+
+    uint32_t crc = 0;
+    mbed::MbedCRC<POLY_16BIT_CCITT, 16> ct;
+    ct.compute(m_ReadBuffer.data(), length, &crc);
+
+    return (static_cast<uint16_t>(crc) == expected);
+}
+
+bool NuerteyFlashJournal::EraseAhead()
+{
+    if (m_WritePage % m_PagesPerEraseBlock)
+    {
+        return true;
+    }
+
+    // Unreplayed pages in the block about to be erased are the oldest
+    // ones; they are lost, and replay resumes past that block.
+    // Failed pages at the tail are not counted, hence the distance.
+    const uint32_t room   = m_PageCount - m_PagesPerEraseBlock;
+    const uint32_t behind = (m_UnreplayedPageCount > 0) ? PagesFromReplayToWrite() : 0;
+
+    if (behind > room)
+    {
+        const uint32_t overlap = behind - room;
+        const uint32_t lost    = std::min(overlap, m_UnreplayedPageCount);
+
+        m_DiscardedPageCount += lost;
+        m_UnreplayedPageCount -= lost;
+        m_ReplayPage = (m_ReplayPage + overlap) % m_PageCount;
+    }
+
+    return (m_pBlockDevice->erase(PageAddress(m_WritePage),
+                                  static_cast<bd_size_t>(m_PagesPerEraseBlock) * JOURNAL_PAGE_SIZE) == 0);
+}
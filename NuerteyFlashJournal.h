@@ -0,0 +1,181 @@
+/***********************************************************************
+* @file      NuerteyFlashJournal.h
+*
+*    Append-only, wear-levelled journal of raw LDE Series sample records,
+*    for store-and-forward across multi-hour network outages and reboots.
+*
+*    The journal occupies the whole of a BlockDevice, e.g. a
+*    SlicingBlockDevice region of an SDBlockDevice or FlashIAPBlockDevice,
+*    and is written strictly sequentially, as a ring of fixed-size pages.
+*    Each erase block is hence erased but once per lap of the ring. Every
+*    reading is numbered, and every page is self-describing:
+*
+*    Offset  Size  Field
+*    0       4     Magic, 'LDEJ'
+*    4       4     Sequence number of the first reading
+*    8       4     Timestamp of the first reading, ms since boot
+*    12      4     Sample period, us
+*    16      2     Number of readings, N
+*    18      2     CRC-16/CCITT of the header (this field zeroed) and readings
+*    20      2N    Raw counts, int16 two's complement
+*
+*    All fields are little-endian.
+*
+*    The last acknowledged sequence number is persisted to KVStore, via
+*    the global kv_set() API, so that replay can resume from there, both
+*    after an outage and after a reboot.
+*
+* @brief
+*
+* @note    Readings are batched in RAM into a whole page before the page is
+*          programmed, hence a bus transaction per JOURNAL_PAGE_SIZE bytes
+*          rather than per reading. Appending is done from the consumer
+*          context (the EventQueue), never from the sampling ISR, which but
+*          pushes into its lock-free ring buffer; that buffer absorbs the
+*          latency of the occasional erase.
+*
+*          Delivery is at-least-once. The acknowledgement is persisted at
+*          most every ACKNOWLEDGEMENT_PERSISTENCE_PERIOD, so some readings
+*          may be replayed after a reboot. The sequence numbers let the
+*          receiver discard duplicates.
+*
+* @warning Erasing internal flash stalls instruction fetches from the same
+*          bank. On a FlashIAPBlockDevice, place the journal in the other
+*          bank (dual bank mode), or prefer an SD card.
+*
+*          Timestamps are ms since the boot they were recorded in.
+*
+*          Should the ring lap readings not yet acknowledged, the oldest
+*          erase block of them is discarded, and counted.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <span>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "BlockDevice.h"
+#include "NuerteyConnectionManager.h"
+#include "mbed.h"
+
+constexpr std::size_t JOURNAL_PAGE_SIZE        = 512;
+constexpr std::size_t JOURNAL_PAGE_HEADER_SIZE = 20;
+constexpr std::size_t JOURNAL_READINGS_PER_PAGE
+    = (JOURNAL_PAGE_SIZE - JOURNAL_PAGE_HEADER_SIZE) / sizeof(int16_t);
+
+constexpr uint32_t    JOURNAL_PAGE_MAGIC       = 0x4A45444C; // 'LDEJ'
+
+struct JournalPageHeader_t
+{
+    uint32_t sequenceNumber; // Of the first reading of the page.
+    uint32_t timestamp;      // ms since boot, of the first reading.
+    uint32_t samplePeriod;   // us between successive readings.
+    uint16_t count;
+};
+
+class NuerteyFlashJournal
+{
+public:
+    static constexpr const char * DEFAULT_ACKNOWLEDGEMENT_KEY = "/kv/lde_journal_ack";
+    static constexpr std::chrono::milliseconds ACKNOWLEDGEMENT_PERSISTENCE_PERIOD{5000};
+
+    explicit NuerteyFlashJournal(BlockDevice * pBlockDevice,
+                                 const char * pAcknowledgementKey = DEFAULT_ACKNOWLEDGEMENT_KEY);
+
+    NuerteyFlashJournal(const NuerteyFlashJournal&) = delete;
+    NuerteyFlashJournal& operator=(const NuerteyFlashJournal&) = delete;
+
+    virtual ~NuerteyFlashJournal();
+
+    // Scans the device for the newest page, and for the first page not
+    // yet acknowledged, whence replay will begin.
+    bool Mount();
+    void Unmount();
+
+    bool IsMounted() const { return m_Mounted; }
+
+    // The readings are contiguous with those previously appended, and
+    // timestamp and samplePeriod only matter if they begin a new page.
+    bool Append(const uint32_t & timestamp,
+                const uint32_t & samplePeriod,
+                std::span<const int16_t> readings);
+
+    // Programs the partially filled page, if any, so that it too may be
+    // replayed. Its unused remainder is skipped.
+    bool Sync();
+
+    // Reads the next page not yet replayed, skipping any of its readings
+    // already acknowledged. Returns the number of readings, zero should
+    // there be nothing programmed left to replay. The span must have room
+    // for JOURNAL_READINGS_PER_PAGE readings.
+    std::size_t Replay(JournalPageHeader_t & header,
+                       std::span<int16_t> readings);
+
+    // Readings up to and including sequenceNumber have been delivered.
+    void Acknowledge(const uint32_t & sequenceNumber);
+    bool PersistAcknowledgement();
+
+    // A NuerteyConnectionManager::LinkObserver_t. With the session down,
+    // no further acknowledgement is coming to coalesce with, hence the
+    // one still pending is persisted there and then.
+    void OnLinkStateChanged(ConnectionState_t state);
+
+    // Replay has caught up with everything programmed and buffered.
+    bool IsCaughtUp() const { return ((m_UnreplayedPageCount == 0) && (m_BufferedCount == 0)); }
+    bool HasProgrammedPagesToReplay() const { return (m_UnreplayedPageCount > 0); }
+
+    uint32_t GetNextSequenceNumber() const { return m_NextSequenceNumber; }
+    uint32_t GetAcknowledgedSequenceNumber() const { return m_AcknowledgedSequenceNumber; }
+    uint32_t GetPageCount() const { return m_PageCount; }
+    uint32_t GetProgrammedPageCount() const { return m_ProgrammedPageCount; }
+    uint32_t GetDiscardedPageCount() const { return m_DiscardedPageCount; }
+
+protected:
+    bool ProgramPage();
+    bool ReadPage(const uint32_t & page, JournalPageHeader_t & header);
+    bool EraseAhead();
+
+    bd_addr_t PageAddress(const uint32_t & page) const { return (static_cast<bd_addr_t>(page) * JOURNAL_PAGE_SIZE); }
+    uint32_t  NextPage(const uint32_t & page) const { return ((page + 1) % m_PageCount); }
+
+    // From the replay page up to the write page; coinciding, they mean the
+    // ring is full.
+    uint32_t  PagesFromReplayToWrite() const
+    {
+        const uint32_t pages = (m_WritePage + m_PageCount - m_ReplayPage) % m_PageCount;
+        return (pages ? pages : m_PageCount);
+    }
+
+    // Serial number arithmetic, as the sequence numbers wrap around.
+    static bool SequenceAfter(const uint32_t & a, const uint32_t & b)
+    {
+        return (static_cast<int32_t>(a - b) > 0);
+    }
+
+private:
+    BlockDevice *                           m_pBlockDevice;
+    const char *                            m_pAcknowledgementKey;
+    std::array<char, JOURNAL_PAGE_SIZE>     m_WriteBuffer;
+    std::array<char, JOURNAL_PAGE_SIZE>     m_ReadBuffer;
+    bool                                    m_Mounted;
+    uint32_t                                m_PageCount;
+    uint32_t                                m_PagesPerEraseBlock;
+    uint32_t                                m_WritePage;
+    uint32_t                                m_ReplayPage;
+    uint32_t                                m_UnreplayedPageCount; // From m_ReplayPage on.
+    uint16_t                                m_BufferedCount;
+    JournalPageHeader_t                     m_BufferedHeader;
+    uint32_t                                m_NextSequenceNumber;
+    uint32_t                                m_AcknowledgedSequenceNumber;
+    bool                                    m_HasAcknowledgement;
+    bool                                    m_AcknowledgementDirty;
+    Kernel::Clock::time_point               m_AcknowledgementPersistedAt;
+    uint32_t                                m_ProgrammedPageCount;
+    uint32_t                                m_DiscardedPageCount;
+};
@@ -0,0 +1,230 @@
+#include "NuerteyHealthMonitor.h"
+
+NuerteyHealthMonitor::NuerteyHealthMonitor(const char * pTopic, std::pmr::memory_resource * pResource)
+    : m_pTopic(pTopic)
+    , m_CounterSource(nullptr)
+    , m_Emitter(nullptr)
+    , m_pEventQueue(nullptr)
+    , m_EventIdentifier(0)
+    , m_pResource(pResource)
+    , m_pRecord(nullptr)
+    , m_RecordLength(0)
+#if MBED_STACK_STATS_ENABLED
+    , m_ThreadIdentifiers{}
+    , m_Threads{}
+    , m_ThreadCount(0)
+#endif
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
+    , m_Sockets{}
+#endif
+    , m_PreviousCounters{}
+    , m_PreviousReport(Kernel::Clock::now())
+#if MBED_CPU_STATS_ENABLED
+    , m_PreviousCPUStatistics{}
+#endif
+    , m_RecordCount(0)
+    , m_EmitFailureCount(0)
+{
+}
+
+NuerteyHealthMonitor::~NuerteyHealthMonitor()
+{
+    Stop();
+
+    if (m_pRecord)
+    {
+        m_pResource->deallocate(m_pRecord, HEALTH_RECORD_CAPACITY, alignof(char));
+    }
+}
+
+bool NuerteyHealthMonitor::Start(const std::chrono::milliseconds& period, EventQueue* pQueue)
+{
+    if (m_EventIdentifier || !pQueue)
+    {
+        return false;
+    }
+
+    // The first record's differences are over its own period, not since boot.
+    if (m_CounterSource)
+    {
+        m_CounterSource(m_PreviousCounters);
+    }
+    m_PreviousReport = Kernel::Clock::now();
+#if MBED_CPU_STATS_ENABLED
+    mbed_stats_cpu_get(&m_PreviousCPUStatistics);
+#endif
+
+    m_pEventQueue = pQueue;
+    m_EventIdentifier = m_pEventQueue->call_every(period, this, &NuerteyHealthMonitor::OnSchedule);
+
+    return (m_EventIdentifier != 0);
+}
+
+void NuerteyHealthMonitor::Stop()
+{
+    if (m_EventIdentifier)
+    {
+        m_pEventQueue->cancel(m_EventIdentifier);
+        m_EventIdentifier = 0;
+    }
+}
+
+void NuerteyHealthMonitor::OnSchedule()
+{
+    Report();
+}
+
+bool NuerteyHealthMonitor::Report()
+{
+    HealthRecord_t record{};
+
+    SampleSystem(record);
+    SampleCounters(record, Kernel::Clock::now());
+
+    // A block per record; the last one is released only once this one
+    // is composed, GetRecord() having handed it out until now.
+    auto pRecord = static_cast<char *>(m_pResource->allocate(HEALTH_RECORD_CAPACITY, alignof(char)));
+
+    JSONStreamWriter writer(std::span<char>(pRecord, HEALTH_RECORD_CAPACITY));
+
+    writer.BeginObject();
+    WriteJSONMembers(writer, HEALTH_RECORD_SCHEMA, record);
+    WriteThreadStacks(writer);
+    writer.EndObject();
+
+    if (m_pRecord)
+    {
+        m_pResource->deallocate(m_pRecord, HEALTH_RECORD_CAPACITY, alignof(char));
+    }
+    m_pRecord      = pRecord;
+    m_RecordLength = writer.Size();
+    m_RecordCount++;
+
+    if (!writer.Good())
+    {
+        printf("[%s]: Error! Health record truncated.\n", __PRETTY_FUNCTION__);
+        m_EmitFailureCount++;
+        return false;
+    }
+
+    if (!m_Emitter || !m_Emitter(m_pTopic, GetRecord()))
+    {
+        // Dropped; the next period's record supersedes it anyway.
+        m_EmitFailureCount++;
+        return false;
+    }
+
+    return true;
+}
+
+void NuerteyHealthMonitor::SampleSystem(HealthRecord_t& record)
+{
+    record.cpuIdle = std::numeric_limits<float>::quiet_NaN();
+
+#if MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t heapStatistics{};
+    mbed_stats_heap_get(&heapStatistics);
+
+    record.heapInUse    = heapStatistics.current_size;
+    record.heapMaximum  = heapStatistics.max_size;
+    record.heapFailures = heapStatistics.alloc_fail_cnt;
+#endif
+
+#if MBED_CPU_STATS_ENABLED
+    mbed_stats_cpu_t cpuStatistics{};
+    mbed_stats_cpu_get(&cpuStatistics);
+
+    const uint64_t uptime = cpuStatistics.uptime - m_PreviousCPUStatistics.uptime;
+
+    if (uptime > 0)
+    {
+        record.cpuIdle = (100.0f * (cpuStatistics.idle_time - m_PreviousCPUStatistics.idle_time)) / uptime;
+    }
+    m_PreviousCPUStatistics = cpuStatistics;
+#endif
+
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
+    const std::size_t sockets = SocketStats::mbed_stats_socket_get_each(m_Sockets.data(), m_Sockets.size());
+
+    // Closed sockets are kept, with their byte counts, until recycled.
+    for (std::size_t i = 0; i < sockets; ++i)
+    {
+        if (m_Sockets[i].state != SOCK_CLOSED)
+        {
+            record.socketsOpen++;
+        }
+        record.sentBytes     += m_Sockets[i].sent_bytes;
+        record.receivedBytes += m_Sockets[i].recv_bytes;
+    }
+#endif
+
+#if MBED_STACK_STATS_ENABLED
+    // With the kernel locked, so that no thread exits, or starts, midway.
+    osKernelLock();
+    m_ThreadCount = osThreadEnumerate(m_ThreadIdentifiers.data(), m_ThreadIdentifiers.size());
+
+    for (std::size_t i = 0; i < m_ThreadCount; ++i)
+    {
+        const char * name = osThreadGetName(m_ThreadIdentifiers[i]);
+        auto& thread = m_Threads[i];
+
+        // Stack space being the watermark's distance from the stack's end.
+        thread.size = osThreadGetStackSize(m_ThreadIdentifiers[i]);
+        thread.used = thread.size - osThreadGetStackSpace(m_ThreadIdentifiers[i]);
+        thread.name.fill('\0');
+        std::strncpy(thread.name.data(), name ? name : "", MAXIMUM_THREAD_NAME_LENGTH);
+    }
+    osKernelUnlock();
+#endif
+
+    record.uptime = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        Kernel::Clock::now().time_since_epoch()).count());
+}
+
+void NuerteyHealthMonitor::SampleCounters(HealthRecord_t& record, const Kernel::Clock::time_point& now)
+{
+    if (!m_CounterSource)
+    {
+        return;
+    }
+
+    HealthCounters_t counters{};
+    m_CounterSource(counters);
+
+    // Unsigned, hence correct across the counters' wraparound too.
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_PreviousReport).count();
+
+    if (elapsed > 0)
+    {
+        record.sampleRate = (1000.0f * (counters.samples - m_PreviousCounters.samples)) / elapsed;
+    }
+
+    record.droppedSamples        = counters.droppedSamples - m_PreviousCounters.droppedSamples;
+    record.queueDepth            = counters.queueDepth;
+    record.publishLatency        = counters.publishLatency;
+    record.maximumPublishLatency = counters.maximumPublishLatency;
+    record.publishFailures       = counters.publishFailures - m_PreviousCounters.publishFailures;
+
+    m_PreviousCounters = counters;
+    m_PreviousReport   = now;
+}
+
+// As "stk":[["main",used,size],...], in order of enumeration.
+void NuerteyHealthMonitor::WriteThreadStacks(JSONStreamWriter& writer)
+{
+#if MBED_STACK_STATS_ENABLED
+    writer.Key("stk").BeginArray();
+
+    for (std::size_t i = 0; i < m_ThreadCount; ++i)
+    {
+        writer.BeginArray()
+              .Value(std::string_view(m_Threads[i].name.data()))
+              .Value(m_Threads[i].used)
+              .Value(m_Threads[i].size)
+              .EndArray();
+    }
+    writer.EndArray();
+#else
+    (void)writer;
+#endif
+}
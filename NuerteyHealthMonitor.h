@@ -0,0 +1,199 @@
+/***********************************************************************
+* @file      NuerteyHealthMonitor.h
+*
+*    Periodic runtime health telemetry, as one compact JSON record per
+*    period, rather than the prettified, once-at-boot system statistics
+*    of ComposeSystemStatistics(). Each record carries:
+*
+*    - the heap in use, its high-water mark and its failed allocations;
+*    - every thread's stack high-water mark, of its size, by name;
+*    - the CPU idle %, over the period;
+*    - the sockets open, and the bytes sent and received by them all;
+*    - the application's counters, as supplied on each period: samples/s,
+*      dropped samples, queue depth and publish latency.
+*
+*    The record is composed into a block of g_MessagePool and handed to
+*    the emitter, typically NuerteyTelemetryPublisher::PublishRecord():
+*
+*    g_HealthMonitor.SetCounterSource([](HealthCounters_t& counters) { ... });
+*    g_HealthMonitor.SetEmitter(mbed::callback(&publisher, &decltype(publisher)::PublishRecord));
+*    g_HealthMonitor.Start();
+*
+* @brief
+*
+* @note    Nothing is allocated off the heap, neither by the monitor,
+*          whose records come off the pool, nor, since the threads are
+*          enumerated directly rather than through
+*          mbed_stats_stack_get_each(), which mallocs its scratch array
+*          on every call, by what it queries. The thread and socket
+*          statistics are gathered into fixed arrays in the monitor.
+*
+*          Each statistic is compiled in only if it is enabled in
+*          mbed_app.json; MBED_STACK_STATS_ENABLED, for the stack
+*          high-water marks, has every thread's stack watermarked at
+*          creation.
+*
+* @warning The stack high-water marks are those of the deepest call so
+*          far, not of the deepest possible; soak the application before
+*          trusting their headroom.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <limits>
+#include "JSONStreamWriter.h"
+#include "SocketStats.h"
+
+using namespace Utilities;
+
+static const uint32_t HEALTH_TELEMETRY_PERIOD_MSECS = 60000;
+
+// Mbed OS' own threads, main, idle, timer and the network stack's, and
+// the application's, with room to spare.
+constexpr std::size_t MAXIMUM_MONITORED_THREADS = 12;
+
+#ifdef MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT
+constexpr std::size_t MAXIMUM_MONITORED_SOCKETS = MBED_CONF_NSAPI_SOCKET_STATS_MAX_COUNT;
+#else
+constexpr std::size_t MAXIMUM_MONITORED_SOCKETS = 10;
+#endif
+
+// Longer names are truncated in the record.
+constexpr std::size_t MAXIMUM_THREAD_NAME_LENGTH = 15;
+
+// Every thread, numbers in full.
+constexpr std::size_t HEALTH_RECORD_CAPACITY = 1024;
+
+static_assert(HEALTH_RECORD_CAPACITY <= MESSAGE_BLOCK_SIZE);
+
+// As maintained by the application; the counts are cumulative, since
+// boot, and the monitor takes their differences over each period.
+struct HealthCounters_t
+{
+    uint32_t samples;
+    uint32_t droppedSamples;           // Overruns included.
+    uint32_t queueDepth;               // Readings yet to consume.
+    uint32_t publishLatency;           // us; of the latest publish.
+    uint32_t maximumPublishLatency;    // us.
+    uint32_t publishFailures;
+};
+
+struct HealthRecord_t
+{
+    uint32_t uptime;                   // s.
+    uint32_t heapInUse;                // Bytes.
+    uint32_t heapMaximum;              // Bytes.
+    uint32_t heapFailures;
+    float    cpuIdle;                  // %; NaN, i.e. null, if not enabled.
+    uint32_t socketsOpen;
+    uint32_t sentBytes;
+    uint32_t receivedBytes;
+    float    sampleRate;               // Samples/s.
+    uint32_t droppedSamples;           // Over the period.
+    uint32_t queueDepth;
+    uint32_t publishLatency;           // us.
+    uint32_t maximumPublishLatency;    // us.
+    uint32_t publishFailures;          // Over the period.
+};
+
+// Short keys; the record is for machines, and goes out every period.
+inline constexpr auto HEALTH_RECORD_SCHEMA = std::make_tuple(
+    JSONField_t<HealthRecord_t, uint32_t>{"up",       &HealthRecord_t::uptime},
+    JSONField_t<HealthRecord_t, uint32_t>{"heap",     &HealthRecord_t::heapInUse},
+    JSONField_t<HealthRecord_t, uint32_t>{"heapMax",  &HealthRecord_t::heapMaximum},
+    JSONField_t<HealthRecord_t, uint32_t>{"heapFail", &HealthRecord_t::heapFailures},
+    JSONField_t<HealthRecord_t, float>{"idle",        &HealthRecord_t::cpuIdle},
+    JSONField_t<HealthRecord_t, uint32_t>{"socks",    &HealthRecord_t::socketsOpen},
+    JSONField_t<HealthRecord_t, uint32_t>{"tx",       &HealthRecord_t::sentBytes},
+    JSONField_t<HealthRecord_t, uint32_t>{"rx",       &HealthRecord_t::receivedBytes},
+    JSONField_t<HealthRecord_t, float>{"sps",         &HealthRecord_t::sampleRate},
+    JSONField_t<HealthRecord_t, uint32_t>{"drop",     &HealthRecord_t::droppedSamples},
+    JSONField_t<HealthRecord_t, uint32_t>{"depth",    &HealthRecord_t::queueDepth},
+    JSONField_t<HealthRecord_t, uint32_t>{"pubUs",    &HealthRecord_t::publishLatency},
+    JSONField_t<HealthRecord_t, uint32_t>{"pubMaxUs", &HealthRecord_t::maximumPublishLatency},
+    JSONField_t<HealthRecord_t, uint32_t>{"pubFail",  &HealthRecord_t::publishFailures});
+
+static_assert(IsPlainJSONSchema(HEALTH_RECORD_SCHEMA));
+
+class NuerteyHealthMonitor
+{
+public:
+    using CounterSource_t = mbed::Callback<void(HealthCounters_t&)>;
+    using Emitter_t       = mbed::Callback<bool(const char*, std::string_view)>;
+
+    static constexpr const char * DEFAULT_HEALTH_TOPIC = "lde/health";
+
+    explicit NuerteyHealthMonitor(const char * pTopic = DEFAULT_HEALTH_TOPIC,
+                                  std::pmr::memory_resource * pResource = &g_MessagePool);
+
+    NuerteyHealthMonitor(const NuerteyHealthMonitor&) = delete;
+    NuerteyHealthMonitor& operator=(const NuerteyHealthMonitor&) = delete;
+
+    virtual ~NuerteyHealthMonitor();
+
+    void SetCounterSource(const CounterSource_t& source) { m_CounterSource = source; }
+    void SetEmitter(const Emitter_t& emitter) { m_Emitter = emitter; }
+
+    bool Start(const std::chrono::milliseconds& period
+                   = std::chrono::milliseconds(HEALTH_TELEMETRY_PERIOD_MSECS),
+               EventQueue* pQueue = &gs_MasterEventQueue);
+    void Stop();
+
+    // Composes, and emits, a record now; as Start() does every period.
+    bool Report();
+
+    // The record last composed, emitted or not; NUL-terminated. Valid
+    // until the next is composed.
+    std::string_view GetRecord() const
+    {
+        return (m_pRecord ? std::string_view(m_pRecord, m_RecordLength) : std::string_view());
+    }
+
+    uint32_t GetRecordCount() const { return m_RecordCount; }
+    uint32_t GetEmitFailureCount() const { return m_EmitFailureCount; }
+
+protected:
+    void OnSchedule();
+    void SampleSystem(HealthRecord_t& record);
+    void SampleCounters(HealthRecord_t& record, const Kernel::Clock::time_point& now);
+    void WriteThreadStacks(JSONStreamWriter& writer);
+
+private:
+    // The name copied, for the thread may have exited by the time the
+    // record is written.
+    struct ThreadStack_t
+    {
+        std::array<char, MAXIMUM_THREAD_NAME_LENGTH + 1>  name;
+        uint32_t                                          used;   // Bytes, at most.
+        uint32_t                                          size;   // Bytes.
+    };
+
+    const char *                                    m_pTopic;
+    CounterSource_t                                 m_CounterSource;
+    Emitter_t                                       m_Emitter;
+    EventQueue*                                     m_pEventQueue;
+    int                                             m_EventIdentifier;
+    std::pmr::memory_resource *                     m_pResource;
+    char *                                          m_pRecord;         // HEALTH_RECORD_CAPACITY, off m_pResource.
+    std::size_t                                     m_RecordLength;
+#if MBED_STACK_STATS_ENABLED
+    std::array<osThreadId_t, MAXIMUM_MONITORED_THREADS>     m_ThreadIdentifiers;
+    std::array<ThreadStack_t, MAXIMUM_MONITORED_THREADS>    m_Threads;
+    std::size_t                                     m_ThreadCount;
+#endif
+#if MBED_CONF_NSAPI_SOCKET_STATS_ENABLED
+    std::array<mbed_stats_socket_t, MAXIMUM_MONITORED_SOCKETS> m_Sockets;
+#endif
+    HealthCounters_t                                m_PreviousCounters;
+    Kernel::Clock::time_point                       m_PreviousReport;
+#if MBED_CPU_STATS_ENABLED
+    mbed_stats_cpu_t                                m_PreviousCPUStatistics;
+#endif
+    uint32_t                                        m_RecordCount;
+    uint32_t                                        m_EmitFailureCount;
+};
@@ -0,0 +1,304 @@
+#include "NuerteyJWTTokenCache.h"
+#include "Utilities.h"
+#include "JSONStreamWriter.h"
+#include "base.h"
+
+#undef  TRACE_GROUP
+#define TRACE_GROUP "jwt-token-cache"
+
+NuerteyJWTTokenCache::NuerteyJWTTokenCache(const std::string_view & algorithm,
+                                           const std::string_view & audience,
+                                           events::EventQueue * pEventQueue,
+                                           const std::chrono::seconds & lifetime,
+                                           const std::chrono::seconds & refreshMargin)
+    : m_Algorithm(algorithm)
+    , m_Audience(audience)
+    , m_pEventQueue(pEventQueue)
+    , m_Lifetime(lifetime)
+    , m_RefreshMargin(std::min(refreshMargin, lifetime / 2))
+    , m_pMessageDigestInfo(nullptr)
+    , m_Initialized(false)
+    , m_EncodedHeader{}
+    , m_EncodedHeaderLength(0)
+    , m_Tokens{}
+    , m_TokenLength(0)
+    , m_CurrentToken(0)
+    , m_ExpiresAt(0)
+    , m_RefreshEventIdentifier(0)
+    , m_SignatureCount(0)
+{
+    mbedtls_pk_init(&m_PrivateKey);
+    mbedtls_entropy_init(&m_Entropy);
+    mbedtls_ctr_drbg_init(&m_CtrDrbg);
+}
+
+NuerteyJWTTokenCache::~NuerteyJWTTokenCache()
+{
+    StopBackgroundRefresh();
+
+    mbedtls_ctr_drbg_free(&m_CtrDrbg);
+    mbedtls_entropy_free(&m_Entropy);
+    mbedtls_pk_free(&m_PrivateKey);
+}
+
+bool NuerteyJWTTokenCache::Initialize(const char * pPrivateKey, const char * pPassword, std::error_code & ec)
+{
+    if (m_Initialized)
+    {
+        return true;
+    }
+
+    // "RS256", "PS384", "ES512" etc.
+    const auto family = m_Algorithm.substr(0, 2);
+    const auto bits   = m_Algorithm.substr(2);
+
+    mbedtls_md_type_t mdAlgorithm = (bits == "256") ? MBEDTLS_MD_SHA256
+                                  : (bits == "384") ? MBEDTLS_MD_SHA384
+                                  : (bits == "512") ? MBEDTLS_MD_SHA512 : MBEDTLS_MD_NONE;
+
+    m_pMessageDigestInfo = mbedtls_md_info_from_type(mdAlgorithm);
+
+    if (!pPrivateKey || !m_pMessageDigestInfo
+        || ((family != "RS") && (family != "PS") && (family != "ES")))
+    {
+        tr_error("Unsupported JWT algorithm, or no private key.");
+        ec = make_error_code(ErrorStatus_t::INVALID_INPUT_RUNTIME_ERROR);
+        return false;
+    }
+
+    int rc = mbedtls_pk_parse_key(&m_PrivateKey,
+                                  (const unsigned char *)pPrivateKey, strlen(pPrivateKey) + 1,
+                                  (const unsigned char *)pPassword, pPassword ? strlen(pPassword) : 0);
+
+    if (rc != 0)
+    {
+        tr_warn("Failed to parse private key (-0x%04x)", -rc);
+        ec = make_error_code(ErrorStatus_t::PARSE_KEY_ERROR);
+        return false;
+    }
+
+    const mbedtls_pk_type_t keyType = mbedtls_pk_get_type(&m_PrivateKey);
+
+    if (((family == "ES") && (keyType != MBEDTLS_PK_ECKEY) && (keyType != MBEDTLS_PK_ECDSA))
+        || ((family != "ES") && (keyType != MBEDTLS_PK_RSA)))
+    {
+        tr_error("Incorrect key type detected. Key Type = [%d]", ToIntegral(keyType));
+        ec = make_error_code(ErrorStatus_t::INCORRECT_KEY_TYPE_ERROR);
+        return false;
+    }
+
+    if (family == "PS")
+    {
+        mbedtls_rsa_set_padding(mbedtls_pk_rsa(m_PrivateKey), MBEDTLS_RSA_PKCS_V21, mdAlgorithm);
+    }
+
+    // Seeded the once; then merely drawn from for every signature.
+    const char *pers = "NuerteyJWTTokenCache";
+    rc = mbedtls_ctr_drbg_seed(&m_CtrDrbg, mbedtls_entropy_func, &m_Entropy,
+                               (const unsigned char *)pers, strlen(pers));
+
+    if (rc != 0)
+    {
+        tr_err("Failed in mbed_tls_ctr_drbg_seed().");
+        ec = make_error_code(ErrorStatus_t::ENTROPY_SOURCE_FAILED);
+        return false;
+    }
+
+    // The header never changes.
+    std::array<char, 48> header{};
+    Utilities::JSONStreamWriter writer(header);
+    writer.BeginObject()
+          .Member("alg", m_Algorithm)
+          .Member("typ", "JWT")
+          .EndObject();
+
+    m_EncodedHeaderLength = Base64URLEncode(m_EncodedHeader,
+        std::span<const unsigned char>((const unsigned char *)writer.View().data(), writer.Size()));
+
+    if (!writer.Good() || (m_EncodedHeaderLength == 0))
+    {
+        ec = make_error_code(ErrorStatus_t::BUFFER_SIZE_INSUFFICIENT_ERROR);
+        return false;
+    }
+
+    m_Initialized = true;
+    return true;
+}
+
+std::string_view NuerteyJWTTokenCache::GetToken(std::error_code & ec)
+{
+    if (((m_ExpiresAt - time(NULL)) <= (m_RefreshMargin.count() / 2)) && !Refresh(ec))
+    {
+        return std::string_view();
+    }
+
+    return std::string_view(m_Tokens[m_CurrentToken].data(), m_TokenLength);
+}
+
+bool NuerteyJWTTokenCache::Refresh(std::error_code & ec)
+{
+    if (!m_Initialized)
+    {
+        ec = make_error_code(ErrorStatus_t::INVALID_TOKEN_ARGUMENT_ERROR);
+        return false;
+    }
+
+    // Signed into the spare buffer; the current token stays intact, and
+    // in use, should this fail.
+    auto & token = m_Tokens[m_CurrentToken ^ 1];
+
+    const std::time_t issuedAt  = time(NULL);
+    const std::time_t expiresAt = issuedAt + m_Lifetime.count();
+
+    std::array<char, 128> claims{};
+    Utilities::JSONStreamWriter writer(claims);
+    writer.BeginObject()
+          .Member("iat", static_cast<int64_t>(issuedAt))
+          .Member("exp", static_cast<int64_t>(expiresAt))
+          .Member("aud", m_Audience)
+          .EndObject();
+
+    if (!writer.Good())
+    {
+        ec = make_error_code(ErrorStatus_t::BUFFER_SIZE_INSUFFICIENT_ERROR);
+        return false;
+    }
+
+    // header.claims, in place.
+    std::size_t length = m_EncodedHeaderLength;
+    std::copy_n(m_EncodedHeader.begin(), length, token.begin());
+    token[length++] = '.';
+
+    const auto encodedClaims = Base64URLEncode(std::span<char>(token).subspan(length),
+        std::span<const unsigned char>((const unsigned char *)writer.View().data(), writer.Size()));
+
+    if (encodedClaims == 0)
+    {
+        ec = make_error_code(ErrorStatus_t::BUFFER_SIZE_INSUFFICIENT_ERROR);
+        return false;
+    }
+    length += encodedClaims;
+
+    std::array<unsigned char, MBEDTLS_MD_MAX_SIZE> md{};
+    int rc = mbedtls_md(m_pMessageDigestInfo, (const unsigned char *)token.data(), length, md.data());
+
+    if (rc != 0)
+    {
+        tr_error("Failed to calculate hash (-0x%04x)", -rc);
+        ec = make_error_code(ErrorStatus_t::RSA_HASH_CALCULATION_ERROR);
+        return false;
+    }
+
+    std::array<unsigned char, MBEDTLS_MPI_MAX_SIZE> signature{};
+    std::size_t signatureLength = 0;
+
+    rc = mbedtls_pk_sign(&m_PrivateKey, mbedtls_md_get_type(m_pMessageDigestInfo),
+                         md.data(), mbedtls_md_get_size(m_pMessageDigestInfo),
+                         signature.data(), &signatureLength,
+                         mbedtls_ctr_drbg_random, &m_CtrDrbg);
+
+    if (rc != 0)
+    {
+        tr_err("Failed in mbedtls_pk_sign.");
+        ec = make_error_code(ErrorStatus_t::SIGNATURE_GENERATION_ERROR);
+        return false;
+    }
+
+    token[length++] = '.';
+
+    const auto encodedSignature = Base64URLEncode(std::span<char>(token).subspan(length),
+        std::span<const unsigned char>(signature.data(), signatureLength));
+
+    if (encodedSignature == 0)
+    {
+        ec = make_error_code(ErrorStatus_t::BUFFER_SIZE_INSUFFICIENT_ERROR);
+        return false;
+    }
+    length += encodedSignature;
+
+    m_CurrentToken ^= 1;
+    m_TokenLength = length;
+    m_ExpiresAt = expiresAt;
+    m_SignatureCount++;
+
+    // Keep the background refresh in step with the new expiry.
+    if (m_RefreshEventIdentifier)
+    {
+        m_pEventQueue->cancel(m_RefreshEventIdentifier);
+        m_RefreshEventIdentifier = 0;
+        ScheduleRefresh();
+    }
+
+    return true;
+}
+
+bool NuerteyJWTTokenCache::StartBackgroundRefresh()
+{
+    if (!m_Initialized || !m_pEventQueue || m_RefreshEventIdentifier)
+    {
+        return false;
+    }
+
+    // Without a token as yet, the first is signed straightaway.
+    if (m_TokenLength == 0)
+    {
+        m_RefreshEventIdentifier = m_pEventQueue->call(this, &NuerteyJWTTokenCache::OnRefresh);
+    }
+    else
+    {
+        ScheduleRefresh();
+    }
+    return (m_RefreshEventIdentifier != 0);
+}
+
+void NuerteyJWTTokenCache::StopBackgroundRefresh()
+{
+    if (m_RefreshEventIdentifier)
+    {
+        m_pEventQueue->cancel(m_RefreshEventIdentifier);
+        m_RefreshEventIdentifier = 0;
+    }
+}
+
+bool NuerteyJWTTokenCache::IsValid() const
+{
+    return ((m_TokenLength > 0) && (time(NULL) < m_ExpiresAt));
+}
+
+void NuerteyJWTTokenCache::OnRefresh()
+{
+    m_RefreshEventIdentifier = 0;
+
+    std::error_code ec;
+
+    if (!Refresh(ec))
+    {
+        Utilities::g_STDIOMutex.lock();
+        printf("[%s]: Error! Background JWT refresh failed: %s\n",
+            __PRETTY_FUNCTION__, ec.message().c_str());
+        Utilities::g_STDIOMutex.unlock();
+    }
+
+    ScheduleRefresh();
+}
+
+void NuerteyJWTTokenCache::ScheduleRefresh()
+{
+    // The refresh margin ahead of expiry; or, should the last refresh
+    // have failed, a retry shortly.
+    const auto delay = std::max(std::chrono::seconds((m_ExpiresAt - time(NULL)) - m_RefreshMargin.count()),
+                                REFRESH_RETRY_DELAY);
+
+    m_RefreshEventIdentifier = m_pEventQueue->call_in(
+        std::chrono::duration_cast<std::chrono::milliseconds>(delay),
+        this, &NuerteyJWTTokenCache::OnRefresh);
+}
+
+std::size_t NuerteyJWTTokenCache::Base64URLEncode(std::span<char> destination,
+                                                  std::span<const unsigned char> source)
+{
+    std::error_code ec;
+
+    // RFC 7515 base64url; no padding.
+    return jwt::base::encode<jwt::alphabet::base64url>(destination, source, false, ec);
+}
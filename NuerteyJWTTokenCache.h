@@ -0,0 +1,128 @@
+/***********************************************************************
+* @file      NuerteyJWTTokenCache.h
+*
+*    Cached JWT signing, for the password of cloud (IoT-core style) MQTT
+*    broker connections.
+*
+*    jwt::create()...sign(jwt::algorithm::rs256(...)) re-parses the PEM
+*    key, re-seeds a CTR-DRBG from the entropy source and re-encodes the
+*    header each and every time, by way of many std::string copies, before
+*    even getting to the RSA/ECDSA signature itself. Herein, the key is
+*    parsed into its mbedTLS context, the CTR-DRBG seeded and the header
+*    base64url-encoded, all but once, and the token is assembled in place
+*    in a fixed buffer. A still-valid token is simply handed out again,
+*    and a new one is signed on the EventQueue ahead of the expiry of the
+*    current one; reconnects thereby never stall on the crypto.
+*
+*    Usage, given that the RTC has been synchronized:
+*
+*    NuerteyJWTTokenCache tokenCache("RS256", "my-gcp-project", &gs_MasterEventQueue);
+*    std::error_code ec;
+*
+*    if (tokenCache.Initialize(PRIVATE_KEY_PEM, nullptr, ec))
+*    {
+*        tokenCache.StartBackgroundRefresh();
+*        ...
+*        auto token = tokenCache.GetToken(ec); // e.g. the MQTT password.
+*    }
+*
+* @brief
+*
+* @note    Supports RS256/384/512, PS256/384/512 and ES256/384/512. The
+*          signatures are as produced by the jwt::algorithm counterparts,
+*          so that tokens verify alike.
+*
+* @warning All but the constructor and destructor are to be called from
+*          the one EventQueue context. A std::string_view obtained from
+*          GetToken() remains valid until the refresh after next.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <span>
+#include <array>
+#include <ctime>
+#include <chrono>
+#include <string_view>
+#include <system_error>
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/md.h"
+#include "mbedtls/pk.h"
+#include "mbed_events.h"
+
+class NuerteyJWTTokenCache
+{
+public:
+    // Large enough for an RSA-4096 signature.
+    static constexpr std::size_t MAXIMUM_TOKEN_LENGTH = 1024;
+
+    static constexpr std::chrono::seconds DEFAULT_TOKEN_LIFETIME{3600};
+    static constexpr std::chrono::seconds DEFAULT_REFRESH_MARGIN{300};
+    static constexpr std::chrono::seconds REFRESH_RETRY_DELAY{10};
+
+    NuerteyJWTTokenCache(const std::string_view & algorithm,
+                         const std::string_view & audience,
+                         events::EventQueue * pEventQueue,
+                         const std::chrono::seconds & lifetime = DEFAULT_TOKEN_LIFETIME,
+                         const std::chrono::seconds & refreshMargin = DEFAULT_REFRESH_MARGIN);
+
+    NuerteyJWTTokenCache(const NuerteyJWTTokenCache&) = delete;
+    NuerteyJWTTokenCache& operator=(const NuerteyJWTTokenCache&) = delete;
+
+    virtual ~NuerteyJWTTokenCache();
+
+    // The one and only parse of the PEM private key, which, as with
+    // jwt::algorithm, is to be NUL-terminated.
+    bool Initialize(const char * pPrivateKey, const char * pPassword, std::error_code & ec);
+
+    // The cached token, unless less than half the refresh margin remains
+    // of it, in which case a new one is signed there and then. Empty on
+    // failure.
+    std::string_view GetToken(std::error_code & ec);
+
+    // Signs a new token now.
+    bool Refresh(std::error_code & ec);
+
+    // Re-signs the refresh margin ahead of each expiry.
+    bool StartBackgroundRefresh();
+    void StopBackgroundRefresh();
+
+    bool        IsValid() const;
+    std::time_t GetExpiry() const { return m_ExpiresAt; }
+    uint32_t    GetSignatureCount() const { return m_SignatureCount; }
+
+protected:
+    void OnRefresh();
+    void ScheduleRefresh();
+
+    static std::size_t Base64URLEncode(std::span<char> destination,
+                                       std::span<const unsigned char> source);
+
+private:
+    using Token_t = std::array<char, MAXIMUM_TOKEN_LENGTH>;
+
+    std::string_view                   m_Algorithm;
+    std::string_view                   m_Audience;
+    events::EventQueue *               m_pEventQueue;
+    std::chrono::seconds               m_Lifetime;
+    std::chrono::seconds               m_RefreshMargin;
+    mbedtls_pk_context                 m_PrivateKey;
+    mbedtls_entropy_context            m_Entropy;
+    mbedtls_ctr_drbg_context           m_CtrDrbg;
+    const mbedtls_md_info_t *          m_pMessageDigestInfo;
+    bool                               m_Initialized;
+    std::array<char, 64>               m_EncodedHeader;
+    std::size_t                        m_EncodedHeaderLength;
+    std::array<Token_t, 2>             m_Tokens;  // Current, and being signed.
+    std::size_t                        m_TokenLength;
+    std::size_t                        m_CurrentToken;
+    std::time_t                        m_ExpiresAt;
+    int                                m_RefreshEventIdentifier;
+    uint32_t                           m_SignatureCount;
+};
@@ -0,0 +1,182 @@
+#include "NuerteyLDESeriesAutoZero.h"
+#include "kvstore_global_api.h"
+
+NuerteyLDESeriesAutoZero::NuerteyLDESeriesAutoZero(events::EventQueue * pEventQueue,
+                                                   const char * pOffsetKey,
+                                                   const uint16_t & window,
+                                                   const uint32_t & varianceThreshold,
+                                                   const int16_t & captureRange)
+    : m_pEventQueue(pEventQueue)
+    , m_pOffsetKey(pOffsetKey)
+    , m_Window(std::max<uint16_t>(window, 2))
+    , m_VarianceThreshold(varianceThreshold)
+    , m_CaptureRange(captureRange)
+    , m_Statistics()
+    , m_Offset(0)
+    , m_Tracking(true)
+    , m_PersistencePending(false)
+    , m_DeferredEventIdentifier(0)
+    , m_PersistedOffset(0)
+    , m_PersistedAt()
+    , m_HasPersisted(false)
+    , m_QuiescentWindowCount(0)
+    , m_UpdateCount(0)
+{
+}
+
+NuerteyLDESeriesAutoZero::~NuerteyLDESeriesAutoZero()
+{
+    if (m_DeferredEventIdentifier)
+    {
+        m_pEventQueue->cancel(m_DeferredEventIdentifier);
+    }
+}
+
+bool NuerteyLDESeriesAutoZero::Load()
+{
+    int16_t offset = 0;
+    std::size_t length = 0;
+
+    int status = kv_get(m_pOffsetKey, &offset, sizeof(offset), &length);
+
+    if (status == MBED_ERROR_ITEM_NOT_FOUND)
+    {
+        // Never zeroed as yet.
+        m_Offset.store(0);
+        m_PersistedOffset = 0;
+        return true;
+    }
+
+    if ((status != MBED_SUCCESS) || (length != sizeof(offset)) || (std::abs(offset) > MAXIMUM_OFFSET))
+    {
+        printf("[%s]: Error! kv_get() returned: [%d], of length [%u]\n", __PRETTY_FUNCTION__, status, length);
+        return false;
+    }
+
+    m_Offset.store(offset);
+    m_PersistedOffset = offset;
+    m_HasPersisted = true;
+    m_PersistedAt = Kernel::Clock::now();
+
+    return true;
+}
+
+bool NuerteyLDESeriesAutoZero::Persist()
+{
+    const int16_t offset = m_Offset.load();
+
+    m_PersistedAt = Kernel::Clock::now();
+
+    int status = kv_set(m_pOffsetKey, &offset, sizeof(offset), 0);
+
+    if (status != MBED_SUCCESS)
+    {
+        printf("[%s]: Error! kv_set() returned: [%d]\n", __PRETTY_FUNCTION__, status);
+        return false;
+    }
+
+    m_PersistedOffset = offset;
+    m_HasPersisted = true;
+    return true;
+}
+
+bool NuerteyLDESeriesAutoZero::Clear()
+{
+    m_Offset.store(0);
+    return Persist();
+}
+
+void NuerteyLDESeriesAutoZero::SetOffset(const int16_t & offset)
+{
+    m_Offset.store(std::clamp<int16_t>(offset, -MAXIMUM_OFFSET, MAXIMUM_OFFSET));
+    m_Statistics.Reset();
+}
+
+void NuerteyLDESeriesAutoZero::Observe(const int16_t & outputCounts, const float & gain)
+{
+    if (!m_Tracking.load(std::memory_order_relaxed))
+    {
+        m_Statistics.Reset();
+        return;
+    }
+
+    m_Statistics.Add(outputCounts);
+
+    if (m_Statistics.GetCount() < m_Window)
+    {
+        return;
+    }
+
+    // N Σx² - (Σx)² < threshold N², i.e. variance < threshold, without
+    // the division. With N at most 2^16, neither side overflows.
+    const int64_t n   = m_Statistics.GetCount();
+    const int64_t sum = m_Statistics.GetSum();
+    const bool quiescent = ((n * m_Statistics.GetSumOfSquares()) - (sum * sum))
+                         < (static_cast<int64_t>(m_VarianceThreshold) * n * n);
+
+    m_Statistics.Reset();
+
+    if (!quiescent)
+    {
+        return;
+    }
+    m_QuiescentWindowCount++;
+
+    // The capture range is in terms of the output; the offset, of the raw
+    // readings, which the output has the gain applied to.
+    const int64_t mean     = ((sum >= 0) ? (sum + (n / 2)) : (sum - (n / 2))) / n;
+    const int64_t residual = Residual(sum, n, gain);
+
+    if ((residual == 0) || (std::abs(mean) > m_CaptureRange))
+    {
+        return;
+    }
+
+    const int16_t offset = static_cast<int16_t>(std::clamp<int64_t>(
+        m_Offset.load(std::memory_order_relaxed) + residual, -MAXIMUM_OFFSET, MAXIMUM_OFFSET));
+
+    m_Offset.store(offset);
+    m_UpdateCount++;
+
+    if (m_pEventQueue && (std::abs(offset - m_PersistedOffset) >= PERSISTENCE_THRESHOLD)
+        && !m_PersistencePending.exchange(true))
+    {
+        if (!m_pEventQueue->call(this, &NuerteyLDESeriesAutoZero::OnOffsetChanged))
+        {
+            m_PersistencePending.store(false);
+        }
+    }
+}
+
+void NuerteyLDESeriesAutoZero::OnOffsetChanged()
+{
+    m_DeferredEventIdentifier = 0;
+
+    // Already persisted meanwhile, e.g. by Persist() or Clear().
+    if (m_HasPersisted && (std::abs(m_Offset.load() - m_PersistedOffset) < PERSISTENCE_THRESHOLD))
+    {
+        m_PersistencePending.store(false);
+        return;
+    }
+
+    const auto elapsed = Kernel::Clock::now() - m_PersistedAt;
+
+    if (!m_HasPersisted || (elapsed >= PERSISTENCE_PERIOD))
+    {
+        m_PersistencePending.store(false);
+        Persist();
+        return;
+    }
+
+    // Rate-limited, so as to spare the KVStore's own flash. Short of the
+    // period, it is persisted at the period's end rather than left to an
+    // update that, the line being at rest, may never come along.
+    m_DeferredEventIdentifier = m_pEventQueue->call_in(
+        std::chrono::duration_cast<std::chrono::milliseconds>(PERSISTENCE_PERIOD - elapsed),
+        this, &NuerteyLDESeriesAutoZero::OnOffsetChanged);
+
+    if (!m_DeferredEventIdentifier)
+    {
+        m_PersistencePending.store(false);
+    }
+}
@@ -0,0 +1,147 @@
+/***********************************************************************
+* @file      NuerteyLDESeriesAutoZero.h
+*
+*    Host-side zero calibration, i.e. offset tracking, for the LDE Series
+*    pressure readings, so that the zero drift of a long-lived installation
+*    is taken out in the field rather than by reflashing constants.
+*
+*    The readings, as finally output, i.e. zeroed and then temperature
+*    compensated, are watched in windows of N. A window whose variance is
+*    below the threshold is quiescent; if, moreover, its mean lies within
+*    the capture range, the line is taken to be at rest at zero
+*    differential pressure, and that mean, i.e. the offset still left,
+*    is taken back through the compensation gain and added to the offset.
+*    The compensation's own offset is thereby nulled too, and a line at
+*    rest reads zero with both stages enabled.
+*
+*    The offset is in raw counts, and is applied as a saturating integer
+*    subtraction ahead of any conversion; hence at no floating-point cost
+*    per sample. It is persisted to KVStore, via the global kv_set() API,
+*    and restored by Load() on the next boot.
+*
+* @brief
+*
+* @note    Observe() is integer arithmetic throughout, even the variance
+*          test, bar the one division by the gain per window; so may be
+*          called for every reading from the sampler's SPI completion IRQ. Persisting, which writes flash, is deferred
+*          to the EventQueue, and is rate-limited to PERSISTENCE_PERIOD;
+*          an update that falls within the period is persisted at its end.
+*
+* @warning A steady, genuine pressure within the capture range, say with
+*          the ports blocked off, is indistinguishable from an offset.
+*          Disable tracking, with SetTracking(false), whilst the process
+*          is known to hold such a pressure.
+*
+*          Observe() is to be called from the one context only.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "SignalProcessing.h"
+#include "mbed_events.h"
+#include "mbed.h"
+
+class NuerteyLDESeriesAutoZero
+{
+public:
+    static constexpr const char * DEFAULT_OFFSET_KEY = "/kv/lde_zero_offset";
+
+    // At 1 kHz, a second of readings; and a standard deviation of two
+    // counts, i.e. the sensor's noise floor.
+    static constexpr uint16_t DEFAULT_QUIESCENT_WINDOW     = 1000;
+    static constexpr uint32_t DEFAULT_VARIANCE_THRESHOLD   = 4;        // Counts².
+
+    // The datasheet's offset accuracy, 0.2% FS, is 60 counts of the
+    // 30000 of full-scale; a few times that is plenty for drift.
+    static constexpr int16_t  DEFAULT_CAPTURE_RANGE        = 180;      // Counts.
+    static constexpr int16_t  MAXIMUM_OFFSET               = 600;      // Counts.
+
+    static constexpr int16_t  PERSISTENCE_THRESHOLD        = 2;        // Counts.
+    static constexpr std::chrono::milliseconds PERSISTENCE_PERIOD{3600 * 1000};
+
+    NuerteyLDESeriesAutoZero(events::EventQueue * pEventQueue,
+                             const char * pOffsetKey = DEFAULT_OFFSET_KEY,
+                             const uint16_t & window = DEFAULT_QUIESCENT_WINDOW,
+                             const uint32_t & varianceThreshold = DEFAULT_VARIANCE_THRESHOLD,
+                             const int16_t & captureRange = DEFAULT_CAPTURE_RANGE);
+
+    NuerteyLDESeriesAutoZero(const NuerteyLDESeriesAutoZero&) = delete;
+    NuerteyLDESeriesAutoZero& operator=(const NuerteyLDESeriesAutoZero&) = delete;
+
+    virtual ~NuerteyLDESeriesAutoZero();
+
+    // The offset persisted, if any; zero otherwise.
+    bool Load();
+
+    // Now, rather than when next due, e.g. ahead of a shutdown.
+    bool Persist();
+
+    // Back to zero, persisted straightaway; e.g. on replacing the sensor.
+    bool Clear();
+
+    // A manual zero, e.g. with the ports known to be shorted.
+    void SetOffset(const int16_t & offset);
+
+    // Callable from any context.
+    int16_t Apply(const int16_t & counts) const
+    {
+        return Subtract(counts, m_Offset.load(std::memory_order_relaxed));
+    }
+
+    // Of readings already zeroed, by Apply(), and then compensated with
+    // the gain given, if at all.
+    void Observe(const int16_t & outputCounts, const float & gain = 1.0f);
+
+    static constexpr int16_t Subtract(const int16_t & counts, const int16_t & offset)
+    {
+        const int32_t zeroed = static_cast<int32_t>(counts) - offset;
+
+        return static_cast<int16_t>(std::clamp<int32_t>(zeroed, INT16_MIN, INT16_MAX));
+    }
+
+    // The mean of the window, back in the raw counts that Apply() takes
+    // the offset out of; rounded to the nearest count.
+    static constexpr int64_t Residual(const int64_t & sum, const int64_t & n, const float & gain)
+    {
+        const float residual = static_cast<float>(sum) / (static_cast<float>(n) * gain);
+
+        return static_cast<int64_t>(residual + ((residual < 0.0f) ? -0.5f : 0.5f));
+    }
+
+    void SetTracking(const bool & tracking) { m_Tracking.store(tracking); }
+    bool IsTracking() const { return m_Tracking.load(); }
+
+    int16_t  GetOffset() const { return m_Offset.load(); }
+    int16_t  GetPersistedOffset() const { return m_PersistedOffset; }
+    uint32_t GetQuiescentWindowCount() const { return m_QuiescentWindowCount.load(); }
+    uint32_t GetUpdateCount() const { return m_UpdateCount.load(); }
+
+protected:
+    // In the EventQueue context.
+    void OnOffsetChanged();
+
+private:
+    events::EventQueue *                    m_pEventQueue;
+    const char *                            m_pOffsetKey;
+    uint16_t                                m_Window;
+    uint32_t                                m_VarianceThreshold;
+    int16_t                                 m_CaptureRange;
+    Utilities::WindowStatistics             m_Statistics;
+    std::atomic<int16_t>                    m_Offset;
+    std::atomic<bool>                       m_Tracking;
+    std::atomic<bool>                       m_PersistencePending;  // Posted, or deferred, yet to run.
+    int                                     m_DeferredEventIdentifier;
+    int16_t                                 m_PersistedOffset;
+    Kernel::Clock::time_point               m_PersistedAt;
+    bool                                    m_HasPersisted;
+    std::atomic<uint32_t>                   m_QuiescentWindowCount;
+    std::atomic<uint32_t>                   m_UpdateCount;
+};
@@ -0,0 +1,348 @@
+/***********************************************************************
+* @file      NuerteyLDESeriesBusManager.h
+*
+*    Coordinates several First Sensor AG LDE Series sensors sharing the
+*    one SPI bus, each on its own chip select line.
+*
+*    The bus manager alone owns the SPI peripheral; it configures the
+*    format and frequency but once and serializes all access to it. It
+*    keeps a registry of the attached devices together with a descriptor
+*    of their sensor range and atmospheric medium, and acquires from all
+*    of them in one round, either:
+*
+*    - ROUND_ROBIN: the complete read sequence, device after device, or
+*    - INTERLEAVED: the poll command goes to sensor N+1 before sensor N
+*      is read out, so that sensor N+1 is latching its measurement while
+*      the bus is busy with sensor N.
+*
+* @brief
+*
+* @note    \" 3.2 Multiple devices on one bus \" is as per the application
+*          note; MOSI, MISO and SCLK are shared, whilst each device has
+*          its own /CS.
+*
+*          https://www.first-sensor.com/cms/upload/appnotes/AN_LDE-LME-SPI-bus_E_11168.pdf
+*
+* @warning Devices on a managed bus must NOT also be driven through a
+*          NuerteyLDESeriesDevice instance, as that would own the same
+*          peripheral a second time.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include "Protocol.h"
+
+using namespace Utilities;
+using namespace ProtocolDefinitions;
+
+class NuerteyLDESeriesBusManager
+{
+    static constexpr uint8_t  DEFAULT_MODE = 0; // CPOL = 0, CPHA = 0.
+
+    // \" External clock frequency fECLK (VCKSEL=0) Max. 5 MHz \"
+    static constexpr uint32_t DEFAULT_FREQUENCY = 5000000;
+
+public:
+    // Our rigs carry between 4 and 8 sensors.
+    static constexpr std::size_t MAXIMUM_NUMBER_OF_DEVICES = 8;
+
+    enum class Schedule_t : uint8_t
+    {
+        ROUND_ROBIN,
+        INTERLEAVED
+    };
+
+    using RoundCallback_t     = mbed::Callback<void(std::span<const int16_t>)>;
+
+    NuerteyLDESeriesBusManager(PinName mosi,
+                               PinName miso,
+                               PinName sclk,
+                               const Schedule_t& schedule = Schedule_t::INTERLEAVED,
+                               const uint32_t& frequency = DEFAULT_FREQUENCY);
+
+    NuerteyLDESeriesBusManager(const NuerteyLDESeriesBusManager&) = delete;
+    NuerteyLDESeriesBusManager& operator=(const NuerteyLDESeriesBusManager&) = delete;
+
+    virtual ~NuerteyLDESeriesBusManager();
+
+    // Returns the index of the registered device, or -1 if the registry
+    // is full.
+    int RegisterDevice(PinName chipSelect, const LDESeriesDescriptor_t& descriptor);
+
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    int RegisterDevice(PinName chipSelect)
+    {
+        return RegisterDevice(chipSelect, LDE_SERIES_DESCRIPTOR<S, A>);
+    }
+
+    std::size_t GetDeviceCount() const { return m_DeviceCount; }
+    Schedule_t  GetSchedule() const { return m_Schedule; }
+    void        SetSchedule(const Schedule_t& schedule) { m_Schedule = schedule; }
+
+    // One acquisition round across all registered devices, in registry
+    // order. The span must be able to hold a value per device. Returns
+    // false should any one exchange fail; the others are still valid.
+    bool AcquireAll(std::span<int16_t> counts);
+    bool AcquireAll(std::span<float> pressures);
+
+    // Converts raw counts as per the registered device's descriptor.
+    const LDESeriesDescriptor_t& GetDescriptor(const std::size_t& index) const;
+    float ConvertPressure(const std::size_t& index, const int16_t& counts) const;
+
+    // Periodic rounds on the EventQueue; the callback receives the raw
+    // counts of each round, in registry order, in that queue's context.
+    bool Start(const std::chrono::milliseconds& period,
+               const RoundCallback_t& callback,
+               EventQueue* pQueue = &gs_MasterEventQueue);
+    void Stop();
+
+protected:
+    template <std::size_t N>
+    bool Exchange(const std::size_t& index,
+                  const SPICommandSequence_t<N>& cSequence,
+                  SPICommandSequence_t<N>& rSequence);
+
+    bool AcquireRoundRobin(std::span<int16_t> counts);
+    bool AcquireInterleaved(std::span<int16_t> counts);
+
+    void OnSchedule();
+
+private:
+    struct Registration_t
+    {
+        std::optional<DigitalOut>      chipSelect;
+        LDESeriesDescriptor_t          descriptor;
+    };
+
+    SPI                                                       m_TheSPIBus;
+    Schedule_t                                                m_Schedule;
+    std::array<Registration_t, MAXIMUM_NUMBER_OF_DEVICES>     m_Devices;
+    std::size_t                                               m_DeviceCount;
+    std::array<int16_t, MAXIMUM_NUMBER_OF_DEVICES>            m_LatestCounts;
+    EventQueue*                                               m_pEventQueue;
+    int                                                       m_EventIdentifier;
+    RoundCallback_t                                           m_RoundCallback;
+};
+
+inline NuerteyLDESeriesBusManager::NuerteyLDESeriesBusManager(PinName mosi,
+                                                              PinName miso,
+                                                              PinName sclk,
+                                                              const Schedule_t& schedule,
+                                                              const uint32_t& frequency)
+    // No SSEL here; each registered device brings its own chip select.
+    : m_TheSPIBus(mosi, miso, sclk)
+    , m_Schedule(schedule)
+    , m_Devices{}
+    , m_DeviceCount(0)
+    , m_LatestCounts{}
+    , m_pEventQueue(nullptr)
+    , m_EventIdentifier(0)
+    , m_RoundCallback(nullptr)
+{
+    // Configured the once, for every device on the bus.
+    m_TheSPIBus.format(NUMBER_OF_BITS, DEFAULT_MODE);
+    m_TheSPIBus.frequency(frequency);
+}
+
+inline NuerteyLDESeriesBusManager::~NuerteyLDESeriesBusManager()
+{
+    Stop();
+}
+
+inline int NuerteyLDESeriesBusManager::RegisterDevice(PinName chipSelect,
+                                                      const LDESeriesDescriptor_t& descriptor)
+{
+    if (m_DeviceCount >= MAXIMUM_NUMBER_OF_DEVICES)
+    {
+        printf("[%s]: Error! No room for another device on this bus.\n",
+            __PRETTY_FUNCTION__);
+        return -1;
+    }
+
+    auto& registration = m_Devices.at(m_DeviceCount);
+
+    // Chip select is active low, hence start out deasserted.
+    registration.chipSelect.emplace(chipSelect, 1);
+    registration.descriptor = descriptor;
+
+    return static_cast<int>(m_DeviceCount++);
+}
+
+inline bool NuerteyLDESeriesBusManager::AcquireAll(std::span<int16_t> counts)
+{
+    if (counts.size() < m_DeviceCount)
+    {
+        printf("[%s]: Error! Supplied span cannot hold a value per device.\n",
+            __PRETTY_FUNCTION__);
+        return false;
+    }
+
+    // Acquire exclusive access to the SPI bus for the whole round. The
+    // lock within each write nests within this one.
+    m_TheSPIBus.lock();
+
+    auto result = (m_Schedule == Schedule_t::INTERLEAVED)
+                ? AcquireInterleaved(counts)
+                : AcquireRoundRobin(counts);
+
+    m_TheSPIBus.unlock();
+
+    return result;
+}
+
+inline bool NuerteyLDESeriesBusManager::AcquireAll(std::span<float> pressures)
+{
+    std::array<int16_t, MAXIMUM_NUMBER_OF_DEVICES> counts{};
+
+    if (pressures.size() < m_DeviceCount)
+    {
+        printf("[%s]: Error! Supplied span cannot hold a value per device.\n",
+            __PRETTY_FUNCTION__);
+        return false;
+    }
+
+    auto result = AcquireAll(counts);
+
+    for (std::size_t i = 0; i < m_DeviceCount; ++i)
+    {
+        pressures[i] = ConvertPressure(i, counts[i]);
+    }
+
+    return result;
+}
+
+inline const LDESeriesDescriptor_t& NuerteyLDESeriesBusManager::GetDescriptor(const std::size_t& index) const
+{
+    return m_Devices.at(index).descriptor;
+}
+
+inline float NuerteyLDESeriesBusManager::ConvertPressure(const std::size_t& index,
+                                                         const int16_t& counts) const
+{
+    return GetDescriptor(index).ToFloat(counts);
+}
+
+inline bool NuerteyLDESeriesBusManager::Start(const std::chrono::milliseconds& period,
+                                              const RoundCallback_t& callback,
+                                              EventQueue* pQueue)
+{
+    if (m_EventIdentifier || !pQueue)
+    {
+        return false;
+    }
+
+    m_pEventQueue = pQueue;
+    m_RoundCallback = callback;
+    m_EventIdentifier = m_pEventQueue->call_every(period, this, &NuerteyLDESeriesBusManager::OnSchedule);
+
+    return (m_EventIdentifier != 0);
+}
+
+inline void NuerteyLDESeriesBusManager::Stop()
+{
+    if (m_EventIdentifier)
+    {
+        m_pEventQueue->cancel(m_EventIdentifier);
+        m_EventIdentifier = 0;
+    }
+}
+
+template <std::size_t N>
+bool NuerteyLDESeriesBusManager::Exchange(const std::size_t& index,
+                                          const SPICommandSequence_t<N>& cSequence,
+                                          SPICommandSequence_t<N>& rSequence)
+{
+    auto& chipSelect = *m_Devices.at(index).chipSelect;
+
+    rSequence.fill(0);
+
+    // Chip select is active low.
+    chipSelect = 0;
+    std::size_t bytesWritten = m_TheSPIBus.write(cSequence.data(),
+                                                 cSequence.size(),
+                                                 rSequence.data(),
+                                                 rSequence.size());
+    chipSelect = 1;
+
+    if (bytesWritten != N)
+    {
+        printf("%s: Error! SPI Command Sequence - Incorrect number of bytes \
+            transmitted to device [%u]\n",
+            __PRETTY_FUNCTION__, index);
+        return false;
+    }
+
+    return true;
+}
+
+inline bool NuerteyLDESeriesBusManager::AcquireRoundRobin(std::span<int16_t> counts)
+{
+    bool result{true};
+    LDESeriesReadSequence_t response{};
+
+    for (std::size_t i = 0; i < m_DeviceCount; ++i)
+    {
+        if (Exchange(i, PRESSURE_READ_SEQUENCE, response))
+        {
+            counts[i] = Deserialize(ExtractResponseFrame(response));
+        }
+        else
+        {
+            counts[i] = 0;
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+inline bool NuerteyLDESeriesBusManager::AcquireInterleaved(std::span<int16_t> counts)
+{
+    bool result{true};
+    std::decay_t<decltype(PRESSURE_POLL_SEQUENCE)> pollResponse{};
+    std::decay_t<decltype(RESULT_READOUT_SEQUENCE)> readoutResponse{};
+
+    if (m_DeviceCount == 0)
+    {
+        return result;
+    }
+
+    // Prime the pipeline with the first device's poll.
+    result = Exchange(0, PRESSURE_POLL_SEQUENCE, pollResponse);
+
+    for (std::size_t i = 0; i < m_DeviceCount; ++i)
+    {
+        // Sensor N+1 latches its measurement whilst we read out sensor N.
+        if ((i + 1) < m_DeviceCount)
+        {
+            result = Exchange(i + 1, PRESSURE_POLL_SEQUENCE, pollResponse) && result;
+        }
+
+        if (Exchange(i, RESULT_READOUT_SEQUENCE, readoutResponse))
+        {
+            counts[i] = Deserialize(ExtractResponseFrame(readoutResponse));
+        }
+        else
+        {
+            counts[i] = 0;
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+inline void NuerteyLDESeriesBusManager::OnSchedule()
+{
+    AcquireAll(m_LatestCounts);
+
+    if (m_RoundCallback)
+    {
+        m_RoundCallback(std::span<const int16_t>(m_LatestCounts.data(), m_DeviceCount));
+    }
+}
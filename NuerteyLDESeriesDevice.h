@@ -176,6 +176,9 @@
 
 #include <system_error>
 #include "Protocol.h" 
+#include "JSONStreamWriter.h"
+#include "Instrumentation.h"
+#include "NuerteyLDESeriesAutoZero.h"
 
 using namespace Utilities;
 using namespace ProtocolDefinitions;
@@ -200,8 +203,39 @@ using namespace ProtocolDefinitions;
 // MISO   Master In Slave Out       LDE => MCU
 // =====================================================================
 
+// UTC, off the disciplined clock service, in us since the UNIX epoch.
+using UTCTimestamp_t = std::chrono::time_point<NucleoF767ZIClock_t, MicroSecs_t>;
+
+// Both on-chip measurements as acquired under the one bus lock, hence
+// coherent with each other and with the accompanying timestamps.
+struct LDESeriesSample_t
+{
+    Kernel::Clock::time_point timestamp;
+    UTCTimestamp_t            utc;
+    double                    pressure;
+    double                    temperature;
+    bool                      valid;
+};
+
+// The per-sample telemetry record, as a compile-time schema. The
+// timestamp is written in Kernel::Clock ticks, i.e. ms since boot, and
+// the UTC timestamp in us since the UNIX epoch.
+inline constexpr auto LDE_SERIES_SAMPLE_SCHEMA = std::make_tuple(
+    JSONField_t<LDESeriesSample_t, Kernel::Clock::time_point>{"t", &LDESeriesSample_t::timestamp},
+    JSONField_t<LDESeriesSample_t, UTCTimestamp_t>{"utc", &LDESeriesSample_t::utc},
+    JSONField_t<LDESeriesSample_t, double>{"p",     &LDESeriesSample_t::pressure},
+    JSONField_t<LDESeriesSample_t, double>{"temp",  &LDESeriesSample_t::temperature},
+    JSONField_t<LDESeriesSample_t, bool>{"valid",   &LDESeriesSample_t::valid});
+
+static_assert(IsPlainJSONSchema(LDE_SERIES_SAMPLE_SCHEMA));
+
 class NuerteyLDESeriesDevice
 {        
+public:
+    using SPIFrameCallback_t    = mbed::Callback<void(SPIFrame_t)>;
+    using MeasurementCallback_t = mbed::Callback<void(double)>;
+
+private:
     static constexpr uint8_t DEFAULT_BYTE_ORDER = 0;  // A value of zero indicates MSB-first.
     
     // \" 
@@ -237,18 +271,105 @@ public:
 
     template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
     double GetPressure();
+    
+    // The one shared, non-template acquisition path, as selected at
+    // runtime by descriptor. The templated flavour above merely forwards
+    // its compile-time generated descriptor, LDE_SERIES_DESCRIPTOR<S, A>.
+    double GetPressure(const LDESeriesDescriptor_t& descriptor);
         
     template <IsTemperatureScaleType T>
     double GetTemperature();
+
+    // As above, only the raw two's complement counts are returned and 
+    // their conversion is deferred to the consumer. See the conversion
+    // layer, PressureConversion<S, A> and TemperatureConversion<T>.
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    bool GetRawPressure(RawPressure_t<S, A>& rawPressure);
+
+    bool GetRawPressure(int16_t& counts);
+    
+    bool GetRawTemperature(RawTemperature_t& rawTemperature);
+
+    // For control loops that always need both values. Slave Select is
+    // held asserted across both the pressure and temperature exchanges,
+    // and there is but the one error path.
+    template <IsLDESeriesSensorType S, 
+              IsAtmosphericMediumType A, 
+              IsTemperatureScaleType T = Celsius_t>
+    LDESeriesSample_t GetSample();
+
+    // Temperature in °C.
+    LDESeriesSample_t GetSample(const LDESeriesDescriptor_t& descriptor);
+
+    // As GetSample(), only with the pressure corrected for the very
+    // temperature read alongside it, per the device's compensation table.
+    template <IsLDESeriesSensorType S, 
+              IsAtmosphericMediumType A, 
+              IsTemperatureScaleType T = Celsius_t,
+              std::size_t M>
+    LDESeriesSample_t GetSample(const TemperatureCompensationTable_t<M>& compensation);
+
+#if DEVICE_SPI_ASYNCH
+    // Non-blocking counterparts of the above. The SPI exchange is driven
+    // by the asynchronous (interrupt/DMA) SPI API so that the calling 
+    // thread is free to return to say, MQTT or HTTP work. The finished 
+    // frame, or the converted measurement, is posted to the supplied 
+    // EventQueue (gs_MasterEventQueue by default) and the callback is
+    // thus invoked in that queue's thread context. 
+    //
+    // Passing a nullptr EventQueue rather invokes the callback directly
+    // from the SPI IRQ context; only do so if the callback is ISR-safe.
+    // 
+    // Only one asynchronous acquisition may be pending at a time. A 
+    // return of false indicates that one is already in flight or that 
+    // the transfer could not be started.
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    bool GetPressureAsync(const MeasurementCallback_t& callback,
+                          EventQueue* pQueue = &gs_MasterEventQueue);
+        
+    template <IsTemperatureScaleType T>
+    bool GetTemperatureAsync(const MeasurementCallback_t& callback,
+                             EventQueue* pQueue = &gs_MasterEventQueue);
+                             
+    bool AcquireFrameAsync(const LDESeriesReadSequence_t& sequence,
+                           const SPIFrameCallback_t& callback,
+                           EventQueue* pQueue = &gs_MasterEventQueue);
+                           
+    bool     IsAsyncTransferPending() const { return m_AsyncTransferPending.load(); }
+    uint32_t GetAsyncErrorCount() const { return m_AsyncErrorCount.load(); }
+#endif
         
     uint8_t  GetMode() const { return m_Mode; }
     uint8_t  GetByteOrder() const { return m_ByteOrder; }
     uint8_t  GetBitsPerWord() const { return m_BitsPerWord; }
     uint32_t GetFrequency() const { return m_Frequency; };
 
+    // Every pressure reading thereafter, synchronous or not, raw or not,
+    // has the engine's offset subtracted, in counts, ahead of conversion.
+    // A nullptr, the default, leaves the readings as the sensor gave them.
+    void SetAutoZero(NuerteyLDESeriesAutoZero* pAutoZero) { m_pAutoZero = pAutoZero; }
+    NuerteyLDESeriesAutoZero* GetAutoZero() const { return m_pAutoZero; }
+
+    // ISR-safe; for those, such as the sampler, that deserialize frames
+    // of their own.
+    int16_t ZeroPressure(const int16_t& counts) const
+    {
+        return (m_pAutoZero ? m_pAutoZero->Apply(counts) : counts);
+    }
+
 protected:
     bool FullDuplexTransfer(const SPIFrame_t& cBuffer, SPIFrame_t& rBuffer);
     
+    // Clocks out an entire command sequence as one chained SPI transaction
+    // and returns the trailing (i.e. register contents) frame of the response.
+    template <std::size_t N>
+    bool SequencedTransfer(const SPICommandSequence_t<N>& cSequence, SPIFrame_t& rBuffer);
+    
+    bool AcquireSampleCounts(int16_t& pressureCounts,
+                             int16_t& temperatureCounts,
+                             Kernel::Clock::time_point& timestamp,
+                             UTCTimestamp_t& utc);
+
     template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
     double ConvertPressure(const int16_t& sensorData) const;
     
@@ -258,11 +379,42 @@ protected:
     double ConvertTemperature(const int16_t& sensorData) const;
     
 private:               
+#if DEVICE_SPI_ASYNCH
+    using Converter_t = double (NuerteyLDESeriesDevice::*)(const int16_t&) const;
+
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    double ConvertZeroedPressure(const int16_t& sensorData) const;
+
+    bool ClaimAsyncTransfer();
+    bool StartAsyncTransfer(const LDESeriesReadSequence_t& sequence,
+                            const SPIFrameCallback_t& frameCallback,
+                            const Converter_t& converter,
+                            const MeasurementCallback_t& measurementCallback,
+                            EventQueue* pQueue);
+    void OnAsyncTransferComplete(int event);
+    void DeliverAsyncFrame(SPIFrame_t frame);
+    void ReportAsyncError(int event);
+#endif
+
     SPI                                m_TheSPIBus;
     uint8_t                            m_Mode;
     uint8_t                            m_ByteOrder;
     uint8_t                            m_BitsPerWord;
     uint32_t                           m_Frequency;
+    NuerteyLDESeriesAutoZero*          m_pAutoZero;
+    
+#if DEVICE_SPI_ASYNCH
+    // Buffers handed to the SPI peripheral must outlive the transfer,
+    // hence they are members rather than automatic variables.
+    LDESeriesReadSequence_t            m_AsyncTxSequence;
+    LDESeriesReadSequence_t            m_AsyncRxSequence;
+    EventQueue*                        m_pAsyncEventQueue;
+    SPIFrameCallback_t                 m_AsyncFrameCallback;
+    Converter_t                        m_AsyncConverter;
+    MeasurementCallback_t              m_AsyncMeasurementCallback;
+    std::atomic<bool>                  m_AsyncTransferPending;
+    std::atomic<uint32_t>              m_AsyncErrorCount;
+#endif
 };
 
 NuerteyLDESeriesDevice::NuerteyLDESeriesDevice(PinName mosi,
@@ -285,6 +437,17 @@ NuerteyLDESeriesDevice::NuerteyLDESeriesDevice(PinName mosi,
     , m_ByteOrder(byteOrder)
     , m_BitsPerWord(bitsPerWord)
     , m_Frequency(frequency)
+    , m_pAutoZero(nullptr)
+#if DEVICE_SPI_ASYNCH
+    , m_AsyncTxSequence{}
+    , m_AsyncRxSequence{}
+    , m_pAsyncEventQueue(nullptr)
+    , m_AsyncFrameCallback(nullptr)
+    , m_AsyncConverter(nullptr)
+    , m_AsyncMeasurementCallback(nullptr)
+    , m_AsyncTransferPending(false)
+    , m_AsyncErrorCount(0)
+#endif
 {
     // \" The LDE device runs in SPI mode 0, which requires the clock 
     // line SCLK to idle low (CPOL = 0), and for data to be sampled on
@@ -294,6 +457,13 @@ NuerteyLDESeriesDevice::NuerteyLDESeriesDevice(PinName mosi,
     // format set to 8-bits, mode 0, and a clock frequency of 1MHz.
     m_TheSPIBus.format(m_BitsPerWord, m_Mode);
     m_TheSPIBus.frequency(m_Frequency);
+    
+#if DEVICE_SPI_ASYNCH
+    // Where the target HAL has a DMA channel for this SPI peripheral, 
+    // use it for the asynchronous transfers; otherwise the HAL quietly
+    // falls back to interrupt-driven transfers.
+    m_TheSPIBus.set_dma_usage(DMA_USAGE_OPPORTUNISTIC);
+#endif
 }
 
 NuerteyLDESeriesDevice::~NuerteyLDESeriesDevice()
@@ -302,9 +472,14 @@ NuerteyLDESeriesDevice::~NuerteyLDESeriesDevice()
 
 template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
 double NuerteyLDESeriesDevice::GetPressure()
+{
+    return GetPressure(LDE_SERIES_DESCRIPTOR<S, A>);
+}
+
+double NuerteyLDESeriesDevice::GetPressure(const LDESeriesDescriptor_t& descriptor)
 {
     double result{0.0};
-    SPIFrame_t responseFrame = {}; // Initialize to zeros.
+    int16_t sensorData{0};
 
     // \" The flow of data to and from the LDE/LME device requires a 
     // very specific sequence of events that are controlled by software
@@ -312,22 +487,35 @@ double NuerteyLDESeriesDevice::GetPressure()
     //
     // https://www.first-sensor.com/cms/upload/appnotes/AN_LDE-LME-SPI-bus_E_11168.pdf
     
-    // Initiate pressure measurement data transfer from the device:
-    m_TheSPIBus.write(POLL_CURRENT_PRESSURE_MEASUREMENT);
-    m_TheSPIBus.write(SEND_RESULT_TO_DATA_REGISTER);
-    m_TheSPIBus.write(READ_DATA_REGISTER);
+    // Initiate pressure measurement data transfer from the device. The
+    // three command bytes and the dummy read-out frame are clocked out 
+    // back-to-back in the one transaction. A failure is reported by
+    // GetRawPressure() itself:
+    if (GetRawPressure(sensorData))
+    {
+        result = descriptor.ToDouble(sensorData);
+    }
     
-    auto status = FullDuplexTransfer(LDE_SERIES_SPI_DUMMY_FRAME, 
-                                     responseFrame);
+    return result;
+}
+
+template <IsTemperatureScaleType T>
+double NuerteyLDESeriesDevice::GetTemperature()
+{
+    double result{0.0};
+    SPIFrame_t responseFrame = {}; // Initialize to zeros.
+    
+    // Initiate temperature measurement data transfer from the device:
+    auto status = SequencedTransfer(TEMPERATURE_READ_SEQUENCE, responseFrame);
     
     if (status)
     {
         auto sensorData = Deserialize(responseFrame);
-        result = ConvertPressure<S, A>(sensorData);
+        result = ConvertTemperature<T>(sensorData);
     }
     else
     {
-        printf("[%s]: Error! Failed to retrieve LDE sensor pressure \
+        printf("[%s]: Error! Failed to retrieve LDE sensor temperature \
             measurement value.\n",
             __PRETTY_FUNCTION__);
     }
@@ -335,38 +523,302 @@ double NuerteyLDESeriesDevice::GetPressure()
     return result;
 }
 
-template <IsTemperatureScaleType T>
-double NuerteyLDESeriesDevice::GetTemperature()
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+bool NuerteyLDESeriesDevice::GetRawPressure(RawPressure_t<S, A>& rawPressure)
+{
+    return GetRawPressure(rawPressure.counts);
+}
+
+bool NuerteyLDESeriesDevice::GetRawPressure(int16_t& counts)
 {
-    double result{0.0};
     SPIFrame_t responseFrame = {}; // Initialize to zeros.
     
-    // Initiate temperature measurement data transfer from the device:
-    m_TheSPIBus.write(POLL_CURRENT_TEMPERATURE_MEASUREMENT);
-    m_TheSPIBus.write(SEND_RESULT_TO_DATA_REGISTER);
-    m_TheSPIBus.write(READ_DATA_REGISTER);
+    auto status = SequencedTransfer(PRESSURE_READ_SEQUENCE, responseFrame);
     
-    auto status = FullDuplexTransfer(LDE_SERIES_SPI_DUMMY_FRAME, 
-                                     responseFrame);
+    if (status)
+    {
+        counts = ZeroPressure(Deserialize(responseFrame));
+    }
+    else
+    {
+        printf("[%s]: Error! Failed to retrieve LDE sensor raw pressure \
+            counts.\n",
+            __PRETTY_FUNCTION__);
+    }
+    
+    return status;
+}
+
+bool NuerteyLDESeriesDevice::GetRawTemperature(RawTemperature_t& rawTemperature)
+{
+    SPIFrame_t responseFrame = {}; // Initialize to zeros.
+    
+    auto status = SequencedTransfer(TEMPERATURE_READ_SEQUENCE, responseFrame);
     
     if (status)
     {
-        auto sensorData = Deserialize(responseFrame);
-        result = ConvertTemperature<T>(sensorData);
+        rawTemperature.counts = Deserialize(responseFrame);
     }
     else
     {
-        printf("[%s]: Error! Failed to retrieve LDE sensor temperature \
-            measurement value.\n",
+        printf("[%s]: Error! Failed to retrieve LDE sensor raw temperature \
+            counts.\n",
             __PRETTY_FUNCTION__);
     }
     
+    return status;
+}
+
+template <IsLDESeriesSensorType S, 
+          IsAtmosphericMediumType A, 
+          IsTemperatureScaleType T>
+LDESeriesSample_t NuerteyLDESeriesDevice::GetSample()
+{
+    LDESeriesSample_t result{};
+    int16_t pressureCounts{0};
+    int16_t temperatureCounts{0};
+
+    if (AcquireSampleCounts(pressureCounts, temperatureCounts, result.timestamp, result.utc))
+    {
+        result.pressure    = ConvertPressure<S, A>(pressureCounts);
+        result.temperature = ConvertTemperature<T>(temperatureCounts);
+        result.valid       = true;
+    }
+    
     return result;
 }
 
+LDESeriesSample_t NuerteyLDESeriesDevice::GetSample(const LDESeriesDescriptor_t& descriptor)
+{
+    LDESeriesSample_t result{};
+    int16_t pressureCounts{0};
+    int16_t temperatureCounts{0};
+
+    if (AcquireSampleCounts(pressureCounts, temperatureCounts, result.timestamp, result.utc))
+    {
+        result.pressure    = descriptor.ToDouble(pressureCounts);
+        result.temperature = ConvertTemperature(temperatureCounts);
+        result.valid       = true;
+    }
+    
+    return result;
+}
+
+template <IsLDESeriesSensorType S, 
+          IsAtmosphericMediumType A, 
+          IsTemperatureScaleType T,
+          std::size_t M>
+LDESeriesSample_t NuerteyLDESeriesDevice::GetSample(const TemperatureCompensationTable_t<M>& compensation)
+{
+    LDESeriesSample_t result{};
+    int16_t pressureCounts{0};
+    int16_t temperatureCounts{0};
+
+    if (AcquireSampleCounts(pressureCounts, temperatureCounts, result.timestamp, result.utc))
+    {
+        // Not rounded back to whole counts; the correction may well be finer.
+        result.pressure    = static_cast<double>(compensation.Apply(pressureCounts, temperatureCounts)
+                                               * PressureConversion<S, A>::COEFFICIENT);
+        result.temperature = ConvertTemperature<T>(temperatureCounts);
+        result.valid       = true;
+    }
+    
+    return result;
+}
+
+bool NuerteyLDESeriesDevice::AcquireSampleCounts(int16_t& pressureCounts,
+                                                 int16_t& temperatureCounts,
+                                                 Kernel::Clock::time_point& timestamp,
+                                                 UTCTimestamp_t& utc)
+{
+    SPIFrame_t pressureFrame = {};    // Initialize to zeros.
+    SPIFrame_t temperatureFrame = {}; // Initialize to zeros.
+
+    // Assert the Slave Select line, acquiring exclusive access to the
+    // SPI bus for the duration of both exchanges. The select() within
+    // each write nests within this one and so does not toggle the line.
+    m_TheSPIBus.select();
+    
+    timestamp = Kernel::Clock::now();
+    utc = UTCTimestamp_t(MicroSecs_t(g_ClockService.Now() / 1000));
+    
+    auto status = (SequencedTransfer(PRESSURE_READ_SEQUENCE, pressureFrame)
+                && SequencedTransfer(TEMPERATURE_READ_SEQUENCE, temperatureFrame));
+    
+    m_TheSPIBus.deselect();
+    
+    if (status)
+    {
+        pressureCounts    = ZeroPressure(Deserialize(pressureFrame));
+        temperatureCounts = Deserialize(temperatureFrame);
+    }
+    else
+    {
+        printf("[%s]: Error! Failed to retrieve LDE sensor pressure and \
+            temperature sample.\n",
+            __PRETTY_FUNCTION__);
+    }
+    
+    return status;
+}
+
+#if DEVICE_SPI_ASYNCH
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+bool NuerteyLDESeriesDevice::GetPressureAsync(const MeasurementCallback_t& callback,
+                                              EventQueue* pQueue)
+{
+    return StartAsyncTransfer(PRESSURE_READ_SEQUENCE,
+                              nullptr,
+                              &NuerteyLDESeriesDevice::ConvertZeroedPressure<S, A>,
+                              callback,
+                              pQueue);
+}
+
+template <IsTemperatureScaleType T>
+bool NuerteyLDESeriesDevice::GetTemperatureAsync(const MeasurementCallback_t& callback,
+                                                 EventQueue* pQueue)
+{
+    return StartAsyncTransfer(TEMPERATURE_READ_SEQUENCE,
+                              nullptr,
+                              &NuerteyLDESeriesDevice::ConvertTemperature<T>,
+                              callback,
+                              pQueue);
+}
+
+bool NuerteyLDESeriesDevice::AcquireFrameAsync(const LDESeriesReadSequence_t& sequence,
+                                               const SPIFrameCallback_t& callback,
+                                               EventQueue* pQueue)
+{
+    return StartAsyncTransfer(sequence, callback, nullptr, nullptr, pQueue);
+}
+
+bool NuerteyLDESeriesDevice::ClaimAsyncTransfer()
+{
+    // Returns the previous value, hence true means somebody else owns it.
+    return !m_AsyncTransferPending.exchange(true);
+}
+
+bool NuerteyLDESeriesDevice::StartAsyncTransfer(const LDESeriesReadSequence_t& sequence,
+                                                const SPIFrameCallback_t& frameCallback,
+                                                const Converter_t& converter,
+                                                const MeasurementCallback_t& measurementCallback,
+                                                EventQueue* pQueue)
+{
+    if (!ClaimAsyncTransfer())
+    {
+        return false;
+    }
+    
+    // \" The flow of data to and from the LDE/LME device requires a 
+    // very specific sequence of events that are controlled by software
+    // running on the SPI master device. \"
+    //
+    // The whole of that sequence goes out as one transaction, exactly as
+    // in the blocking path, only now we are notified of its completion.
+    m_AsyncTxSequence          = sequence;
+    m_AsyncRxSequence.fill(0);
+    m_pAsyncEventQueue         = pQueue;
+    m_AsyncFrameCallback       = frameCallback;
+    m_AsyncConverter           = converter;
+    m_AsyncMeasurementCallback = measurementCallback;
+    
+    auto status = m_TheSPIBus.transfer(m_AsyncTxSequence.data(),
+                                       m_AsyncTxSequence.size(),
+                                       m_AsyncRxSequence.data(),
+                                       m_AsyncRxSequence.size(),
+                                       mbed::callback(this, &NuerteyLDESeriesDevice::OnAsyncTransferComplete),
+                                       SPI_EVENT_ALL);
+    
+    // Zero indicates that the transfer was started (or queued).
+    if (status != 0)
+    {
+        m_AsyncErrorCount++;
+        m_AsyncTransferPending.store(false);
+        
+        // We may well have been invoked from an ISR, say a Ticker.
+        if (!core_util_is_isr_active())
+        {
+            printf("[%s]: Error! Failed to start asynchronous SPI transfer.\n",
+                __PRETTY_FUNCTION__);
+        }
+        return false;
+    }
+    
+    return true;
+}
+
+void NuerteyLDESeriesDevice::OnAsyncTransferComplete(int event)
+{
+    // Caution! We are in the SPI IRQ context here. No printf, no mutexes.
+    if (!(event & SPI_EVENT_COMPLETE) || (event & (SPI_EVENT_ERROR | SPI_EVENT_RX_OVERFLOW)))
+    {
+        if (m_pAsyncEventQueue)
+        {
+            m_pAsyncEventQueue->call(this, &NuerteyLDESeriesDevice::ReportAsyncError, event);
+        }
+        else
+        {
+            ReportAsyncError(event);
+        }
+        return;
+    }
+    
+    // The frame is copied by value into the event so that the response
+    // buffer is immediately free for the next acquisition.
+    auto responseFrame = ExtractResponseFrame(m_AsyncRxSequence);
+    
+    if (m_pAsyncEventQueue)
+    {
+        m_pAsyncEventQueue->call(this, &NuerteyLDESeriesDevice::DeliverAsyncFrame, responseFrame);
+    }
+    else
+    {
+        DeliverAsyncFrame(responseFrame);
+    }
+}
+
+void NuerteyLDESeriesDevice::DeliverAsyncFrame(SPIFrame_t frame)
+{
+    // Take local copies before releasing the transfer, so the callback 
+    // itself is free to chain the next asynchronous acquisition.
+    auto frameCallback       = m_AsyncFrameCallback;
+    auto converter           = m_AsyncConverter;
+    auto measurementCallback = m_AsyncMeasurementCallback;
+    
+    m_AsyncTransferPending.store(false);
+
+    if (converter)
+    {
+        if (measurementCallback)
+        {
+            measurementCallback((this->*converter)(Deserialize(frame)));
+        }
+    }
+    else if (frameCallback)
+    {
+        frameCallback(frame);
+    }
+}
+
+void NuerteyLDESeriesDevice::ReportAsyncError(int event)
+{
+    m_AsyncErrorCount++;
+    m_AsyncTransferPending.store(false);
+    
+    // Only report when we have been translated out of the IRQ context.
+    if (m_pAsyncEventQueue)
+    {
+        printf("[%s]: Error! Asynchronous SPI transfer failed with event [0x%X].\n",
+            __PRETTY_FUNCTION__, event);
+    }
+}
+#endif
+
 bool NuerteyLDESeriesDevice::FullDuplexTransfer(const SPIFrame_t& cBuffer,
                                                       SPIFrame_t& rBuffer)
 {   
+    INSTRUMENT_SCOPE(Probe_t::SPI_TRANSFER);
+
     bool result{true};
     
     // Do not presume that the users of this OS-abstraction are well-behaved.
@@ -410,14 +862,46 @@ bool NuerteyLDESeriesDevice::FullDuplexTransfer(const SPIFrame_t& cBuffer,
     return result;
 }
 
+template <std::size_t N>
+bool NuerteyLDESeriesDevice::SequencedTransfer(const SPICommandSequence_t<N>& cSequence,
+                                                     SPIFrame_t& rBuffer)
+{
+    bool result{true};
+    SPICommandSequence_t<N> response = {}; // Initialize to zeros.
+    
+    rBuffer.fill(0);
+
+    // Note that write internally mutex locks and selects the SPI bus, 
+    // hence Slave Select is asserted but once for the entire sequence
+    // and the per-call driver overhead is likewise incurred only once.
+    std::size_t bytesWritten = m_TheSPIBus.write(cSequence.data(),
+                                                 cSequence.size(),
+                                                 response.data(), 
+                                                 response.size());
+    
+    if (bytesWritten != N)
+    {
+        printf("%s: Error! SPI Command Sequence - Incorrect number of bytes \
+            transmitted\n",
+            __PRETTY_FUNCTION__);
+        result = false;
+    } 
+    else
+    {
+        rBuffer = ExtractResponseFrame(response);
+    }
+    
+    return result;
+}
+
 template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
 double NuerteyLDESeriesDevice::ConvertPressure(const int16_t& sensorData) const
 {
-    double result{0.0};
-    
-    // Convert 2's complement to Pascals.
-    result = static_cast<double>(sensorData)/ScalingFactorMap<S>::VALUE;
+    INSTRUMENT_SCOPE(Probe_t::CONVERT_PRESSURE);
 
+    // Convert 2's complement to Pascals and, in the same breath, correct
+    // for the gas medium. The two factors are pre-folded at compile-time:
+    //
     // \" (6) For example with a LDES500... sensor measuring CO2 gas, at 
     // full-scale output the actual pressure will be:
     //
@@ -425,10 +909,16 @@ double NuerteyLDESeriesDevice::ConvertPressure(const int16_t& sensorData) const
     //
     // ΔPeff = True differential pressure
     // ΔP Sensor= Differential pressure as indicated by output signal \"    
-    result = result * GasCorrectionFactor<A>::value;
-    
-    return result;
+    return (static_cast<double>(sensorData) * PressureCoefficient<S, A>::VALUE);
+}
+
+#if DEVICE_SPI_ASYNCH
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+double NuerteyLDESeriesDevice::ConvertZeroedPressure(const int16_t& sensorData) const
+{
+    return ConvertPressure<S, A>(ZeroPressure(sensorData));
 }
+#endif
 
 double NuerteyLDESeriesDevice::ConvertTemperature(const int16_t& sensorData) const
 {
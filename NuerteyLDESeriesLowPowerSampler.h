@@ -0,0 +1,415 @@
+/***********************************************************************
+* @file      NuerteyLDESeriesLowPowerSampler.h
+*
+*    Duty-cycled, low-power acquisition mode for battery-backed remote
+*    units, as an alternative to the continuous, Ticker-driven sampler.
+*
+*    A LowPowerTicker wakes the MCU every burst period. The burst, N
+*    paired pressure/temperature samples (see GetSample()) a sample
+*    spacing apart, is then taken in the EventQueue context and buffered,
+*    after which there is nothing left to run, and the idle thread, the
+*    RTOS being tickless, takes the MCU back into deep sleep. Only once M
+*    bursts have accumulated is the uplink callback invoked, with the lot
+*    as the one batch, in the uplink EventQueue's context; it is up to
+*    that callback to wake the PHY or radio, connect, publish, and power
+*    it back down again.
+*
+*    Usage, a burst of 8 samples every 15 s, uplinked once a minute:
+*
+*    NuerteyLDESeriesLowPowerSampler<LDE_S250_B_t, DryAirAtmosphere_t>
+*        lowPowerSampler(g_LDESeriesDevice);
+*
+*    lowPowerSampler.Configure({15s, 8, 1ms, 4, 0.0f, 0.0f, 0.0f});
+*    lowPowerSampler.SetUplink(callback(&UplinkBatch));
+*    lowPowerSampler.Start();
+*
+* @brief
+*
+* @note    GetReport() gives the duty cycle for the configuration running,
+*          both as the bursts' own share of the burst period, timed by a
+*          LowPowerTimer, and, with MBED_CPU_STATS_ENABLED, as the shares
+*          of time the MCU was active, asleep and deep asleep since
+*          Start(). Given the board's currents in each of those states,
+*          in the configuration, the average current is estimated off the
+*          latter, or failing that, off the former.
+*
+*          Nothing here blocks deep sleep in between bursts; LowPowerTicker
+*          and LowPowerTimer run off the LPTIM, which keeps running in it.
+*          The clock service is caught up ahead of every sample, as its
+*          cycle counter does not; see NuerteyClockService.h.
+*
+* @warning Deep sleep is only entered if nothing else holds it off. The
+*          continuous sampler's Ticker, a us_ticker-based Timer, a pending
+*          asynchronous SPI transfer, or a connected Ethernet interface
+*          all do; stop the one, and disconnect the other, beforehand.
+*
+*          The buffer holds N samples; keep M bursts of samples well short
+*          of that, lest a slow uplink have the next bursts dropped.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include "NuerteyLDESeriesDevice.h"
+#include "SPSCRingBuffer.h"
+
+// Power of two; of LDESeriesSample_t, i.e. 40 bytes apiece, twice over.
+constexpr std::size_t DEFAULT_LOW_POWER_BUFFER_CAPACITY = 64;
+
+struct LDESeriesLowPowerConfiguration_t
+{
+    std::chrono::milliseconds burstPeriod;
+    uint16_t                  samplesPerBurst;
+    std::chrono::milliseconds sampleSpacing;     // Within a burst.
+    uint16_t                  burstsPerUplink;
+
+    // mA, as measured on the board itself in each of the MCU's states,
+    // for the average current to be estimated; zeros if unknown.
+    float                     runCurrent;
+    float                     sleepCurrent;
+    float                     deepSleepCurrent;
+};
+
+inline constexpr LDESeriesLowPowerConfiguration_t DEFAULT_LOW_POWER_CONFIGURATION{
+    std::chrono::milliseconds(15000), 8, std::chrono::milliseconds(1), 4, 0.0f, 0.0f, 0.0f};
+
+struct LDESeriesLowPowerReport_t
+{
+    uint32_t bursts;
+    uint32_t uplinks;
+    float    burstDuration;      // ms, on average.
+    float    burstDutyCycle;     // Of the burst period.
+    float    activeFraction;     // Of the time since Start(); zeros without
+    float    sleepFraction;      // MBED_CPU_STATS_ENABLED.
+    float    deepSleepFraction;
+    float    averageCurrent;     // mA, estimated; zero if unknown.
+};
+
+inline constexpr auto LDE_SERIES_LOW_POWER_REPORT_SCHEMA = std::make_tuple(
+    JSONField_t<LDESeriesLowPowerReport_t, uint32_t>{"bursts",  &LDESeriesLowPowerReport_t::bursts},
+    JSONField_t<LDESeriesLowPowerReport_t, uint32_t>{"uplinks", &LDESeriesLowPowerReport_t::uplinks},
+    JSONField_t<LDESeriesLowPowerReport_t, float>{"burst_ms",   &LDESeriesLowPowerReport_t::burstDuration},
+    JSONField_t<LDESeriesLowPowerReport_t, float>{"duty",       &LDESeriesLowPowerReport_t::burstDutyCycle},
+    JSONField_t<LDESeriesLowPowerReport_t, float>{"active",     &LDESeriesLowPowerReport_t::activeFraction},
+    JSONField_t<LDESeriesLowPowerReport_t, float>{"sleep",      &LDESeriesLowPowerReport_t::sleepFraction},
+    JSONField_t<LDESeriesLowPowerReport_t, float>{"deep",       &LDESeriesLowPowerReport_t::deepSleepFraction},
+    JSONField_t<LDESeriesLowPowerReport_t, float>{"mA",         &LDESeriesLowPowerReport_t::averageCurrent});
+
+static_assert(IsPlainJSONSchema(LDE_SERIES_LOW_POWER_REPORT_SCHEMA));
+
+template <IsLDESeriesSensorType S,
+          IsAtmosphericMediumType A,
+          IsTemperatureScaleType T = Celsius_t,
+          std::size_t N = DEFAULT_LOW_POWER_BUFFER_CAPACITY>
+class NuerteyLDESeriesLowPowerSampler
+{
+public:
+    using SampleBuffer_t   = SPSCRingBuffer<LDESeriesSample_t, N>;
+
+    // Returns true once the batch is delivered; on false, the batch is
+    // kept, and offered again, topped up, come the next uplink.
+    using UplinkCallback_t = mbed::Callback<bool(std::span<const LDESeriesSample_t>)>;
+
+    explicit NuerteyLDESeriesLowPowerSampler(NuerteyLDESeriesDevice& device);
+
+    NuerteyLDESeriesLowPowerSampler(const NuerteyLDESeriesLowPowerSampler&) = delete;
+    NuerteyLDESeriesLowPowerSampler& operator=(const NuerteyLDESeriesLowPowerSampler&) = delete;
+
+    virtual ~NuerteyLDESeriesLowPowerSampler();
+
+    // Not whilst running.
+    bool Configure(const LDESeriesLowPowerConfiguration_t& configuration);
+    void SetUplink(const UplinkCallback_t& uplink) { m_Uplink = uplink; }
+
+    // The bursts are taken in the one queue's context, the uplinks in the
+    // other's; the counters, and the report, start afresh.
+    // By default both on gs_MasterEventQueue; a burst sleeps in between
+    // its samples, which is not for the acquisition thread's queue.
+    bool Start(EventQueue* pQueue = &gs_MasterEventQueue,
+               EventQueue* pUplinkQueue = &gs_MasterEventQueue);
+    void Stop();
+
+    bool IsRunning() const { return m_Running.load(); }
+
+    LDESeriesLowPowerReport_t GetReport() const;
+
+    const LDESeriesLowPowerConfiguration_t& GetConfiguration() const { return m_Configuration; }
+
+    uint32_t GetBurstCount() const { return m_BurstCount.load(); }
+    uint32_t GetMissedBurstCount() const { return m_MissedBurstCount.load(); }
+    uint32_t GetFailedSampleCount() const { return m_FailedSampleCount.load(); }
+    uint32_t GetDroppedSampleCount() const { return m_DroppedSampleCount.load(); }
+    uint32_t GetUplinkCount() const { return m_UplinkCount.load(); }
+    uint32_t GetFailedUplinkCount() const { return m_FailedUplinkCount.load(); }
+
+protected:
+    // LowPowerTicker ISR context.
+    void OnWake();
+
+    void OnBurst();
+    void OnUplink();
+
+private:
+    NuerteyLDESeriesDevice&                 m_Device;
+    LDESeriesLowPowerConfiguration_t        m_Configuration;
+    UplinkCallback_t                        m_Uplink;
+    LowPowerTicker                          m_Ticker;
+    LowPowerTimer                           m_BurstTimer;
+    SampleBuffer_t                          m_Samples;
+    std::array<LDESeriesSample_t, N>        m_Batch;            // In the uplink's context only.
+    std::size_t                             m_BatchLength;
+    EventQueue*                             m_pEventQueue;
+    EventQueue*                             m_pUplinkQueue;
+    std::atomic<bool>                       m_Running;
+    std::atomic<bool>                       m_BurstPending;
+    std::atomic<bool>                       m_UplinkPending;
+    uint16_t                                m_BurstsSinceUplink;
+    std::chrono::microseconds               m_TotalBurstDuration;
+#if MBED_CPU_STATS_ENABLED
+    mbed_stats_cpu_t                        m_CPUStatisticsAtStart;
+#endif
+    std::atomic<uint32_t>                   m_BurstCount;
+    std::atomic<uint32_t>                   m_MissedBurstCount; // Still busy with the last.
+    std::atomic<uint32_t>                   m_FailedSampleCount;
+    std::atomic<uint32_t>                   m_DroppedSampleCount;
+    std::atomic<uint32_t>                   m_UplinkCount;
+    std::atomic<uint32_t>                   m_FailedUplinkCount;
+};
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+NuerteyLDESeriesLowPowerSampler<S, A, T, N>::NuerteyLDESeriesLowPowerSampler(NuerteyLDESeriesDevice& device)
+    : m_Device(device)
+    , m_Configuration(DEFAULT_LOW_POWER_CONFIGURATION)
+    , m_Uplink(nullptr)
+    , m_Ticker()
+    , m_BurstTimer()
+    , m_Samples()
+    , m_Batch{}
+    , m_BatchLength(0)
+    , m_pEventQueue(nullptr)
+    , m_pUplinkQueue(nullptr)
+    , m_Running(false)
+    , m_BurstPending(false)
+    , m_UplinkPending(false)
+    , m_BurstsSinceUplink(0)
+    , m_TotalBurstDuration(0)
+#if MBED_CPU_STATS_ENABLED
+    , m_CPUStatisticsAtStart{}
+#endif
+    , m_BurstCount(0)
+    , m_MissedBurstCount(0)
+    , m_FailedSampleCount(0)
+    , m_DroppedSampleCount(0)
+    , m_UplinkCount(0)
+    , m_FailedUplinkCount(0)
+{
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+NuerteyLDESeriesLowPowerSampler<S, A, T, N>::~NuerteyLDESeriesLowPowerSampler()
+{
+    Stop();
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+bool NuerteyLDESeriesLowPowerSampler<S, A, T, N>::Configure(const LDESeriesLowPowerConfiguration_t& configuration)
+{
+    if (m_Running.load())
+    {
+        return false;
+    }
+
+    if ((configuration.samplesPerBurst == 0) || (configuration.burstsPerUplink == 0)
+        || ((static_cast<std::size_t>(configuration.samplesPerBurst) * configuration.burstsPerUplink) > N))
+    {
+        printf("[%s]: Error! An uplink's worth of bursts must fit the buffer of [%u] samples.\n",
+            __PRETTY_FUNCTION__, N);
+        return false;
+    }
+
+    if ((configuration.sampleSpacing * configuration.samplesPerBurst) >= configuration.burstPeriod)
+    {
+        printf("[%s]: Error! A burst would outlast its period.\n", __PRETTY_FUNCTION__);
+        return false;
+    }
+
+    m_Configuration = configuration;
+
+    return true;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+bool NuerteyLDESeriesLowPowerSampler<S, A, T, N>::Start(EventQueue* pQueue, EventQueue* pUplinkQueue)
+{
+    if (!pQueue || !pUplinkQueue || !m_Uplink)
+    {
+        return false;
+    }
+
+    if (m_Running.exchange(true))
+    {
+        return false;
+    }
+
+    m_pEventQueue = pQueue;
+    m_pUplinkQueue = pUplinkQueue;
+    m_BurstsSinceUplink = 0;
+    m_TotalBurstDuration = std::chrono::microseconds(0);
+    m_BurstCount = 0;
+    m_MissedBurstCount = 0;
+    m_FailedSampleCount = 0;
+    m_DroppedSampleCount = 0;
+    m_UplinkCount = 0;
+    m_FailedUplinkCount = 0;
+
+#if MBED_CPU_STATS_ENABLED
+    mbed_stats_cpu_get(&m_CPUStatisticsAtStart);
+#endif
+
+    m_Ticker.attach(mbed::callback(this, &NuerteyLDESeriesLowPowerSampler::OnWake),
+                    std::chrono::duration_cast<std::chrono::microseconds>(m_Configuration.burstPeriod));
+
+    return true;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+void NuerteyLDESeriesLowPowerSampler<S, A, T, N>::Stop()
+{
+    if (m_Running.exchange(false))
+    {
+        // Any burst, or uplink, already posted runs to completion.
+        m_Ticker.detach();
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+LDESeriesLowPowerReport_t NuerteyLDESeriesLowPowerSampler<S, A, T, N>::GetReport() const
+{
+    LDESeriesLowPowerReport_t report{};
+
+    report.bursts  = m_BurstCount.load();
+    report.uplinks = m_UplinkCount.load();
+
+    if (report.bursts > 0)
+    {
+        const float burstDuration = static_cast<float>(m_TotalBurstDuration.count()) / report.bursts;   // us.
+
+        report.burstDuration  = burstDuration / 1000.0f;
+        report.burstDutyCycle = std::min(1.0f, burstDuration
+            / static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(m_Configuration.burstPeriod).count()));
+    }
+
+    // The MCU is presumed deep asleep for all of the time outside bursts.
+    report.averageCurrent = (report.burstDutyCycle * m_Configuration.runCurrent)
+                          + ((1.0f - report.burstDutyCycle) * m_Configuration.deepSleepCurrent);
+
+#if MBED_CPU_STATS_ENABLED
+    mbed_stats_cpu_t statistics{};
+    mbed_stats_cpu_get(&statistics);
+
+    const uint64_t uptime = statistics.uptime - m_CPUStatisticsAtStart.uptime;
+
+    if (uptime > 0)
+    {
+        report.sleepFraction     = static_cast<float>(statistics.sleep_time - m_CPUStatisticsAtStart.sleep_time) / uptime;
+        report.deepSleepFraction = static_cast<float>(statistics.deep_sleep_time - m_CPUStatisticsAtStart.deep_sleep_time) / uptime;
+        report.activeFraction    = std::max(0.0f, 1.0f - report.sleepFraction - report.deepSleepFraction);
+
+        report.averageCurrent = (report.activeFraction * m_Configuration.runCurrent)
+                              + (report.sleepFraction * m_Configuration.sleepCurrent)
+                              + (report.deepSleepFraction * m_Configuration.deepSleepCurrent);
+    }
+#endif
+
+    return report;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+void NuerteyLDESeriesLowPowerSampler<S, A, T, N>::OnWake()
+{
+    // LowPowerTicker ISR context; the blocking SPI exchanges are for the
+    // EventQueue context.
+    if (m_BurstPending.exchange(true))
+    {
+        m_MissedBurstCount++;
+        return;
+    }
+
+    if (!m_pEventQueue->call(this, &NuerteyLDESeriesLowPowerSampler::OnBurst))
+    {
+        m_BurstPending = false;
+        m_MissedBurstCount++;
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+void NuerteyLDESeriesLowPowerSampler<S, A, T, N>::OnBurst()
+{
+    m_BurstTimer.reset();
+    m_BurstTimer.start();
+
+    for (uint16_t i = 0; i < m_Configuration.samplesPerBurst; ++i)
+    {
+        // Asleep, though not deeply, in between.
+        if ((i > 0) && (m_Configuration.sampleSpacing.count() > 0))
+        {
+            ThisThread::sleep_for(m_Configuration.sampleSpacing);
+        }
+
+        // The time, off the cycle counter, stood still whilst deep asleep.
+        g_ClockService.CatchUp();
+
+        const auto sample = m_Device.template GetSample<S, A, T>();
+
+        if (!sample.valid)
+        {
+            m_FailedSampleCount++;
+        }
+        else if (!m_Samples.Push(sample))
+        {
+            m_DroppedSampleCount++;
+        }
+    }
+
+    m_BurstTimer.stop();
+    m_TotalBurstDuration += m_BurstTimer.elapsed_time();
+    m_BurstCount++;
+    m_BurstPending = false;
+
+    if ((++m_BurstsSinceUplink >= m_Configuration.burstsPerUplink) && !m_UplinkPending.exchange(true))
+    {
+        m_BurstsSinceUplink = 0;
+
+        if (!m_pUplinkQueue->call(this, &NuerteyLDESeriesLowPowerSampler::OnUplink))
+        {
+            // Come the next burst, then.
+            m_UplinkPending = false;
+        }
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, IsTemperatureScaleType T, std::size_t N>
+void NuerteyLDESeriesLowPowerSampler<S, A, T, N>::OnUplink()
+{
+    // Topped up behind whatever failed to be delivered last time.
+    m_BatchLength += m_Samples.Pop(std::span<LDESeriesSample_t>(m_Batch).subspan(m_BatchLength));
+
+    if (m_BatchLength > 0)
+    {
+        if (m_Uplink(std::span<const LDESeriesSample_t>(m_Batch.data(), m_BatchLength)))
+        {
+            m_BatchLength = 0;
+            m_UplinkCount++;
+        }
+        else
+        {
+            m_FailedUplinkCount++;
+        }
+    }
+
+    m_UplinkPending = false;
+}
@@ -0,0 +1,426 @@
+/***********************************************************************
+* @file      NuerteyLDESeriesPipeline.h
+*
+*    On-device signal processing stage for the LDE Series sample stream,
+*    to sit between the acquisition ring buffer and the publisher, so that
+*    what goes upstream is the signal rather than every raw reading.
+*
+*    Raw counts are drained from the acquisition ring buffer and, per
+*    reading:
+*
+*    - accumulated into the statistics of the current window, at the full
+*      acquisition rate, so that no transient peak is lost to decimation.
+*      Every statistics window, its min/max/mean/RMS/variance, in Pa, is
+*      pushed as an LDESeriesStatistics_t record;
+*    - decimated, by a CIC or a windowed-sinc FIR decimator, or neither;
+*    - converted to Pa, exactly as ConvertPressure<S, A>() would, bar the
+*      rounding to whole counts that the decimator makes unnecessary;
+*    - smoothed by a first-order IIR low-pass, should a cutoff be set.
+*
+*    The filtered stream is pushed as pressures in Pa and, for the
+*    publisher, as counts at the decimated rate, whichever are enabled.
+*
+*    Usage, decimating 1 kHz by 10 and publishing 1 s statistics windows:
+*
+*    NuerteyLDESeriesPipeline<LDE_S250_B_t, DryAirAtmosphere_t,
+*                             decltype(g_LDESeriesSampler)::SampleBuffer_t>
+*        pipeline(g_LDESeriesSampler.GetSampleBuffer());
+*
+*    pipeline.Configure({DecimationFilter_t::CIC, 10, 20.0f, 1000, false, true});
+*    pipeline.Start();
+*
+*    NuerteyTelemetryPublisher<decltype(client), decltype(pipeline)::CountBuffer_t>
+*        publisher(client, pipeline.GetCountBuffer(), "lde/pressure",
+*                  TelemetryEncoding_t::BINARY, pipeline.GetOutputPeriod());
+*
+* @brief
+*
+* @note    Decimating counts and then converting to Pa is the same as
+*          converting and then decimating, the conversion being a mere
+*          scaling. Hence the CIC may stay in integer arithmetic, and the
+*          statistics too, until a window is complete.
+*
+*          By default, Start() schedules the processing on the dedicated,
+*          high-priority gs_AcquisitionEventQueue, so that it keeps up
+*          with the sampler regardless of the network traffic on
+*          gs_MasterEventQueue; the outputs' consumers may stay there.
+*          A scheduled pass processes MAXIMUM_READINGS_PER_PASS at most,
+*          leaving any further backlog to the next, so that it never
+*          holds that thread for long above the network stack.
+*
+* @warning The pipeline is the acquisition ring buffer's one consumer;
+*          each enabled output must, in turn, have its one consumer, or
+*          it fills up and its readings are dropped, and counted.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <limits>
+#include "NuerteyLDESeriesDevice.h"
+#include "SignalProcessing.h"
+#include "SPSCRingBuffer.h"
+
+// Powers of two. The filtered stream, at the decimated rate, and some
+// 16 windows' worth of statistics, give the consumers plenty of slack.
+constexpr std::size_t DEFAULT_PIPELINE_OUTPUT_CAPACITY     = 256;
+constexpr std::size_t DEFAULT_PIPELINE_STATISTICS_CAPACITY = 16;
+
+constexpr std::size_t CIC_DECIMATOR_ORDER = 3;
+constexpr std::size_t FIR_DECIMATOR_TAPS  = 32;
+
+static const uint32_t SIGNAL_PROCESSING_PERIOD_MSECS = 20;
+
+enum class DecimationFilter_t : uint8_t
+{
+    NONE,
+    CIC,
+    FIR
+};
+
+struct LDESeriesPipelineConfiguration_t
+{
+    DecimationFilter_t filter;
+    uint16_t           decimation;        // Ratio; ignored for NONE.
+    float              lowPassCutoff;     // Hz at the decimated rate; 0 to disable.
+    uint32_t           statisticsWindow;  // Readings per window, at the full rate; 0 to disable.
+    bool               pressureOutput;
+    bool               countOutput;
+};
+
+inline constexpr LDESeriesPipelineConfiguration_t DEFAULT_PIPELINE_CONFIGURATION{
+    DecimationFilter_t::CIC, 10, 0.0f, 1000, true, false};
+
+struct LDESeriesStatistics_t
+{
+    UTCTimestamp_t utc;       // Of the window's first reading.
+    uint32_t       count;
+    float          minimum;   // Pa.
+    float          maximum;
+    float          mean;
+    float          rms;
+    float          variance;  // Pa².
+};
+
+inline constexpr auto LDE_SERIES_STATISTICS_SCHEMA = std::make_tuple(
+    JSONField_t<LDESeriesStatistics_t, UTCTimestamp_t>{"utc", &LDESeriesStatistics_t::utc},
+    JSONField_t<LDESeriesStatistics_t, uint32_t>{"n",         &LDESeriesStatistics_t::count},
+    JSONField_t<LDESeriesStatistics_t, float>{"min",          &LDESeriesStatistics_t::minimum},
+    JSONField_t<LDESeriesStatistics_t, float>{"max",          &LDESeriesStatistics_t::maximum},
+    JSONField_t<LDESeriesStatistics_t, float>{"mean",         &LDESeriesStatistics_t::mean},
+    JSONField_t<LDESeriesStatistics_t, float>{"rms",          &LDESeriesStatistics_t::rms},
+    JSONField_t<LDESeriesStatistics_t, float>{"var",          &LDESeriesStatistics_t::variance});
+
+static_assert(IsPlainJSONSchema(LDE_SERIES_STATISTICS_SCHEMA));
+static_assert(std::is_trivially_copyable_v<LDESeriesStatistics_t>);
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B,
+          std::size_t N = DEFAULT_PIPELINE_OUTPUT_CAPACITY,
+          std::size_t W = DEFAULT_PIPELINE_STATISTICS_CAPACITY>
+class NuerteyLDESeriesPipeline
+{
+    // Raw counts are drained this many at a time.
+    static constexpr std::size_t BLOCK_SIZE = 64;
+
+    static constexpr float COEFFICIENT = PressureConversion<S, A>::COEFFICIENT;
+
+public:
+    // Per scheduled pass; at SIGNAL_PROCESSING_PERIOD_MSECS, some 25 kHz.
+    static constexpr std::size_t MAXIMUM_READINGS_PER_PASS = 8 * BLOCK_SIZE;
+
+public:
+    using PressureBuffer_t   = SPSCRingBuffer<float, N>;
+    using CountBuffer_t      = SPSCRingBuffer<int16_t, N>;
+    using StatisticsBuffer_t = SPSCRingBuffer<LDESeriesStatistics_t, W>;
+
+    explicit NuerteyLDESeriesPipeline(B& source,
+                                      const std::chrono::microseconds& samplePeriod
+                                          = std::chrono::microseconds(CONTINUOUS_ACQUISITION_PERIOD_USECS));
+
+    NuerteyLDESeriesPipeline(const NuerteyLDESeriesPipeline&) = delete;
+    NuerteyLDESeriesPipeline& operator=(const NuerteyLDESeriesPipeline&) = delete;
+
+    virtual ~NuerteyLDESeriesPipeline();
+
+    // Resets the filters and the window underway; not whilst running.
+    bool Configure(const LDESeriesPipelineConfiguration_t& configuration);
+
+    bool Start(const std::chrono::milliseconds& period
+                   = std::chrono::milliseconds(SIGNAL_PROCESSING_PERIOD_MSECS),
+               EventQueue* pQueue = &gs_AcquisitionEventQueue);
+    void Stop();
+
+    // Drains and processes whatever the ring buffer holds, up to maximum
+    // readings. Returns the number of raw readings processed. To be
+    // called in the one context.
+    std::size_t Process(const std::size_t& maximum = std::numeric_limits<std::size_t>::max());
+
+    // Of the filtered stream; for the publisher's sample period.
+    std::chrono::microseconds GetOutputPeriod() const { return m_SamplePeriod * GetDecimation(); }
+    uint16_t GetDecimation() const;
+
+    PressureBuffer_t&   GetPressureBuffer() { return m_Pressures; }
+    CountBuffer_t&      GetCountBuffer() { return m_Counts; }
+    StatisticsBuffer_t& GetStatisticsBuffer() { return m_Statistics; }
+
+    const LDESeriesPipelineConfiguration_t& GetConfiguration() const { return m_Configuration; }
+
+    uint32_t GetProcessedReadingCount() const { return m_ProcessedReadingCount; }
+    uint32_t GetOutputCount() const { return m_OutputCount; }
+    uint32_t GetDroppedOutputCount() const { return m_DroppedOutputCount; }
+    uint32_t GetDroppedStatisticsCount() const { return m_DroppedStatisticsCount; }
+
+protected:
+    void OnSchedule() { Process(MAXIMUM_READINGS_PER_PASS); }
+
+    void Accumulate(const int16_t& counts, const UTCTimestamp_t& utc);
+    void Decimate(const int16_t& counts);
+    void Output(const float& counts);
+
+    static int16_t ToCounts(const float& pressure);
+
+private:
+    B&                                      m_Source;
+    std::chrono::microseconds               m_SamplePeriod;
+    LDESeriesPipelineConfiguration_t        m_Configuration;
+    CICDecimator<CIC_DECIMATOR_ORDER>       m_CICDecimator;
+    FIRDecimator<FIR_DECIMATOR_TAPS>        m_FIRDecimator;
+    FirstOrderLowPass                       m_LowPass;
+    WindowStatistics                        m_Window;
+    UTCTimestamp_t                          m_WindowStart;
+    PressureBuffer_t                        m_Pressures;
+    CountBuffer_t                           m_Counts;
+    StatisticsBuffer_t                      m_Statistics;
+    EventQueue*                             m_pEventQueue;
+    int                                     m_EventIdentifier;
+    uint32_t                                m_ProcessedReadingCount;
+    uint32_t                                m_OutputCount;
+    uint32_t                                m_DroppedOutputCount;
+    uint32_t                                m_DroppedStatisticsCount;
+};
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+NuerteyLDESeriesPipeline<S, A, B, N, W>::NuerteyLDESeriesPipeline(B& source,
+                                                                  const std::chrono::microseconds& samplePeriod)
+    : m_Source(source)
+    , m_SamplePeriod(samplePeriod)
+    , m_Configuration{}
+    , m_CICDecimator()
+    , m_FIRDecimator()
+    , m_LowPass()
+    , m_Window()
+    , m_WindowStart()
+    , m_Pressures()
+    , m_Counts()
+    , m_Statistics()
+    , m_pEventQueue(nullptr)
+    , m_EventIdentifier(0)
+    , m_ProcessedReadingCount(0)
+    , m_OutputCount(0)
+    , m_DroppedOutputCount(0)
+    , m_DroppedStatisticsCount(0)
+{
+    Configure(DEFAULT_PIPELINE_CONFIGURATION);
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+NuerteyLDESeriesPipeline<S, A, B, N, W>::~NuerteyLDESeriesPipeline()
+{
+    Stop();
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+bool NuerteyLDESeriesPipeline<S, A, B, N, W>::Configure(const LDESeriesPipelineConfiguration_t& configuration)
+{
+    if (m_EventIdentifier)
+    {
+        return false;
+    }
+
+    if ((configuration.filter != DecimationFilter_t::NONE) && (configuration.decimation == 0))
+    {
+        printf("[%s]: Error! A decimation ratio of zero is meaningless.\n", __PRETTY_FUNCTION__);
+        return false;
+    }
+
+    m_Configuration = configuration;
+
+    m_CICDecimator.Configure((m_Configuration.filter == DecimationFilter_t::CIC) ? m_Configuration.decimation : 1);
+    m_FIRDecimator.Configure((m_Configuration.filter == DecimationFilter_t::FIR) ? m_Configuration.decimation : 1);
+
+    // At the decimated rate, at which it runs.
+    const float outputRate = 1'000'000.0f / static_cast<float>(GetOutputPeriod().count());
+    m_LowPass.Configure(m_Configuration.lowPassCutoff, outputRate);
+
+    m_Window.Reset();
+
+    return true;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+bool NuerteyLDESeriesPipeline<S, A, B, N, W>::Start(const std::chrono::milliseconds& period, EventQueue* pQueue)
+{
+    if (m_EventIdentifier || !pQueue)
+    {
+        return false;
+    }
+
+    m_pEventQueue = pQueue;
+    m_EventIdentifier = m_pEventQueue->call_every(period, this, &NuerteyLDESeriesPipeline::OnSchedule);
+
+    return (m_EventIdentifier != 0);
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+void NuerteyLDESeriesPipeline<S, A, B, N, W>::Stop()
+{
+    if (m_EventIdentifier)
+    {
+        m_pEventQueue->cancel(m_EventIdentifier);
+        m_EventIdentifier = 0;
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+uint16_t NuerteyLDESeriesPipeline<S, A, B, N, W>::GetDecimation() const
+{
+    return (m_Configuration.filter == DecimationFilter_t::CIC) ? m_CICDecimator.GetDecimation()
+         : (m_Configuration.filter == DecimationFilter_t::FIR) ? m_FIRDecimator.GetDecimation() : 1;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+std::size_t NuerteyLDESeriesPipeline<S, A, B, N, W>::Process(const std::size_t& maximum)
+{
+    std::array<int16_t, BLOCK_SIZE> readings{};
+    std::size_t processed = 0;
+
+    while (!m_Source.Empty() && (processed < maximum))
+    {
+        // The newest reading in the ring buffer was taken about now.
+        const auto backlog = static_cast<int64_t>(m_Source.Size());
+        const auto now     = UTCTimestamp_t(MicroSecs_t(g_ClockService.Now() / 1000));
+        auto       utc     = now - (m_SamplePeriod * (std::max<int64_t>(backlog, 1) - 1));
+
+        const auto count = m_Source.Pop(std::span<int16_t>(readings).first(
+                               std::min(readings.size(), maximum - processed)));
+
+        for (std::size_t i = 0; i < count; ++i, utc += m_SamplePeriod)
+        {
+            Accumulate(readings[i], utc);
+            Decimate(readings[i]);
+        }
+
+        processed += count;
+    }
+
+    m_ProcessedReadingCount += processed;
+    return processed;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+void NuerteyLDESeriesPipeline<S, A, B, N, W>::Accumulate(const int16_t& counts, const UTCTimestamp_t& utc)
+{
+    if (m_Configuration.statisticsWindow == 0)
+    {
+        return;
+    }
+
+    if (m_Window.GetCount() == 0)
+    {
+        m_WindowStart = utc;
+    }
+
+    m_Window.Add(counts);
+
+    if (m_Window.GetCount() < m_Configuration.statisticsWindow)
+    {
+        return;
+    }
+
+    // Only now, the once per window, into Pa. COEFFICIENT is positive,
+    // so the minimum stays the minimum.
+    const LDESeriesStatistics_t statistics{
+        m_WindowStart,
+        m_Window.GetCount(),
+        PressureConversion<S, A>::ToFloat(m_Window.GetMinimum()),
+        PressureConversion<S, A>::ToFloat(m_Window.GetMaximum()),
+        static_cast<float>(m_Window.GetMean() * COEFFICIENT),
+        static_cast<float>(m_Window.GetRootMeanSquare() * COEFFICIENT),
+        static_cast<float>(m_Window.GetVariance() * COEFFICIENT * COEFFICIENT)};
+
+    if (!m_Statistics.Push(statistics))
+    {
+        m_DroppedStatisticsCount++;
+    }
+
+    m_Window.Reset();
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+void NuerteyLDESeriesPipeline<S, A, B, N, W>::Decimate(const int16_t& counts)
+{
+    float decimated = 0.0f;
+
+    switch (m_Configuration.filter)
+    {
+        case DecimationFilter_t::CIC:
+            if (m_CICDecimator.Push(counts, decimated))
+            {
+                Output(decimated);
+            }
+            break;
+
+        case DecimationFilter_t::FIR:
+            if (m_FIRDecimator.Push(static_cast<float>(counts), decimated))
+            {
+                Output(decimated);
+            }
+            break;
+
+        default:
+            Output(static_cast<float>(counts));
+            break;
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+void NuerteyLDESeriesPipeline<S, A, B, N, W>::Output(const float& counts)
+{
+    const float pressure = m_LowPass.Filter(counts * COEFFICIENT);
+
+    bool dropped = false;
+
+    if (m_Configuration.pressureOutput)
+    {
+        dropped |= !m_Pressures.Push(pressure);
+    }
+
+    if (m_Configuration.countOutput)
+    {
+        dropped |= !m_Counts.Push(ToCounts(pressure));
+    }
+
+    if (dropped)
+    {
+        m_DroppedOutputCount++;
+    }
+    else
+    {
+        m_OutputCount++;
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename B, std::size_t N, std::size_t W>
+int16_t NuerteyLDESeriesPipeline<S, A, B, N, W>::ToCounts(const float& pressure)
+{
+    // Back into the publisher's wire units, rounded and saturated.
+    constexpr float INVERSE_COEFFICIENT = 1.0f / COEFFICIENT;
+
+    return static_cast<int16_t>(std::clamp(std::lround(pressure * INVERSE_COEFFICIENT),
+                                           static_cast<long>(INT16_MIN),
+                                           static_cast<long>(INT16_MAX)));
+}
@@ -0,0 +1,304 @@
+/***********************************************************************
+* @file      NuerteyLDESeriesSampler.h
+*
+*    High-rate continuous acquisition engine for the First Sensor AG LDE
+*    Series of digital low differential pressure sensors.
+*
+*    A Ticker fires at the configured rate and, from its ISR, kicks off
+*    an asynchronous read sequence on the device. The completion IRQ of
+*    that transfer deserializes the response frame and pushes the raw
+*    two's complement result into a lock-free single-producer/single-
+*    consumer ring buffer. Consumer threads drain the buffer at leisure
+*    and without ever contending with either interrupt.
+*
+* @brief
+*
+* @note    The blocking FullDuplexTransfer()/SequencedTransfer() paths
+*          mutex lock the SPI bus and so cannot be used from the Ticker
+*          ISR; their asynchronous counterpart, which clocks out the
+*          very same command sequence, is used instead.
+*
+*          Temperature compensation, should it be set, is likewise applied
+*          in the completion IRQ, so that every consumer downstream gets
+*          corrected counts. Every so many ticks, the tick reads the
+*          on-chip temperature instead, which selects the correction
+*          table entry that then holds until the next such reading; the
+*          per-sample cost is thus the one multiply-add.
+*
+* @warning Should a tick fire whilst the previous transfer is still in
+*          flight, that tick is skipped and counted as an overrun. A
+*          full ring buffer likewise counts a dropped sample.
+*
+*          The pressure reading missed on a temperature tick is stood in
+*          for by the previous one, so that the readings stay evenly
+*          spaced in time, as the consumers assume them to be.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include "NuerteyLDESeriesDevice.h"
+#include "SPSCRingBuffer.h"
+
+#if DEVICE_SPI_ASYNCH
+
+// Power of two; at 1 kHz, this is about one second of history.
+constexpr std::size_t DEFAULT_SAMPLE_BUFFER_CAPACITY = 1024;
+
+// Ticks per temperature reading; at 1 kHz, once a second.
+constexpr uint32_t DEFAULT_TEMPERATURE_DECIMATION = 1000;
+
+template <std::size_t N = DEFAULT_SAMPLE_BUFFER_CAPACITY>
+class NuerteyLDESeriesSampler
+{
+public:
+    using SampleBuffer_t = SPSCRingBuffer<int16_t, N>;
+
+    explicit NuerteyLDESeriesSampler(NuerteyLDESeriesDevice& device);
+
+    NuerteyLDESeriesSampler(const NuerteyLDESeriesSampler&) = delete;
+    NuerteyLDESeriesSampler& operator=(const NuerteyLDESeriesSampler&) = delete;
+
+    virtual ~NuerteyLDESeriesSampler();
+
+    bool Start(const std::chrono::microseconds& period
+                   = std::chrono::microseconds(CONTINUOUS_ACQUISITION_PERIOD_USECS),
+               const LDESeriesReadSequence_t& sequence = PRESSURE_READ_SEQUENCE);
+    void Stop();
+
+    // Not whilst running. The table, being in flash, outlives the sampler.
+    template <std::size_t M>
+    bool SetTemperatureCompensation(const TemperatureCompensationTable_t<M>& table,
+                                    const uint32_t& decimation = DEFAULT_TEMPERATURE_DECIMATION);
+    bool ClearTemperatureCompensation();
+
+    bool IsRunning() const { return m_Running.load(); }
+    bool IsCompensating() const { return (m_TemperatureDecimation > 0); }
+
+    // That of the correction in effect.
+    int16_t GetTemperatureCounts() const { return m_TemperatureCounts.load(); }
+
+    // Consumer side; the one consumer context only.
+    std::size_t Drain(std::span<int16_t> samples) { return m_Samples.Pop(samples); }
+    SampleBuffer_t& GetSampleBuffer() { return m_Samples; }
+
+    uint32_t GetSampleCount() const { return m_SampleCount.load(); }
+    uint32_t GetDroppedSampleCount() const { return m_DroppedSampleCount.load(); }
+    uint32_t GetOverrunCount() const { return m_OverrunCount.load(); }
+    uint32_t GetTemperatureReadingCount() const { return m_TemperatureReadingCount.load(); }
+
+protected:
+    void OnTick();
+    void OnFrame(SPIFrame_t frame);
+
+    void Push(const int16_t& counts);
+
+private:
+    NuerteyLDESeriesDevice&            m_Device;
+    Ticker                             m_Ticker;
+    LDESeriesReadSequence_t            m_Sequence;
+    SampleBuffer_t                     m_Samples;
+    std::atomic<bool>                  m_Running;
+    std::atomic<uint32_t>              m_SampleCount;
+    std::atomic<uint32_t>              m_DroppedSampleCount;
+    std::atomic<uint32_t>              m_OverrunCount;
+    TemperatureCompensationView_t      m_Compensation;
+    uint32_t                           m_TemperatureDecimation;     // 0, should there be no compensation.
+    uint32_t                           m_TicksToTemperature;
+    std::atomic<bool>                  m_TemperatureFrame;          // Of the transfer in flight.
+    const TemperatureCompensationEntry_t* m_pCorrection;            // nullptr until a temperature is read.
+    int16_t                            m_LastCounts;
+    bool                               m_HasLastCounts;
+    std::atomic<int16_t>               m_TemperatureCounts;
+    std::atomic<uint32_t>              m_TemperatureReadingCount;
+};
+
+template <std::size_t N>
+NuerteyLDESeriesSampler<N>::NuerteyLDESeriesSampler(NuerteyLDESeriesDevice& device)
+    : m_Device(device)
+    , m_Ticker()
+    , m_Sequence(PRESSURE_READ_SEQUENCE)
+    , m_Samples()
+    , m_Running(false)
+    , m_SampleCount(0)
+    , m_DroppedSampleCount(0)
+    , m_OverrunCount(0)
+    , m_Compensation{}
+    , m_TemperatureDecimation(0)
+    , m_TicksToTemperature(0)
+    , m_TemperatureFrame(false)
+    , m_pCorrection(nullptr)
+    , m_LastCounts(0)
+    , m_HasLastCounts(false)
+    , m_TemperatureCounts(0)
+    , m_TemperatureReadingCount(0)
+{
+}
+
+template <std::size_t N>
+NuerteyLDESeriesSampler<N>::~NuerteyLDESeriesSampler()
+{
+    Stop();
+}
+
+template <std::size_t N>
+bool NuerteyLDESeriesSampler<N>::Start(const std::chrono::microseconds& period,
+                                       const LDESeriesReadSequence_t& sequence)
+{
+    if (period < std::chrono::microseconds(MINIMUM_ACQUISITION_PERIOD_USECS))
+    {
+        printf("[%s]: Error! Requested acquisition period [%lld us] is shorter \
+            than the supported minimum.\n",
+            __PRETTY_FUNCTION__, period.count());
+        return false;
+    }
+
+    if (m_Running.exchange(true))
+    {
+        return false;
+    }
+
+    m_Sequence = sequence;
+
+    // The correction is selected straightaway, on the very first tick.
+    m_TicksToTemperature = 0;
+    m_pCorrection = nullptr;
+    m_HasLastCounts = false;
+
+    m_Ticker.attach(mbed::callback(this, &NuerteyLDESeriesSampler::OnTick), period);
+
+    return true;
+}
+
+template <std::size_t N>
+void NuerteyLDESeriesSampler<N>::Stop()
+{
+    if (m_Running.exchange(false))
+    {
+        // Any transfer still in flight completes into the buffer as usual.
+        m_Ticker.detach();
+    }
+}
+
+template <std::size_t N>
+template <std::size_t M>
+bool NuerteyLDESeriesSampler<N>::SetTemperatureCompensation(const TemperatureCompensationTable_t<M>& table,
+                                                            const uint32_t& decimation)
+{
+    if (m_Running.load() || (decimation == 0))
+    {
+        return false;
+    }
+
+    m_Compensation = table.View();
+    m_TemperatureDecimation = decimation;
+
+    return true;
+}
+
+template <std::size_t N>
+bool NuerteyLDESeriesSampler<N>::ClearTemperatureCompensation()
+{
+    if (m_Running.load())
+    {
+        return false;
+    }
+
+    m_TemperatureDecimation = 0;
+    m_pCorrection = nullptr;
+
+    return true;
+}
+
+template <std::size_t N>
+void NuerteyLDESeriesSampler<N>::OnTick()
+{
+    // Ticker ISR context.
+    const bool temperature = (m_TemperatureDecimation > 0) && (m_TicksToTemperature == 0);
+
+    m_TemperatureFrame.store(temperature);
+
+    // A nullptr EventQueue has the frame delivered straight from the SPI
+    // completion IRQ, bypassing any queue latency.
+    if (!m_Device.AcquireFrameAsync(temperature ? TEMPERATURE_READ_SEQUENCE : m_Sequence,
+                                    mbed::callback(this, &NuerteyLDESeriesSampler::OnFrame),
+                                    nullptr))
+    {
+        // The temperature is then read on the next tick.
+        m_OverrunCount++;
+        return;
+    }
+
+    if (m_TemperatureDecimation > 0)
+    {
+        m_TicksToTemperature = (temperature ? m_TemperatureDecimation : m_TicksToTemperature) - 1;
+    }
+}
+
+// A line at rest, reading 0 raw counts, at 50 °C, where the correction
+// is (0.995, -8): the one quiescent window's residual, -8, taken back
+// through the gain and into the offset, nulls the output.
+static_assert([]()
+{
+    constexpr TemperatureCompensationEntry_t correction{0.995f, -8.0f};
+
+    const int16_t before = SaturateToCounts(correction.Apply(NuerteyLDESeriesAutoZero::Subtract(0, 0)));
+    const auto    offset = static_cast<int16_t>(NuerteyLDESeriesAutoZero::Residual(before, 1, correction.gain));
+
+    return (before == -8) 
+        && (SaturateToCounts(correction.Apply(NuerteyLDESeriesAutoZero::Subtract(0, offset))) == 0);
+}());
+
+template <std::size_t N>
+void NuerteyLDESeriesSampler<N>::OnFrame(SPIFrame_t frame)
+{
+    // SPI IRQ context.
+    const int16_t counts = Deserialize(frame);
+
+    if (m_TemperatureFrame.load())
+    {
+        m_pCorrection = &m_Compensation.Lookup(counts);
+        m_TemperatureCounts.store(counts);
+        m_TemperatureReadingCount++;
+
+        if (m_HasLastCounts)
+        {
+            Push(m_LastCounts);
+        }
+        return;
+    }
+
+    // Zeroed first, the offset being that of the raw readings; but
+    // watched for quiescence as output, so that the offset tracked nulls
+    // the compensation's offset as well.
+    const int16_t zeroed = m_Device.ZeroPressure(counts);
+
+    m_LastCounts = m_pCorrection ? SaturateToCounts(m_pCorrection->Apply(zeroed)) : zeroed;
+    m_HasLastCounts = true;
+
+    if (auto pAutoZero = m_Device.GetAutoZero())
+    {
+        pAutoZero->Observe(m_LastCounts, m_pCorrection ? m_pCorrection->gain : 1.0f);
+    }
+
+    Push(m_LastCounts);
+}
+
+template <std::size_t N>
+void NuerteyLDESeriesSampler<N>::Push(const int16_t& counts)
+{
+    if (m_Samples.Push(counts))
+    {
+        m_SampleCount++;
+    }
+    else
+    {
+        m_DroppedSampleCount++;
+    }
+}
+
+#endif
@@ -0,0 +1,616 @@
+/***********************************************************************
+* @file      NuerteyLDESeriesTrigger.h
+*
+*    Event-triggered burst capture for the LDE Series sample stream, for
+*    when but the pressure excursions, e.g. a clogging filter or a door
+*    being opened, are of interest, and yet those are wanted at the full
+*    acquisition rate.
+*
+*    The readings are drained from the acquisition ring buffer into a
+*    pre-trigger history of the last H readings, continuously overwritten,
+*    and each reading is checked against whichever trigger conditions are
+*    enabled:
+*
+*    - LEVEL, a crossing of the upper threshold upwards, or of the lower
+*      threshold downwards;
+*    - RATE_OF_CHANGE, of a magnitude of at least rateOfChange Pa/s, as
+*      measured across the last rateSpan readings;
+*    - DEVIATION, by at least deviation Pa either way, from a rolling
+*      baseline, i.e. an exponential average of time constant
+*      baselineTimeConstant, frozen whilst a burst is being captured.
+*
+*    On a trigger, the history is frozen along with the next T readings,
+*    the trigger reading included, into a burst, which is then published
+*    as the one telemetry batch (see TelemetryEncoding.h) on the topic.
+*    A JSON record of the trigger (LDESeriesTriggerEvent_t) is published
+*    beforehand on the event topic, if any, of the same sequence number.
+*
+*    Usage, given say an MQTT::Client<MQTTNetwork, Countdown> client:
+*
+*    NuerteyLDESeriesTrigger<LDE_S250_B_t, DryAirAtmosphere_t, decltype(client),
+*                            decltype(g_LDESeriesSampler)::SampleBuffer_t>
+*        trigger(client, g_LDESeriesSampler.GetSampleBuffer(), "lde/burst", "lde/trigger");
+*
+*    trigger.Configure({true, 100.0f, -100.0f, 0.0f, 10, 20.0f, 30.0f, 5s});
+*    trigger.Start();
+*
+* @brief
+*
+* @note    All thresholds are converted into counts once, on Configure(),
+*          so that checking a reading costs but a few float compares.
+*
+*          A burst waits, frozen, for as long as the session is down;
+*          triggers meanwhile are counted as missed, though the history
+*          carries on being kept up to date.
+*
+* @warning The trigger engine is the ring buffer's one consumer; it is an
+*          alternative to the publisher or the pipeline, not an addition.
+*
+*          The client's MAX_MQTT_PACKET_SIZE must accommodate a burst,
+*          i.e. TelemetryBatchCapacity(H + T), plus the topic.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <limits>
+#include "NuerteyLDESeriesDevice.h"
+#include "TelemetryEncoding.h"
+#include "SPSCRingBuffer.h"
+
+// At 1 kHz, a quarter of a second either side of the trigger.
+constexpr std::size_t DEFAULT_PRE_TRIGGER_READINGS  = 256;
+constexpr std::size_t DEFAULT_POST_TRIGGER_READINGS = 256;
+
+static const uint32_t TRIGGER_PROCESSING_PERIOD_MSECS = 20;
+
+enum class TriggerCause_t : uint8_t
+{
+    LEVEL,
+    RATE_OF_CHANGE,
+    DEVIATION
+};
+
+constexpr const char* ToString(const TriggerCause_t& cause)
+{
+    return (cause == TriggerCause_t::LEVEL)          ? "level"
+         : (cause == TriggerCause_t::RATE_OF_CHANGE) ? "rate"
+         : (cause == TriggerCause_t::DEVIATION)      ? "deviation" : "unknown";
+}
+
+enum class TriggerState_t : uint8_t
+{
+    ARMED,
+    CAPTURING,
+    FROZEN      // Until published.
+};
+
+struct LDESeriesTriggerConfiguration_t
+{
+    bool                      levelEnabled;
+    float                     levelHigh;             // Pa.
+    float                     levelLow;              // Pa.
+    float                     rateOfChange;          // Pa/s; 0 to disable.
+    uint16_t                  rateSpan;              // Readings; fewer than the pre-trigger history.
+    float                     deviation;             // Pa; 0 to disable.
+    float                     baselineTimeConstant;  // s.
+    std::chrono::milliseconds holdoff;               // From the end of one burst to the next trigger.
+};
+
+// All conditions disabled.
+inline constexpr LDESeriesTriggerConfiguration_t DEFAULT_TRIGGER_CONFIGURATION{
+    false, 0.0f, 0.0f, 0.0f, 10, 0.0f, 10.0f, std::chrono::milliseconds(1000)};
+
+struct LDESeriesTriggerEvent_t
+{
+    uint32_t       sequenceNumber;  // As of the burst's batch.
+    UTCTimestamp_t utc;             // Of the trigger reading.
+    uint32_t       timestamp;       // ms since boot, of the burst's first reading.
+    const char*    cause;
+    float          pressure;        // Pa, of the trigger reading.
+    uint32_t       preTrigger;      // Readings of the burst before the trigger reading.
+    uint32_t       length;
+};
+
+inline constexpr auto LDE_SERIES_TRIGGER_EVENT_SCHEMA = std::make_tuple(
+    JSONField_t<LDESeriesTriggerEvent_t, uint32_t>{"seq",          &LDESeriesTriggerEvent_t::sequenceNumber},
+    JSONField_t<LDESeriesTriggerEvent_t, UTCTimestamp_t>{"utc",    &LDESeriesTriggerEvent_t::utc},
+    JSONField_t<LDESeriesTriggerEvent_t, uint32_t>{"t",            &LDESeriesTriggerEvent_t::timestamp},
+    JSONField_t<LDESeriesTriggerEvent_t, const char*>{"cause",     &LDESeriesTriggerEvent_t::cause},
+    JSONField_t<LDESeriesTriggerEvent_t, float>{"p",               &LDESeriesTriggerEvent_t::pressure},
+    JSONField_t<LDESeriesTriggerEvent_t, uint32_t>{"pre",          &LDESeriesTriggerEvent_t::preTrigger},
+    JSONField_t<LDESeriesTriggerEvent_t, uint32_t>{"n",            &LDESeriesTriggerEvent_t::length});
+
+static_assert(IsPlainJSONSchema(LDE_SERIES_TRIGGER_EVENT_SCHEMA));
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B,
+          std::size_t H = DEFAULT_PRE_TRIGGER_READINGS,
+          std::size_t T = DEFAULT_POST_TRIGGER_READINGS>
+class NuerteyLDESeriesTrigger
+{
+    static_assert((H > 0) && (T > 0));
+
+    // Raw counts are drained this many at a time.
+    static constexpr std::size_t BLOCK_SIZE = 64;
+
+    static constexpr std::size_t BURST_CAPACITY   = H + T;
+    static constexpr std::size_t PAYLOAD_CAPACITY = TelemetryBatchCapacity(BURST_CAPACITY);
+    static constexpr std::size_t EVENT_CAPACITY   = 160;
+
+    static constexpr float COEFFICIENT = PressureConversion<S, A>::COEFFICIENT;
+
+public:
+    NuerteyLDESeriesTrigger(C& client,
+                            B& source,
+                            const char* pTopic,
+                            const char* pEventTopic = nullptr,
+                            const TelemetryEncoding_t& encoding = TelemetryEncoding_t::BINARY,
+                            const std::chrono::microseconds& samplePeriod
+                                = std::chrono::microseconds(CONTINUOUS_ACQUISITION_PERIOD_USECS),
+                            const MQTT::QoS& qos = MQTT::QOS1,
+                            NuerteyConnectionManager* pConnectionManager = nullptr);
+
+    NuerteyLDESeriesTrigger(const NuerteyLDESeriesTrigger&) = delete;
+    NuerteyLDESeriesTrigger& operator=(const NuerteyLDESeriesTrigger&) = delete;
+
+    virtual ~NuerteyLDESeriesTrigger();
+
+    // Re-arms, discarding any burst underway; not whilst running.
+    bool Configure(const LDESeriesTriggerConfiguration_t& configuration);
+
+    bool Start(const std::chrono::milliseconds& period
+                   = std::chrono::milliseconds(TRIGGER_PROCESSING_PERIOD_MSECS),
+               EventQueue* pQueue = &gs_MasterEventQueue);
+    void Stop();
+
+    // Drains and checks whatever the ring buffer holds. Returns the number
+    // of readings processed. To be called in the one context.
+    std::size_t Process();
+
+    // Publishes the frozen burst, if any, and re-arms on success.
+    bool Publish();
+
+    // Per the connection manager when given one, else per the client.
+    bool IsSessionUp();
+
+    TriggerState_t GetState() const { return m_State; }
+    const LDESeriesTriggerConfiguration_t& GetConfiguration() const { return m_Configuration; }
+
+    // The frozen burst, oldest reading first; empty unless FROZEN.
+    std::span<const int16_t> GetBurst() const;
+    const LDESeriesTriggerEvent_t& GetLastEvent() const { return m_Event; }
+
+    uint32_t GetTriggerCount() const { return m_TriggerCount; }
+    uint32_t GetMissedTriggerCount() const { return m_MissedTriggerCount; }
+    uint32_t GetPublishedBurstCount() const { return m_PublishedBurstCount; }
+    uint32_t GetPublishFailureCount() const { return m_PublishFailureCount; }
+
+protected:
+    void OnSchedule();
+
+    // Returns true, and the cause, should the reading trigger.
+    bool Check(const int16_t& counts, TriggerCause_t& cause);
+    void Trigger(const int16_t& counts, const TriggerCause_t& cause,
+                 const int64_t& uptime, const UTCTimestamp_t& utc);
+    void Remember(const int16_t& counts);
+
+    bool PublishMessage(const char* pTopic, MQTT::Message& message);
+
+private:
+    C&                                  m_Client;
+    B&                                  m_Source;
+    NuerteyConnectionManager*           m_pConnectionManager;
+    const char*                         m_pTopic;
+    const char*                         m_pEventTopic;
+    TelemetryEncoding_t                 m_Encoding;
+    std::chrono::microseconds           m_SamplePeriod;
+    MQTT::QoS                           m_QoS;
+    LDESeriesTriggerConfiguration_t     m_Configuration;
+
+    // The configuration, in counts.
+    float                               m_LevelHigh;
+    float                               m_LevelLow;
+    float                               m_RateThreshold;      // Per rateSpan readings.
+    float                               m_DeviationThreshold;
+    float                               m_BaselineAlpha;
+
+    TriggerState_t                      m_State;
+    float                               m_Baseline;
+    bool                                m_BaselinePrimed;
+    std::array<int16_t, H>              m_History;
+    std::size_t                         m_HistoryHead;        // Where the next reading goes.
+    std::size_t                         m_HistoryCount;
+    std::array<int16_t, BURST_CAPACITY> m_Burst;
+    std::size_t                         m_BurstLength;
+    int64_t                             m_ArmAt;              // us since boot.
+    LDESeriesTriggerEvent_t             m_Event;
+    std::array<char, PAYLOAD_CAPACITY>  m_Payload;
+    std::array<char, EVENT_CAPACITY>    m_EventPayload;
+    bool                                m_EventPublished;     // Of the frozen burst.
+    uint32_t                            m_SequenceNumber;
+    EventQueue*                         m_pEventQueue;
+    int                                 m_EventIdentifier;
+    uint32_t                            m_TriggerCount;
+    uint32_t                            m_MissedTriggerCount;
+    uint32_t                            m_PublishedBurstCount;
+    uint32_t                            m_PublishFailureCount;
+};
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+NuerteyLDESeriesTrigger<S, A, C, B, H, T>::NuerteyLDESeriesTrigger(C& client,
+                                                                   B& source,
+                                                                   const char* pTopic,
+                                                                   const char* pEventTopic,
+                                                                   const TelemetryEncoding_t& encoding,
+                                                                   const std::chrono::microseconds& samplePeriod,
+                                                                   const MQTT::QoS& qos,
+                                                                   NuerteyConnectionManager* pConnectionManager)
+    : m_Client(client)
+    , m_Source(source)
+    , m_pConnectionManager(pConnectionManager)
+    , m_pTopic(pTopic)
+    , m_pEventTopic(pEventTopic)
+    , m_Encoding(encoding)
+    , m_SamplePeriod(samplePeriod)
+    , m_QoS(qos)
+    , m_Configuration{}
+    , m_LevelHigh(0.0f)
+    , m_LevelLow(0.0f)
+    , m_RateThreshold(0.0f)
+    , m_DeviationThreshold(0.0f)
+    , m_BaselineAlpha(0.0f)
+    , m_State(TriggerState_t::ARMED)
+    , m_Baseline(0.0f)
+    , m_BaselinePrimed(false)
+    , m_History{}
+    , m_HistoryHead(0)
+    , m_HistoryCount(0)
+    , m_Burst{}
+    , m_BurstLength(0)
+    , m_ArmAt(0)
+    , m_Event{}
+    , m_Payload{}
+    , m_EventPayload{}
+    , m_EventPublished(false)
+    , m_SequenceNumber(0)
+    , m_pEventQueue(nullptr)
+    , m_EventIdentifier(0)
+    , m_TriggerCount(0)
+    , m_MissedTriggerCount(0)
+    , m_PublishedBurstCount(0)
+    , m_PublishFailureCount(0)
+{
+    Configure(DEFAULT_TRIGGER_CONFIGURATION);
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+NuerteyLDESeriesTrigger<S, A, C, B, H, T>::~NuerteyLDESeriesTrigger()
+{
+    Stop();
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+bool NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Configure(const LDESeriesTriggerConfiguration_t& configuration)
+{
+    if (m_EventIdentifier)
+    {
+        return false;
+    }
+
+    if ((configuration.rateOfChange > 0.0f)
+        && ((configuration.rateSpan == 0) || (configuration.rateSpan >= H)))
+    {
+        printf("[%s]: Error! Rate-of-change span [%u] must lie within the pre-trigger history.\n",
+            __PRETTY_FUNCTION__, configuration.rateSpan);
+        return false;
+    }
+
+    m_Configuration = configuration;
+
+    const float period = static_cast<float>(m_SamplePeriod.count()) / 1'000'000.0f;
+
+    m_LevelHigh          = m_Configuration.levelHigh / COEFFICIENT;
+    m_LevelLow           = m_Configuration.levelLow / COEFFICIENT;
+    m_RateThreshold      = m_Configuration.rateOfChange * period * m_Configuration.rateSpan / COEFFICIENT;
+    m_DeviationThreshold = m_Configuration.deviation / COEFFICIENT;
+    m_BaselineAlpha      = (m_Configuration.baselineTimeConstant > period)
+                         ? (period / m_Configuration.baselineTimeConstant) : 1.0f;
+
+    m_State          = TriggerState_t::ARMED;
+    m_BaselinePrimed = false;
+    m_HistoryHead    = 0;
+    m_HistoryCount   = 0;
+    m_BurstLength    = 0;
+    m_ArmAt          = std::numeric_limits<int64_t>::min();
+
+    return true;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+bool NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Start(const std::chrono::milliseconds& period, EventQueue* pQueue)
+{
+    if (m_EventIdentifier || !pQueue)
+    {
+        return false;
+    }
+
+    m_pEventQueue = pQueue;
+    m_EventIdentifier = m_pEventQueue->call_every(period, this, &NuerteyLDESeriesTrigger::OnSchedule);
+
+    return (m_EventIdentifier != 0);
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+void NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Stop()
+{
+    if (m_EventIdentifier)
+    {
+        m_pEventQueue->cancel(m_EventIdentifier);
+        m_EventIdentifier = 0;
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+bool NuerteyLDESeriesTrigger<S, A, C, B, H, T>::IsSessionUp()
+{
+    return (m_pConnectionManager ? m_pConnectionManager->IsConnected() : m_Client.isConnected());
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+std::span<const int16_t> NuerteyLDESeriesTrigger<S, A, C, B, H, T>::GetBurst() const
+{
+    return (m_State == TriggerState_t::FROZEN)
+         ? std::span<const int16_t>(m_Burst.data(), m_BurstLength) : std::span<const int16_t>();
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+void NuerteyLDESeriesTrigger<S, A, C, B, H, T>::OnSchedule()
+{
+    Process();
+
+    if ((m_State == TriggerState_t::FROZEN) && IsSessionUp())
+    {
+        Publish();
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+std::size_t NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Process()
+{
+    std::array<int16_t, BLOCK_SIZE> readings{};
+    std::size_t processed = 0;
+
+    while (!m_Source.Empty())
+    {
+        // The newest reading in the ring buffer was taken about now.
+        const auto backlog = std::max<int64_t>(static_cast<int64_t>(m_Source.Size()), 1) - 1;
+        auto uptime = std::chrono::duration_cast<std::chrono::microseconds>(
+                          Kernel::Clock::now().time_since_epoch()).count()
+                    - (m_SamplePeriod.count() * backlog);
+        auto utc    = UTCTimestamp_t(MicroSecs_t(g_ClockService.Now() / 1000)) - (m_SamplePeriod * backlog);
+
+        const auto count = m_Source.Pop(readings);
+
+        for (std::size_t i = 0; i < count; ++i, uptime += m_SamplePeriod.count(), utc += m_SamplePeriod)
+        {
+            const auto& reading = readings[i];
+            TriggerCause_t cause{};
+
+            if (m_State == TriggerState_t::CAPTURING)
+            {
+                m_Burst[m_BurstLength++] = reading;
+
+                if (m_BurstLength == (m_Event.preTrigger + T))
+                {
+                    m_Event.length = static_cast<uint32_t>(m_BurstLength);
+                    m_State = TriggerState_t::FROZEN;
+                    m_ArmAt = uptime + std::chrono::duration_cast<std::chrono::microseconds>(
+                                           m_Configuration.holdoff).count();
+                }
+            }
+            else if (Check(reading, cause))
+            {
+                if ((m_State == TriggerState_t::ARMED) && (uptime >= m_ArmAt))
+                {
+                    Trigger(reading, cause, uptime, utc);
+                }
+                else
+                {
+                    m_MissedTriggerCount++;
+                }
+            }
+
+            // Baseline tracks the quiescent signal only.
+            if (m_State == TriggerState_t::ARMED)
+            {
+                m_Baseline += m_BaselineAlpha * (static_cast<float>(reading) - m_Baseline);
+            }
+
+            Remember(reading);
+        }
+
+        processed += count;
+    }
+
+    return processed;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+bool NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Check(const int16_t& counts, TriggerCause_t& cause)
+{
+    const float value = static_cast<float>(counts);
+
+    if (!m_BaselinePrimed)
+    {
+        m_Baseline = value;
+        m_BaselinePrimed = true;
+    }
+
+    if (m_Configuration.levelEnabled && (m_HistoryCount > 0))
+    {
+        const float previous = static_cast<float>(m_History[(m_HistoryHead + H - 1) % H]);
+
+        if (((previous <= m_LevelHigh) && (value > m_LevelHigh))
+            || ((previous >= m_LevelLow) && (value < m_LevelLow)))
+        {
+            cause = TriggerCause_t::LEVEL;
+            return true;
+        }
+    }
+
+    if ((m_Configuration.rateOfChange > 0.0f) && (m_HistoryCount >= m_Configuration.rateSpan))
+    {
+        const float earlier = static_cast<float>(m_History[(m_HistoryHead + H - m_Configuration.rateSpan) % H]);
+
+        if (std::abs(value - earlier) >= m_RateThreshold)
+        {
+            cause = TriggerCause_t::RATE_OF_CHANGE;
+            return true;
+        }
+    }
+
+    if ((m_Configuration.deviation > 0.0f) && (std::abs(value - m_Baseline) >= m_DeviationThreshold))
+    {
+        cause = TriggerCause_t::DEVIATION;
+        return true;
+    }
+
+    return false;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+void NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Trigger(const int16_t& counts, const TriggerCause_t& cause,
+                                                        const int64_t& uptime, const UTCTimestamp_t& utc)
+{
+    // The history, oldest first, then the trigger reading itself.
+    const std::size_t oldest = (m_HistoryHead + H - m_HistoryCount) % H;
+
+    for (std::size_t i = 0; i < m_HistoryCount; ++i)
+    {
+        m_Burst[i] = m_History[(oldest + i) % H];
+    }
+    m_BurstLength = m_HistoryCount;
+    m_Burst[m_BurstLength++] = counts;
+
+    const int64_t firstReading = uptime - (m_SamplePeriod.count() * static_cast<int64_t>(m_HistoryCount));
+
+    m_Event.sequenceNumber = m_SequenceNumber;
+    m_Event.utc            = utc;
+    m_Event.timestamp      = static_cast<uint32_t>(firstReading / 1000);
+    m_Event.cause          = ToString(cause);
+    m_Event.pressure       = PressureConversion<S, A>::ToFloat(counts);
+    m_Event.preTrigger     = static_cast<uint32_t>(m_HistoryCount);
+    m_Event.length         = 0;
+
+    m_State = TriggerState_t::CAPTURING;
+    m_EventPublished = false;
+    m_TriggerCount++;
+
+    // A burst of but the one post-trigger reading is complete already.
+    if (m_BurstLength == (m_Event.preTrigger + T))
+    {
+        m_Event.length = static_cast<uint32_t>(m_BurstLength);
+        m_State = TriggerState_t::FROZEN;
+        m_ArmAt = uptime + std::chrono::duration_cast<std::chrono::microseconds>(m_Configuration.holdoff).count();
+    }
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+void NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Remember(const int16_t& counts)
+{
+    m_History[m_HistoryHead] = counts;
+    m_HistoryHead = (m_HistoryHead + 1) % H;
+    m_HistoryCount = std::min(m_HistoryCount + 1, H);
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+bool NuerteyLDESeriesTrigger<S, A, C, B, H, T>::Publish()
+{
+    if (m_State != TriggerState_t::FROZEN)
+    {
+        return false;
+    }
+
+    // The event record, should it already have gone out, is not repeated
+    // on retrying the burst.
+    if (m_pEventTopic && !m_EventPublished)
+    {
+        JSONStreamWriter writer(m_EventPayload);
+
+        if (!WriteJSONRecord(writer, LDE_SERIES_TRIGGER_EVENT_SCHEMA, m_Event).Good())
+        {
+            return false;
+        }
+
+        MQTT::Message message{};
+        message.qos        = m_QoS;
+        message.payload    = m_EventPayload.data();
+        message.payloadlen = writer.Size();
+
+        if (!PublishMessage(m_pEventTopic, message))
+        {
+            return false;
+        }
+        m_EventPublished = true;
+    }
+
+    TelemetryBatchHeader_t header{};
+    header.sequenceNumber = m_Event.sequenceNumber;
+    header.timestamp      = m_Event.timestamp;
+    header.samplePeriod   = static_cast<uint32_t>(m_SamplePeriod.count());
+
+    const auto length = EncodeTelemetryBatch(m_Encoding, m_Payload, header,
+                                             std::span<const int16_t>(m_Burst.data(), m_BurstLength));
+
+    // By construction, the payload is large enough for a full burst.
+    MBED_ASSERT(length > 0);
+
+    MQTT::Message message{};
+    message.qos        = m_QoS;
+    message.payload    = m_Payload.data();
+    message.payloadlen = length;
+
+    if (!PublishMessage(m_pTopic, message))
+    {
+        return false;
+    }
+
+    m_BurstLength = 0;
+    m_SequenceNumber++;
+    m_PublishedBurstCount++;
+    m_State = TriggerState_t::ARMED;
+
+    return true;
+}
+
+template <IsLDESeriesSensorType S, IsAtmosphericMediumType A, typename C, typename B, std::size_t H, std::size_t T>
+bool NuerteyLDESeriesTrigger<S, A, C, B, H, T>::PublishMessage(const char* pTopic, MQTT::Message& message)
+{
+    // Blocks, for QoS 1, until the PUBACK is in.
+    auto rc = m_Client.publish(pTopic, message);
+
+    if (rc != 0)
+    {
+        m_PublishFailureCount++;
+
+        g_STDIOMutex.lock();
+        printf("[%s]: Error! MQTT publish returned: [%d] -> %s\n",
+            __PRETTY_FUNCTION__, rc,
+            ToString(ToEnum<MQTTConnectionError_t>(rc)).data());
+        g_STDIOMutex.unlock();
+
+        // The client drops the session on a failed publish; have it
+        // brought back up.
+        if (m_pConnectionManager && !m_Client.isConnected())
+        {
+            m_pConnectionManager->ReportSessionLost();
+        }
+        return false;
+    }
+
+    return true;
+}
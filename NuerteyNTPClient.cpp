@@ -11,114 +11,335 @@ const std::string NuerteyNTPClient::DEFAULT_NTP_SERVER_ADDRESS("2.pool.ntp.org")
 const uint16_t    NuerteyNTPClient::DEFAULT_NTP_SERVER_PORT;
 const uint16_t    NuerteyNTPClient::DEFAULT_NTP_CLIENT_PORT;
 const uint32_t    NuerteyNTPClient::NTP_VERSUS_UNIX_TIMESTAMP_DELTA;
+const uint8_t     NuerteyNTPClient::NTP_MODE_SERVER;
+const uint32_t    NuerteyNTPClient::DEFAULT_EXCHANGE_TIMEOUT_MSECS;
 
-NuerteyNTPClient::NuerteyNTPClient(NetworkInterface * pNetworkInterface,
-                      const std::string & server, const uint16_t & port)
+NuerteyNTPClient::NuerteyNTPClient(NetworkInterface * pNetworkInterface, events::EventQueue * pEventQueue,
+                      NuerteyDNSCache * pDNSCache, const std::string & server, const uint16_t & port)
     : m_pNetworkInterface(pNetworkInterface)
+    , m_pEventQueue(pEventQueue)
+    , m_pDNSCache(pDNSCache)
     , m_NTPServerAddress(server)
     , m_NTPServerPort(port)
+    , m_ServerSocketAddress()
+    , m_Socket()
+    , m_State(NTPExchangeState_t::IDLE)
+    , m_LocalClock()
+    , m_Completion()
+    , m_Timeout(0)
+    , m_TransmitSeconds(0)
+    , m_TransmitFraction(0)
+    , m_TransmitTimestamp(0)
+    , m_ReceiveTimestamp(0)
+    , m_ReadPending(false)
+    , m_TimeoutEventIdentifier(0)
 {
 }
 
-void NuerteyNTPClient::SynchronizeRTCTimestamp(const uint32_t & timeout)
+NuerteyNTPClient::~NuerteyNTPClient()
+{
+    CancelExchange();
+}
+
+bool NuerteyNTPClient::SynchronizeRTCTimestamp(const uint32_t & timeout)
 {
     Utilities::g_STDIOMutex.lock();
     printf("\r\n\r\nDefault date and time before NTP is :-> [%s UTC]\r\n", Utilities::WhatTimeNow().c_str());
     Utilities::g_STDIOMutex.unlock();
 
+    // The RTC has but whole seconds, hence so has T1 and T4 herein.
+    auto rtc = []() { return static_cast<int64_t>(time(NULL)) * 1'000'000'000; };
+
+    auto step = [](bool success, const NTPSample_t & sample)
+    {
+        if (!success)
+        {
+            return;
+        }
+
+        // Rounded to the nearest second.
+        const int64_t offset = ((sample.offset >= 0) ? (sample.offset + 500'000'000)
+                                                     : (sample.offset - 500'000'000)) / 1'000'000'000;
+
+        // Seed the RTC accordingly...
+        set_time(time(NULL) + offset);
+
+        Utilities::g_STDIOMutex.lock();
+        printf("\r\nCalculated system clock offset: [%lld ns], round-trip delay: [%lld ns]", sample.offset, sample.delay);
+        printf("\r\n\r\nSynchronized date and time after NTP is :-> [%s UTC]\r\n", Utilities::WhatTimeNow().c_str());
+        Utilities::g_STDIOMutex.unlock();
+    };
+
+    return StartExchange(rtc, step, timeout);
+}
+
+bool NuerteyNTPClient::StartExchange(const LocalClock_t & localClock, const ExchangeCallback_t & completion,
+                                     const uint32_t & timeout)
+{
+    if (IsBusy() || !localClock || !completion
+        || (m_pNetworkInterface->get_connection_status() != NSAPI_STATUS_GLOBAL_UP))
+    {
+        return false;
+    }
+
+    m_LocalClock = localClock;
+    m_Completion = completion;
+    m_Timeout = timeout;
+
+    // The timeout covers the lookup, if any, as well as the reply.
+    m_TimeoutEventIdentifier = m_pEventQueue->call_in(std::chrono::milliseconds(timeout),
+                                                      this, &NuerteyNTPClient::OnTimeout);
+
+    if (!m_TimeoutEventIdentifier)
+    {
+        return false;
+    }
+
+    m_State = NTPExchangeState_t::RESOLVING;
+
+    SocketAddress address;
+    nsapi_error_t retVal = m_pDNSCache->ResolveAsync(m_NTPServerAddress.c_str(), &address,
+                                                     mbed::callback(this, &NuerteyNTPClient::OnResolved));
+
+    // A cache hit is posted rather than called, so that the completion,
+    // should the socket then fail straightaway, never runs from within
+    // StartExchange(), i.e. possibly from within the previous completion.
+    if ((retVal == NSAPI_ERROR_OK)
+        && !m_pEventQueue->call([this, address]() { OnResolved(NSAPI_ERROR_OK, address); }))
+    {
+        retVal = NSAPI_ERROR_NO_MEMORY;
+    }
+
+    if ((retVal != NSAPI_ERROR_OK) && (retVal != NSAPI_ERROR_IN_PROGRESS))
+    {
+        // Without the completion, as the exchange was never started.
+        m_pEventQueue->cancel(m_TimeoutEventIdentifier);
+        m_TimeoutEventIdentifier = 0;
+        m_State = NTPExchangeState_t::IDLE;
+        m_Completion = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void NuerteyNTPClient::CancelExchange()
+{
+    if (IsBusy())
+    {
+        m_Completion = nullptr;
+        Complete(false);
+    }
+}
+
+void NuerteyNTPClient::OnResolved(nsapi_error_t result, const SocketAddress & address)
+{
+    // Else, this exchange has timed out, or been cancelled, in the meantime.
+    if (m_State != NTPExchangeState_t::RESOLVING)
+    {
+        return;
+    }
+
+    if (result != NSAPI_ERROR_OK)
+    {
+        Complete(false);
+        return;
+    }
+
+    m_ServerSocketAddress = address;
+    m_ServerSocketAddress.set_port(m_NTPServerPort);
+
+    SendRequest();
+}
+
+void NuerteyNTPClient::SendRequest()
+{
+    nsapi_error_t retVal = m_Socket.open(m_pNetworkInterface);
+
+    if (retVal != NSAPI_ERROR_OK)
+    {
+        Utilities::g_STDIOMutex.lock();
+        printf("[%s]: Error! Socket open returned: [%d] -> %s\r\n", __PRETTY_FUNCTION__, retVal, ToString(retVal).data());
+        Utilities::g_STDIOMutex.unlock();
+
+        Complete(false);
+        return;
+    }
+
+    m_Socket.bind(DEFAULT_NTP_CLIENT_PORT);
+    m_Socket.set_blocking(false);
+    m_Socket.sigio(mbed::callback(this, &NuerteyNTPClient::OnSigio));
+
+    m_State = NTPExchangeState_t::AWAITING_REPLY;
+
     struct NTPPacket pkt;
+    memset(&pkt, 0, sizeof(pkt)); // All else is significant only in server messages.
 
     pkt.li = 3; // Leap Indicator : "clock not synchronized"; Only significant in server messages.
     pkt.vn = 4; // Version Number : "NTP/SNTP version 4"
     pkt.mode = 3; // Mode : "Client"
-    pkt.stratum = 0; // Stratum. Significant only in SNTP server messages.
-    pkt.poll = 0; // Poll Interval. Significant only in SNTP server messages.
-    pkt.precision = 0; // Precision. Significant only in server messages.
-    pkt.rootDelay = 0; // Root Delay. Significant only in server messages.
-    pkt.rootDispersion = 0; // Root Dispersion. Significant only in server messages.
-    pkt.refId = 0; // Reference Identifier. Significant only in server messages.
-    pkt.refTm_s = 0; // Reference Timestamp. Significant only in server messages.
-    pkt.origTm_s = 0; // Originate Timestamp. Significant only in server messages.
-    pkt.rxTm_s = 0; // Receive Timestamp. Significant only in server messages.
-    pkt.txTm_s = htonl(NTP_VERSUS_UNIX_TIMESTAMP_DELTA + time(NULL)); // WARN: We are in LE format, network byte order is BE
-    pkt.refTm_f = pkt.origTm_f = pkt.rxTm_f = pkt.txTm_f = 0;
-
-    SocketAddress serverSocketAddress;
-    SocketAddress clientSocketAddress;
 
-    nsapi_size_or_error_t retVal;
-    do
+    // T1, which the server echoes back as its Originate Timestamp.
+    m_TransmitTimestamp = m_LocalClock();
+    UnixNanosecondsToNTP(m_TransmitTimestamp, m_TransmitSeconds, m_TransmitFraction);
+
+    pkt.txTm_s = htonl(m_TransmitSeconds); // WARN: We are in LE format, network byte order is BE
+    pkt.txTm_f = htonl(m_TransmitFraction);
+
+    retVal = m_Socket.sendto(m_ServerSocketAddress, static_cast<void *>(&pkt), sizeof(NTPPacket));
+
+    if (retVal < 0)
     {
-        printf("\r\nPerforming DNS lookup for : \"%s\" ...", m_NTPServerAddress.c_str());
-        retVal = m_pNetworkInterface->gethostbyname(m_NTPServerAddress.c_str(), &serverSocketAddress);
-        if (retVal < 0)
+        Utilities::g_STDIOMutex.lock();
+        printf("[%s]: Error! Socket sendto returned: [%d] -> %s\r\n", __PRETTY_FUNCTION__, retVal, ToString(retVal).data());
+        Utilities::g_STDIOMutex.unlock();
+
+        Complete(false);
+    }
+}
+
+void NuerteyNTPClient::OnSigio()
+{
+    // In the network stack's context. Taken here, as the EventQueue may
+    // be some while getting round to the reply.
+    const int64_t receiveTimestamp = m_LocalClock();
+
+    core_util_critical_section_enter();
+    m_ReceiveTimestamp = receiveTimestamp;
+    core_util_critical_section_exit();
+
+    if (!m_ReadPending.exchange(true))
+    {
+        if (!m_pEventQueue->call(this, &NuerteyNTPClient::OnReadable))
         {
-            printf("\r\nError! On DNS lookup, Network returned: [%d] -> %s", retVal, ToString(retVal).c_str());
+            m_ReadPending = false;
         }
     }
-    while (retVal < 0);
-
-    serverSocketAddress.set_port(m_NTPServerPort);
+}
 
-    UDPSocket sock;
-    sock.bind(DEFAULT_NTP_CLIENT_PORT);
-    sock.set_blocking(false);
-    sock.set_timeout(timeout); // Set timeout as we are on embedded.
+void NuerteyNTPClient::OnReadable()
+{
+    m_ReadPending = false;
 
-    sock.open(m_pNetworkInterface);
+    if (m_State != NTPExchangeState_t::AWAITING_REPLY)
+    {
+        return;
+    }
 
-    printf("\r\nPinging NTP Time Server at : \"%s\" ...", serverSocketAddress.get_ip_address());
-    sock.sendto(serverSocketAddress, static_cast<void *>(&pkt), sizeof(NTPPacket));
+    struct NTPPacket pkt;
+    SocketAddress clientSocketAddress;
+    nsapi_size_or_error_t retVal;
 
-    do
+    // Drain; anything else, e.g. a late reply to some earlier exchange,
+    // is not ours.
+    while ((retVal = m_Socket.recvfrom(&clientSocketAddress, static_cast<void *>(&pkt), sizeof(NTPPacket)))
+           != NSAPI_ERROR_WOULD_BLOCK)
     {
-        printf("\r\nWaiting for NTP Time Server response ...");
-        nsapi_size_or_error_t status = sock.recvfrom(&clientSocketAddress, static_cast<void *>(&pkt), sizeof(NTPPacket));
-        printf("\r\nReceived a response from : \"%s\" .", clientSocketAddress.get_ip_address());
+        if (retVal < 0)
+        {
+            Utilities::g_STDIOMutex.lock();
+            printf("[%s]: Error! Socket recvfrom returned: [%d] -> %s\r\n", __PRETTY_FUNCTION__, retVal, ToString(retVal).data());
+            Utilities::g_STDIOMutex.unlock();
 
-        if (status < (nsapi_size_or_error_t)sizeof(NTPPacket))
+            Complete(false);
+            return;
+        }
+
+        if ((retVal == (nsapi_size_or_error_t)sizeof(NTPPacket))
+            && (clientSocketAddress == m_ServerSocketAddress)
+            && (ntohl(pkt.origTm_s) == m_TransmitSeconds) && (ntohl(pkt.origTm_f) == m_TransmitFraction))
         {
-            if (status < 0)
-            {
-                printf("\r\nError! Socket recvfrom returned: [%d] -> %s", status, ToString(status).c_str());
-            }
-            else
-            {
-                printf("\r\nError! Partial data returned on socket read: [%d]", status);
-            }
+            break;
         }
+    }
 
-        // TBD, Nuertey Odzeyem : we would need a DNS Resolver to be able to compare the incoming address with the DNS name.
+    if (retVal == NSAPI_ERROR_WOULD_BLOCK)
+    {
+        return; // Await the next sigio.
     }
-    while (strcmp(serverSocketAddress.get_ip_address(), clientSocketAddress.get_ip_address()) != 0);
 
-    if (pkt.stratum == 0)  // "kiss-o'-death message"
+    core_util_critical_section_enter();
+    const int64_t t4 = m_ReceiveTimestamp;
+    core_util_critical_section_exit();
+
+    if ((pkt.stratum == 0) || (pkt.mode != NTP_MODE_SERVER) || (pkt.txTm_s == 0))  // "kiss-o'-death message"
     {
-        printf("\r\nReceived a kiss-o'-death message.");
+        Utilities::g_STDIOMutex.lock();
+        printf("[%s]: Error! Received a kiss-o'-death message.\r\n", __PRETTY_FUNCTION__);
+        Utilities::g_STDIOMutex.unlock();
+
+        Complete(false);
+        return;
     }
-    else
+
+    // Correct for Endianness ...
+    const int64_t t1 = m_TransmitTimestamp;
+    const int64_t t2 = NTPToUnixNanoseconds(ntohl(pkt.rxTm_s), ntohl(pkt.rxTm_f));
+    const int64_t t3 = NTPToUnixNanoseconds(ntohl(pkt.txTm_s), ntohl(pkt.txTm_f));
+
+    // Compute offset, see RFC 4330 p.13
+    NTPSample_t sample;
+    sample.offset = ((t2 - t1) + (t3 - t4)) / 2;
+    sample.delay  = (t4 - t1) - (t3 - t2);
+
+    Complete(true, sample);
+}
+
+void NuerteyNTPClient::OnTimeout()
+{
+    m_TimeoutEventIdentifier = 0;
+
+    Utilities::g_STDIOMutex.lock();
+    printf("[%s]: Error! No reply from NTP Time Server \"%s\" within %lu ms.\r\n", __PRETTY_FUNCTION__,
+        m_NTPServerAddress.c_str(), m_Timeout);
+    Utilities::g_STDIOMutex.unlock();
+
+    Complete(false);
+}
+
+void NuerteyNTPClient::Complete(const bool & success, const NTPSample_t & sample)
+{
+    if (m_TimeoutEventIdentifier)
     {
-        // Correct for Endianness ...
-        pkt.refTm_s = ntohl(pkt.refTm_s);
-        pkt.refTm_f = ntohl(pkt.refTm_f);
-        pkt.origTm_s = ntohl(pkt.origTm_s);
-        pkt.origTm_f = ntohl(pkt.origTm_f);
-        pkt.rxTm_s = ntohl(pkt.rxTm_s);
-        pkt.rxTm_f = ntohl(pkt.rxTm_f);
-        pkt.txTm_s = ntohl(pkt.txTm_s);
-        pkt.txTm_f = ntohl(pkt.txTm_f);
+        m_pEventQueue->cancel(m_TimeoutEventIdentifier);
+        m_TimeoutEventIdentifier = 0;
+    }
 
-        // Compute offset, see RFC 4330 p.13
-        uint32_t destTm_s = (NTP_VERSUS_UNIX_TIMESTAMP_DELTA + time(NULL));
-        int64_t offset = ((int64_t)(pkt.rxTm_s - pkt.origTm_s) + (int64_t)(pkt.txTm_s - destTm_s)) / 2; // Avoid overflow
-        printf("\r\nServer deduced that client transmitted this timestamp: [%lu]", pkt.txTm_s);
-        printf("\r\nCalculated system clock offset: [%lld]", offset);
+    if (m_State == NTPExchangeState_t::AWAITING_REPLY)
+    {
+        m_Socket.sigio(nullptr);
+        m_Socket.close();
+    }
 
-        // Seed the RTC accordingly...
-        set_time(time(NULL) + offset);
+    // The server may well have moved, or gone.
+    if (!success)
+    {
+        m_pDNSCache->Invalidate(m_NTPServerAddress.c_str());
+    }
 
-        printf("\r\n\r\nSynchronized date and time after NTP is :-> [%s UTC]\r\n", Utilities::WhatTimeNow().c_str());
+    m_State = NTPExchangeState_t::IDLE;
+
+    // Whence the next exchange may well be started.
+    ExchangeCallback_t completion = m_Completion;
+    m_Completion = nullptr;
+
+    if (completion)
+    {
+        completion(success, sample);
     }
+}
+
+int64_t NuerteyNTPClient::NTPToUnixNanoseconds(const uint32_t & seconds, const uint32_t & fraction)
+{
+    return ((static_cast<int64_t>(seconds) - NTP_VERSUS_UNIX_TIMESTAMP_DELTA) * 1'000'000'000)
+         + static_cast<int64_t>((static_cast<uint64_t>(fraction) * 1'000'000'000) >> 32);
+}
+
+void NuerteyNTPClient::UnixNanosecondsToNTP(const int64_t & nanoseconds, uint32_t & seconds, uint32_t & fraction)
+{
+    const int64_t wholeSeconds = nanoseconds / 1'000'000'000;
+    const int64_t remainder    = nanoseconds % 1'000'000'000;
 
-    sock.close();
+    seconds  = static_cast<uint32_t>(wholeSeconds + NTP_VERSUS_UNIX_TIMESTAMP_DELTA);
+    fraction = static_cast<uint32_t>((static_cast<uint64_t>(remainder) << 32) / 1'000'000'000);
 }
@@ -3,10 +3,24 @@
 *
 * My version of an NTP Client that synchronizes ARM Mbed-enabled target 
 * RTCs to a remote time server over UDP. Consult RFC 4330 for reference.
+*
+* StartExchange() performs a single client/server exchange against a
+* caller-supplied local clock, fraction fields and all, and yields the
+* clock offset and round-trip delay thereof; see NuerteyClockService.h
+* for its use. SynchronizeRTCTimestamp() merely steps the RTC by it.
+*
+* Exchanges are asynchronous state machines on the EventQueue; IDLE ->
+* RESOLVING (by way of the shared DNS cache) -> AWAITING_REPLY -> IDLE.
+* The non-blocking UDPSocket signals the arrival of the reply by sigio,
+* whereupon T4 is taken, straightaway, and the reply read and checked in
+* the EventQueue context.
 *       
-* @note      
+* @note    Neither startup nor the EventQueue are blocked on DNS failures
+*          or on lost replies anymore. The completion is always invoked,
+*          exactly once, for every exchange started, and always from the
+*          EventQueue, never from within StartExchange() itself.
 * 
-* @warning  
+* @warning One exchange at a time.
 * 
 *  Created: October 19, 2018
 *   Author: Nuertey Odzeyem        
@@ -14,14 +28,36 @@
 #pragma once
 
 #include <string>
+#include <atomic>
 #include <cstdint>
 #include "NetworkInterface.h"
+#include "NuerteyDNSCache.h"
+#include "mbed_events.h"
+#include "mbed.h"
+
+// Outcome of one NTP exchange, in ns. RFC 4330 p.13:
+//
+// offset = ((T2 - T1) + (T3 - T4)) / 2
+// delay  =  (T4 - T1) - (T3 - T2)
+struct NTPSample_t
+{
+    int64_t offset;
+    int64_t delay;
+};
+
+enum class NTPExchangeState_t : uint8_t
+{
+    IDLE,
+    RESOLVING,
+    AWAITING_REPLY
+};
 
 class NuerteyNTPClient 
 {
     static const std::string DEFAULT_NTP_SERVER_ADDRESS;
     static const uint16_t    DEFAULT_NTP_SERVER_PORT          =  123;
     static const uint16_t    DEFAULT_NTP_CLIENT_PORT          =  0; // Signifying a random port.
+    static const uint8_t     NTP_MODE_SERVER                  =  4;
     
     // Difference between a UNIX timestamp (Starting Jan, 1st 1970) and a NTP timestamp (Starting Jan, 1st 1900)
     static const uint32_t    NTP_VERSUS_UNIX_TIMESTAMP_DELTA  =  2208988800ull;
@@ -54,13 +90,65 @@ class NuerteyNTPClient
     } __attribute__ ((packed));
   
 public:
-    NuerteyNTPClient(NetworkInterface * pNetworkInterface, const std::string & server = DEFAULT_NTP_SERVER_ADDRESS, 
+    // The local time, as ns since the UNIX epoch. Must be callable from
+    // the network stack's context.
+    using LocalClock_t = mbed::Callback<int64_t()>;
+
+    // Whether the exchange succeeded, and if so, its outcome. In the
+    // EventQueue context.
+    using ExchangeCallback_t = mbed::Callback<void(bool, const NTPSample_t &)>;
+
+    static const uint32_t    DEFAULT_EXCHANGE_TIMEOUT_MSECS   =  1000;
+
+    NuerteyNTPClient(NetworkInterface * pNetworkInterface, events::EventQueue * pEventQueue,
+          NuerteyDNSCache * pDNSCache, const std::string & server = DEFAULT_NTP_SERVER_ADDRESS, 
 	      const uint16_t & port = DEFAULT_NTP_SERVER_PORT);
+
+    virtual ~NuerteyNTPClient();
     
-    void SynchronizeRTCTimestamp(const uint32_t & timeout = 15000);
+    // Steps the RTC, to the nearest second, once the exchange completes.
+    bool SynchronizeRTCTimestamp(const uint32_t & timeout = 15000);
+
+    // T1 is read off localClock just before the sendto(), and T4 in the
+    // sigio of the reply. The exchange fails on a reply that is a
+    // kiss-o'-death, and on the timeout; replies that do not echo our T1
+    // are ignored. False, and the completion not invoked, should the
+    // exchange not even be started, e.g. one is already underway.
+    bool StartExchange(const LocalClock_t & localClock, const ExchangeCallback_t & completion,
+                       const uint32_t & timeout = DEFAULT_EXCHANGE_TIMEOUT_MSECS);
+    void CancelExchange();
+
+    NTPExchangeState_t GetState() const { return m_State; }
+    bool               IsBusy() const { return (m_State != NTPExchangeState_t::IDLE); }
+
+protected:
+    void OnResolved(nsapi_error_t result, const SocketAddress & address);
+    void OnSigio();
+    void OnReadable();
+    void OnTimeout();
+
+    void SendRequest();
+    void Complete(const bool & success, const NTPSample_t & sample = NTPSample_t{});
+
+    static int64_t NTPToUnixNanoseconds(const uint32_t & seconds, const uint32_t & fraction);
+    static void    UnixNanosecondsToNTP(const int64_t & nanoseconds, uint32_t & seconds, uint32_t & fraction);
 
 private:
     NetworkInterface *    m_pNetworkInterface;
+    events::EventQueue *  m_pEventQueue;
+    NuerteyDNSCache *     m_pDNSCache;
     std::string           m_NTPServerAddress;
     uint16_t              m_NTPServerPort;
+    SocketAddress         m_ServerSocketAddress;
+    UDPSocket             m_Socket;
+    NTPExchangeState_t    m_State;
+    LocalClock_t          m_LocalClock;
+    ExchangeCallback_t    m_Completion;
+    uint32_t              m_Timeout;
+    uint32_t              m_TransmitSeconds;  // T1, as sent, and as to be echoed.
+    uint32_t              m_TransmitFraction;
+    int64_t               m_TransmitTimestamp;
+    int64_t               m_ReceiveTimestamp; // T4, as of the last sigio.
+    std::atomic<bool>     m_ReadPending;
+    int                   m_TimeoutEventIdentifier;
 };
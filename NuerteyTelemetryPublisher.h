@@ -0,0 +1,634 @@
+/***********************************************************************
+* @file      NuerteyTelemetryPublisher.h
+*
+*    Batched MQTT telemetry publisher for the LDE Series sample stream.
+*
+*    Raw counts are drained from the acquisition ring buffer, packed N
+*    readings to a payload, JSON or packed binary as selected (see
+*    TelemetryEncoding.h), and published from a fixed pool of message
+*    buffers that are preallocated along with the publisher itself. No
+*    heap allocation is made after construction.
+*
+* @brief
+*
+* @note    The pool is used as a ring: batches are packed into the next
+*          free slot and published strictly in order, each slot being
+*          released only once its publish has completed, i.e. for QoS 1,
+*          once the broker's PUBACK has been received. The Paho embedded
+*          client waits for that PUBACK within publish() itself, hence
+*          all the publishing happens here, in the EventQueue context,
+*          whilst acquisition carries on unhindered into the ring buffer
+*          and further batches queue up in the remaining slots.
+*
+*          Whilst the session is down, the readings are moved on from the
+*          acquisition ring buffer, before it can overflow, into a larger
+*          store-and-forward buffer. Once the session is back, that
+*          backlog is forwarded first, in batches BACKLOG_BATCH_FACTOR
+*          times larger, and up to a pool's worth per tick so that the
+*          ring buffer is never starved of attention for long.
+*
+*          For outages longer than that RAM will hold, or that span a
+*          reboot, attach a mounted NuerteyFlashJournal instead. Readings
+*          are then journaled whilst the session is down, and replayed a
+*          journal page to a message from the last acknowledged sequence
+*          number once it is back, each page being acknowledged to the
+*          journal as its publish completes.
+*
+*          Given a connection manager, the publisher subscribes to it on
+*          Start(), so that the backlog starts being forwarded the moment
+*          the session is back rather than on the next tick. The journal,
+*          if any, is told of the link state changes likewise.
+*
+*          Usage, given say an MQTT::Client<MQTTNetwork, Countdown> client:
+*
+*          NuerteyTelemetryPublisher<decltype(client),
+*                                    decltype(g_LDESeriesSampler)::SampleBuffer_t>
+*              publisher(client, g_LDESeriesSampler.GetSampleBuffer(), "lde/pressure");
+*          publisher.Start();
+*
+* @warning The publisher is the ring buffer's one consumer; nothing else
+*          may drain it whilst the publisher is running.
+*
+*          The store-and-forward buffer is bounded; should an outage
+*          outlast it, the oldest readings are discarded, and counted.
+*
+*          The client's MAX_MQTT_PACKET_SIZE must accommodate a backlog
+*          batch, i.e. PAYLOAD_CAPACITY, plus the topic.
+*
+*          PublishRecord() is for one-off records, e.g. the health monitor's,
+*          at QoS 0; it bypasses the pool, and the order of the batches.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include "TelemetryEncoding.h"
+#include "SPSCRingBuffer.h"
+#include "NuerteyFlashJournal.h"
+
+using namespace Utilities;
+
+// Per-sample publishing overwhelms both the broker connection and the
+// lwIP buffers; at 1 kHz, these defaults publish but 16 messages/s.
+constexpr std::size_t DEFAULT_READINGS_PER_MESSAGE = 64;
+constexpr std::size_t DEFAULT_MESSAGE_POOL_SIZE    = 4;
+
+// Power of two; at 1 kHz, some 16 s of outage is ridden out. Backlog
+// batches amortize the per-message overhead whilst catching up.
+constexpr std::size_t DEFAULT_STORE_AND_FORWARD_CAPACITY = 16384;
+constexpr std::size_t BACKLOG_BATCH_FACTOR               = 4;
+
+static const uint32_t TELEMETRY_PUBLISHING_PERIOD_MSECS = 50;
+
+template <typename C, typename B,
+          std::size_t R = DEFAULT_READINGS_PER_MESSAGE,
+          std::size_t P = DEFAULT_MESSAGE_POOL_SIZE,
+          std::size_t S = DEFAULT_STORE_AND_FORWARD_CAPACITY>
+class NuerteyTelemetryPublisher
+{
+    static_assert((R > 0) && (P > 0));
+
+    static constexpr std::size_t BACKLOG_READINGS_PER_MESSAGE = R * BACKLOG_BATCH_FACTOR;
+
+    // Sized for whichever encoding is the larger, so that the encoding
+    // may be switched at runtime; and for a backlog batch or journal page.
+    static constexpr std::size_t MAXIMUM_READINGS_PER_MESSAGE
+        = std::max(BACKLOG_READINGS_PER_MESSAGE, JOURNAL_READINGS_PER_PAGE);
+    static constexpr std::size_t PAYLOAD_CAPACITY = TelemetryBatchCapacity(MAXIMUM_READINGS_PER_MESSAGE);
+
+public:
+    using Payload_t = std::array<char, PAYLOAD_CAPACITY>;
+    using Store_t   = SPSCRingBuffer<int16_t, S>;
+
+    NuerteyTelemetryPublisher(C& client,
+                              B& source,
+                              const char* pTopic,
+                              const TelemetryEncoding_t& encoding = TelemetryEncoding_t::JSON,
+                              const std::chrono::microseconds& samplePeriod
+                                  = std::chrono::microseconds(CONTINUOUS_ACQUISITION_PERIOD_USECS),
+                              const MQTT::QoS& qos = MQTT::QOS1,
+                              NuerteyConnectionManager* pConnectionManager = nullptr);
+
+    NuerteyTelemetryPublisher(const NuerteyTelemetryPublisher&) = delete;
+    NuerteyTelemetryPublisher& operator=(const NuerteyTelemetryPublisher&) = delete;
+
+    virtual ~NuerteyTelemetryPublisher();
+
+    bool Start(const std::chrono::milliseconds& period
+                   = std::chrono::milliseconds(TELEMETRY_PUBLISHING_PERIOD_MSECS),
+               EventQueue* pQueue = &gs_MasterEventQueue);
+    void Stop();
+
+    // Packs and publishes whatever remains, a partial batch included.
+    // To be called in the same context as the periodic publishing.
+    bool Flush();
+
+    // Takes effect from the next batch packed.
+    void SetEncoding(const TelemetryEncoding_t& encoding) { m_Encoding = encoding; }
+    TelemetryEncoding_t GetEncoding() const { return m_Encoding; }
+
+    // Store-and-forward to flash rather than to RAM; nullptr to detach.
+    // The journal is to be mounted beforehand, and used by nothing else.
+    void SetJournal(NuerteyFlashJournal* pJournal) { m_pJournal = pJournal; }
+
+    static constexpr std::size_t GetReadingsPerMessage() { return R; }
+    static constexpr std::size_t GetMessagePoolSize() { return P; }
+    static constexpr std::size_t GetStoreAndForwardCapacity() { return S; }
+
+    // Per the connection manager when given one, else per the client.
+    bool IsSessionUp();
+
+    // At QoS 0, hence without waiting for the broker; the record is sent
+    // from the caller's buffer, or dropped should the session be down. To
+    // be called in the same context as the periodic publishing.
+    bool PublishRecord(const char* pTopic, std::string_view record);
+
+    // A NuerteyConnectionManager::LinkObserver_t; in the EventQueue context.
+    void OnLinkStateChanged(ConnectionState_t state);
+
+    std::size_t GetPendingMessageCount() const { return m_PendingCount; }
+    uint32_t    GetPublishedMessageCount() const { return m_PublishedMessageCount.load(); }
+    uint32_t    GetPublishFailureCount() const { return m_PublishFailureCount.load(); }
+    uint32_t    GetPoolExhaustedCount() const { return m_PoolExhaustedCount.load(); }
+    std::size_t GetStoredReadingCount() const { return m_Store.Size(); }
+    uint32_t    GetDiscardedReadingCount() const { return m_DiscardedReadingCount.load(); }
+
+    // Of the batches' publish() calls, i.e. for QoS 1, to the PUBACK.
+    std::chrono::microseconds GetPublishLatency() const { return std::chrono::microseconds(m_PublishLatency.load()); }
+    std::chrono::microseconds GetMaximumPublishLatency() const { return std::chrono::microseconds(m_MaximumPublishLatency.load()); }
+
+protected:
+    void OnSchedule();
+    void StoreReadings();
+    void JournalReadings();
+    bool PackAvailable(const bool& partial);
+    bool PackJournalPage();
+    bool IsJournalCaughtUp() const;
+
+    template <typename Q>
+    bool PackBatch(Q& queue, const std::size_t& count, const std::size_t& backlog);
+
+    bool EnqueueBatch(const uint32_t& timestamp, std::span<const int16_t> readings);
+    uint32_t FirstReadingTimestamp(const std::size_t& backlog) const;
+
+    void PublishPending();
+
+private:
+    struct MessageSlot_t
+    {
+        Payload_t      payload;
+        MQTT::Message  message;
+        bool           journaled;
+        uint32_t       lastSequenceNumber; // Of its readings, if journaled.
+    };
+
+    C&                                 m_Client;
+    B&                                 m_Source;
+    NuerteyConnectionManager*          m_pConnectionManager;
+    NuerteyFlashJournal*               m_pJournal;
+    const char*                        m_pTopic;
+    TelemetryEncoding_t                m_Encoding;
+    std::chrono::microseconds          m_SamplePeriod;
+    std::array<MessageSlot_t, P>       m_Slots;
+    Store_t                            m_Store;
+    std::size_t                        m_NextPublish;
+    std::size_t                        m_PendingCount;
+    uint32_t                           m_SequenceNumber;
+    EventQueue*                        m_pEventQueue;
+    int                                m_EventIdentifier;
+    int                                m_LinkObserverIdentifier;
+    std::atomic<uint32_t>              m_PublishedMessageCount;
+    std::atomic<uint32_t>              m_PublishFailureCount;
+    std::atomic<uint32_t>              m_PoolExhaustedCount;
+    std::atomic<uint32_t>              m_DiscardedReadingCount;
+    std::atomic<uint32_t>              m_PublishLatency;         // us.
+    std::atomic<uint32_t>              m_MaximumPublishLatency;  // us.
+};
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+NuerteyTelemetryPublisher<C, B, R, P, S>::NuerteyTelemetryPublisher(C& client,
+                                                                    B& source,
+                                                                    const char* pTopic,
+                                                                    const TelemetryEncoding_t& encoding,
+                                                                    const std::chrono::microseconds& samplePeriod,
+                                                                    const MQTT::QoS& qos,
+                                                                    NuerteyConnectionManager* pConnectionManager)
+    : m_Client(client)
+    , m_Source(source)
+    , m_pConnectionManager(pConnectionManager)
+    , m_pJournal(nullptr)
+    , m_pTopic(pTopic)
+    , m_Encoding(encoding)
+    , m_SamplePeriod(samplePeriod)
+    , m_Slots{}
+    , m_Store()
+    , m_NextPublish(0)
+    , m_PendingCount(0)
+    , m_SequenceNumber(0)
+    , m_pEventQueue(nullptr)
+    , m_EventIdentifier(0)
+    , m_LinkObserverIdentifier(0)
+    , m_PublishedMessageCount(0)
+    , m_PublishFailureCount(0)
+    , m_PoolExhaustedCount(0)
+    , m_DiscardedReadingCount(0)
+    , m_PublishLatency(0)
+    , m_MaximumPublishLatency(0)
+{
+    // Each message forever refers to its own slot's payload buffer.
+    for (auto& slot : m_Slots)
+    {
+        slot.message.qos        = qos;
+        slot.message.retained   = false;
+        slot.message.dup        = false;
+        slot.message.id         = 0;
+        slot.message.payload    = slot.payload.data();
+        slot.message.payloadlen = 0;
+    }
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+NuerteyTelemetryPublisher<C, B, R, P, S>::~NuerteyTelemetryPublisher()
+{
+    Stop();
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::Start(const std::chrono::milliseconds& period,
+                                                  EventQueue* pQueue)
+{
+    if (m_EventIdentifier || !pQueue)
+    {
+        return false;
+    }
+
+    m_pEventQueue = pQueue;
+    m_EventIdentifier = m_pEventQueue->call_every(period, this, &NuerteyTelemetryPublisher::OnSchedule);
+
+    if (m_EventIdentifier && m_pConnectionManager)
+    {
+        m_LinkObserverIdentifier = m_pConnectionManager->Subscribe(
+            mbed::callback(this, &NuerteyTelemetryPublisher::OnLinkStateChanged));
+    }
+
+    return (m_EventIdentifier != 0);
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+void NuerteyTelemetryPublisher<C, B, R, P, S>::Stop()
+{
+    if (m_EventIdentifier)
+    {
+        m_pEventQueue->cancel(m_EventIdentifier);
+        m_EventIdentifier = 0;
+    }
+
+    if (m_LinkObserverIdentifier)
+    {
+        m_pConnectionManager->Unsubscribe(m_LinkObserverIdentifier);
+        m_LinkObserverIdentifier = 0;
+    }
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::IsSessionUp()
+{
+    return (m_pConnectionManager ? m_pConnectionManager->IsConnected() : m_Client.isConnected());
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::PublishRecord(const char* pTopic, std::string_view record)
+{
+    if (!IsSessionUp())
+    {
+        return false;
+    }
+
+    MQTT::Message message{};
+    message.qos        = MQTT::QOS0;
+    message.retained   = false;
+    message.dup        = false;
+    message.payload    = const_cast<char*>(record.data());
+    message.payloadlen = record.size();
+
+    int rc = 0;
+    {
+        INSTRUMENT_SCOPE(Probe_t::MQTT_PUBLISH);
+        rc = m_Client.publish(pTopic, message);
+    }
+
+    if (rc != 0)
+    {
+        m_PublishFailureCount++;
+
+        if (m_pConnectionManager && !m_Client.isConnected())
+        {
+            m_pConnectionManager->ReportSessionLost();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+void NuerteyTelemetryPublisher<C, B, R, P, S>::OnLinkStateChanged(ConnectionState_t state)
+{
+    if (m_pJournal)
+    {
+        m_pJournal->OnLinkStateChanged(state);
+    }
+
+    // Posted rather than called, so as not to publish from within the
+    // connection manager, which may be amidst reconnecting.
+    if ((state == ConnectionState_t::CONNECTED) && m_EventIdentifier)
+    {
+        m_pEventQueue->call(this, &NuerteyTelemetryPublisher::OnSchedule);
+    }
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::Flush()
+{
+    // Until drained, or until a failing publish has filled the pool.
+    do
+    {
+        PackAvailable(true);
+        PublishPending();
+    } 
+    while ((!m_Store.Empty() || !m_Source.Empty() || !IsJournalCaughtUp()) && (m_PendingCount < P));
+
+    return (m_Store.Empty() && m_Source.Empty() && IsJournalCaughtUp() && (m_PendingCount == 0));
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+void NuerteyTelemetryPublisher<C, B, R, P, S>::OnSchedule()
+{
+    if (!IsSessionUp())
+    {
+        // Store-and-forward; the ring buffer must not overflow meanwhile.
+        StoreReadings();
+        return;
+    }
+
+    // Whatever was packed before the outage goes first.
+    PublishPending();
+
+    if (!PackAvailable(false))
+    {
+        // Back-pressure; the readings wait in the ring buffer.
+        m_PoolExhaustedCount++;
+    }
+
+    PublishPending();
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+void NuerteyTelemetryPublisher<C, B, R, P, S>::StoreReadings()
+{
+    if (m_pJournal && m_pJournal->IsMounted())
+    {
+        JournalReadings();
+        return;
+    }
+
+    std::array<int16_t, R> readings{};
+
+    while (!m_Source.Empty())
+    {
+        const auto count = m_Source.Pop(readings);
+        const auto room  = S - m_Store.Size();
+
+        // Bounded; the oldest are sacrificed to make room for the newest.
+        if (count > room)
+        {
+            std::array<int16_t, R> discarded{};
+
+            m_DiscardedReadingCount += m_Store.Pop(std::span<int16_t>(discarded.data(), count - room));
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            m_Store.Push(readings[i]);
+        }
+    }
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+void NuerteyTelemetryPublisher<C, B, R, P, S>::JournalReadings()
+{
+    std::array<int16_t, R> readings{};
+
+    while (!m_Source.Empty())
+    {
+        const auto timestamp = FirstReadingTimestamp(m_Source.Size());
+        const auto count     = m_Source.Pop(readings);
+
+        // Page-batched; the odd page program, or erase, is absorbed by
+        // the ring buffer.
+        m_pJournal->Append(timestamp, static_cast<uint32_t>(m_SamplePeriod.count()),
+                           std::span<const int16_t>(readings.data(), count));
+    }
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::IsJournalCaughtUp() const
+{
+    return (!m_pJournal || !m_pJournal->IsMounted() || m_pJournal->IsCaughtUp());
+}
+
+// Packs into the free slots; returns false should the pool run out with
+// ring buffer readings yet to pack. The stored backlog predates whatever
+// is in the ring buffer, hence goes first, with the ring buffer's readings
+// queued in behind it until it is cleared.
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::PackAvailable(const bool& partial)
+{
+    // As with the RAM store below, only that the journal may also hold
+    // readings from before a reboot.
+    if (!IsJournalCaughtUp())
+    {
+        StoreReadings();
+
+        while (!m_pJournal->IsCaughtUp())
+        {
+            if (m_PendingCount >= P)
+            {
+                return true;
+            }
+
+            // The partially filled page is the last to be replayed.
+            if (!m_pJournal->HasProgrammedPagesToReplay() && !m_pJournal->Sync())
+            {
+                return true;
+            }
+
+            if (!PackJournalPage() && !m_pJournal->HasProgrammedPagesToReplay())
+            {
+                break;
+            }
+        }
+    }
+
+    if (!m_Store.Empty())
+    {
+        StoreReadings();
+
+        while (!m_Store.Empty())
+        {
+            if (!PackBatch(m_Store, std::min(m_Store.Size(), BACKLOG_READINGS_PER_MESSAGE),
+                           m_Store.Size() + m_Source.Size()))
+            {
+                // The rest of the backlog waits for the next tick.
+                return true;
+            }
+        }
+    }
+
+    // Complete batches only, unless partial.
+    while (m_Source.Size() >= (partial ? 1 : R))
+    {
+        if (!PackBatch(m_Source, std::min(m_Source.Size(), R), m_Source.Size()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+template <typename Q>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::PackBatch(Q& queue, const std::size_t& count, const std::size_t& backlog)
+{
+    if (m_PendingCount >= P)
+    {
+        return false;
+    }
+
+    std::array<int16_t, BACKLOG_READINGS_PER_MESSAGE> readings{};
+
+    const auto timestamp = FirstReadingTimestamp(backlog);
+    const auto drained   = queue.Pop(std::span<int16_t>(readings.data(), std::min(count, readings.size())));
+
+    return EnqueueBatch(timestamp, std::span<const int16_t>(readings.data(), drained));
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::PackJournalPage()
+{
+    std::array<int16_t, JOURNAL_READINGS_PER_PAGE> readings{};
+    JournalPageHeader_t page{};
+
+    const auto count = m_pJournal->Replay(page, readings);
+
+    if ((count == 0) || !EnqueueBatch(page.timestamp, std::span<const int16_t>(readings.data(), count)))
+    {
+        return false;
+    }
+
+    // The batch just enqueued; acknowledged to the journal once published.
+    auto& slot = m_Slots[(m_NextPublish + m_PendingCount - 1) % P];
+    slot.journaled = true;
+    slot.lastSequenceNumber = page.sequenceNumber + page.count - 1;
+
+    return true;
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+bool NuerteyTelemetryPublisher<C, B, R, P, S>::EnqueueBatch(const uint32_t& timestamp, std::span<const int16_t> readings)
+{
+    if (m_PendingCount >= P)
+    {
+        return false;
+    }
+
+    TelemetryBatchHeader_t header{};
+    header.sequenceNumber = m_SequenceNumber;
+    header.timestamp      = timestamp;
+    header.samplePeriod   = static_cast<uint32_t>(m_SamplePeriod.count());
+
+    auto& slot = m_Slots[(m_NextPublish + m_PendingCount) % P];
+    auto length = EncodeTelemetryBatch(m_Encoding, slot.payload, header, readings);
+
+    // By construction, the payload is large enough for a full batch.
+    MBED_ASSERT(length > 0);
+
+    slot.message.payloadlen = length;
+    slot.journaled = false;
+    m_PendingCount++;
+    m_SequenceNumber++;
+
+    return true;
+}
+
+// The newest reading is taken to be from about now, hence the oldest of
+// a backlog, i.e. the first of the batch, is backlog - 1 sample periods
+// earlier.
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+uint32_t NuerteyTelemetryPublisher<C, B, R, P, S>::FirstReadingTimestamp(const std::size_t& backlog) const
+{
+    const auto firstReading = Kernel::Clock::now() 
+        - (m_SamplePeriod * (std::max<int64_t>(static_cast<int64_t>(backlog), 1) - 1));
+
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        firstReading.time_since_epoch()).count());
+}
+
+template <typename C, typename B, std::size_t R, std::size_t P, std::size_t S>
+void NuerteyTelemetryPublisher<C, B, R, P, S>::PublishPending()
+{
+    while (m_PendingCount > 0)
+    {
+        auto& slot = m_Slots[m_NextPublish];
+
+        // Blocks, for QoS 1, until the PUBACK is in.
+        const auto sent = Kernel::Clock::now();
+        int rc = 0;
+        {
+            INSTRUMENT_SCOPE(Probe_t::MQTT_PUBLISH);
+            rc = m_Client.publish(m_pTopic, slot.message);
+        }
+
+        const auto latency = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            Kernel::Clock::now() - sent).count());
+
+        m_PublishLatency.store(latency);
+        m_MaximumPublishLatency.store(std::max(latency, m_MaximumPublishLatency.load()));
+
+        if (rc != 0)
+        {
+            // Keep the slot, and the order, for a retry on the next tick.
+            m_PublishFailureCount++;
+
+            g_STDIOMutex.lock();
+            printf("[%s]: Error! MQTT publish returned: [%d] -> %s\n",
+                __PRETTY_FUNCTION__, rc,
+                ToString(ToEnum<MQTTConnectionError_t>(rc)).data());
+            g_STDIOMutex.unlock();
+
+            // The client drops the session on a failed publish; have it
+            // brought back up.
+            if (m_pConnectionManager && !m_Client.isConnected())
+            {
+                m_pConnectionManager->ReportSessionLost();
+            }
+            break;
+        }
+
+        if (slot.journaled)
+        {
+            m_pJournal->Acknowledge(slot.lastSequenceNumber);
+            slot.journaled = false;
+        }
+
+        slot.message.payloadlen = 0;
+        m_NextPublish = (m_NextPublish + 1) % P;
+        m_PendingCount--;
+        m_PublishedMessageCount++;
+    }
+}
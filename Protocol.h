@@ -37,6 +37,22 @@
 
 #include "Utilities.h"
 
+// CMSIS-DSP is not bundled with Mbed OS 6. Where the application does
+// provide it (e.g. the mbed-dsp library), the block conversion kernels
+// use its Cortex-M7 optimized routines; otherwise, a portable unrolled
+// kernel is used. Define LDE_SERIES_HAS_CMSIS_DSP=0 to force the latter.
+#ifndef LDE_SERIES_HAS_CMSIS_DSP
+    #if __has_include("arm_math.h")
+        #define LDE_SERIES_HAS_CMSIS_DSP 1
+    #else
+        #define LDE_SERIES_HAS_CMSIS_DSP 0
+    #endif
+#endif
+
+#if LDE_SERIES_HAS_CMSIS_DSP
+    #include "arm_math.h"
+#endif
+
 // \"
 // Series     Pressure Range                    Calibration
 // 
@@ -134,72 +150,565 @@ concept IsLDESeriesSPIFrameType = ((std::is_integral_v<T> && (sizeof(T) == 1))
                               
 namespace ProtocolDefinitions
 {        
+    // Reached only through a missing specialization below, and then
+    // only to make the compiler say so.
+    template <typename T>
+    inline constexpr bool NO_SPECIALIZATION_DEFINED = false;
+
     // Another benefit of such an approach is, our ScalingFactorMap is 
     // statically generated at compile-time hence useable in constexpr
-    // contexts.    
-    template <typename S>
-    struct ScalingFactorMap { static const double VALUE; };
-    
+    // contexts. Being constexpr, the static data members are implicitly
+    // inline too, so this header may be included in any number of 
+    // translation units without ODR (multiple definition) link errors.
     template <typename S>
-    const double ScalingFactorMap<S>::VALUE = 0.0;
+    struct ScalingFactorMap
+    {
+        static_assert(NO_SPECIALIZATION_DEFINED<S>,
+                      "No scale factor is defined for this LDE Series sensor type.");
+    };
     
     // Partial template specializations mimics core 'map' functionality.
     // Good and quiet thought makes programming fun and creative :).
     template <>
-    const double ScalingFactorMap<LDE_S025_U_t>::VALUE = 1200.0;
-                                                              
-    template <>                                               
-    const double ScalingFactorMap<LDE_S050_U_t>::VALUE =  600.0;
-                                                              
-    template <>                                               
-    const double ScalingFactorMap<LDE_S100_U_t>::VALUE =  300.0;
-                                                              
-    template <>                                               
-    const double ScalingFactorMap<LDE_S250_U_t>::VALUE =  120.0;
-                                                              
-    template <>                                               
-    const double ScalingFactorMap<LDE_S500_U_t>::VALUE =   60.0;
-    
+    struct ScalingFactorMap<LDE_S025_U_t> { static constexpr double VALUE = 1200.0; };
+
+    template <>
+    struct ScalingFactorMap<LDE_S050_U_t> { static constexpr double VALUE =  600.0; };
+
+    template <>
+    struct ScalingFactorMap<LDE_S100_U_t> { static constexpr double VALUE =  300.0; };
+
+    template <>
+    struct ScalingFactorMap<LDE_S250_U_t> { static constexpr double VALUE =  120.0; };
+
+    template <>
+    struct ScalingFactorMap<LDE_S500_U_t> { static constexpr double VALUE =   60.0; };
+
     template <>
-    const double ScalingFactorMap<LDE_S025_B_t>::VALUE = 1200.0;
+    struct ScalingFactorMap<LDE_S025_B_t> { static constexpr double VALUE = 1200.0; };
 
     template <>
-    const double ScalingFactorMap<LDE_S050_B_t>::VALUE =  600.0;
-                                                              
-    template <>                                               
-    const double ScalingFactorMap<LDE_S100_B_t>::VALUE =  300.0;
-                                                              
-    template <>                                               
-    const double ScalingFactorMap<LDE_S250_B_t>::VALUE =  120.0;
-                                                              
-    template <>                                               
-    const double ScalingFactorMap<LDE_S500_B_t>::VALUE =   60.0;
+    struct ScalingFactorMap<LDE_S050_B_t> { static constexpr double VALUE =  600.0; };
+
+    template <>
+    struct ScalingFactorMap<LDE_S100_B_t> { static constexpr double VALUE =  300.0; };
+
+    template <>
+    struct ScalingFactorMap<LDE_S250_B_t> { static constexpr double VALUE =  120.0; };
+
+    template <>
+    struct ScalingFactorMap<LDE_S500_B_t> { static constexpr double VALUE =   60.0; };
     
     // \" Scale factor TS = 95 counts/°C \"
     constexpr double TEMPERATURE_SCALING_FACTOR = 95.0; 
 
     // \" Gas correction factors (6) \"    
     template <IsAtmosphericMediumType A>
-    struct GasCorrectionFactor { static const double value; };
-    
-    template <IsAtmosphericMediumType A>
-    const double GasCorrectionFactor<A>::value = 0.0;
+    struct GasCorrectionFactor
+    {
+        static_assert(NO_SPECIALIZATION_DEFINED<A>,
+                      "No gas correction factor is defined for this atmospheric medium.");
+    };
     
     template <>
-    const double GasCorrectionFactor<DryAirAtmosphere_t>::value = 1.0;
-                                                                       
-    template <>                                                        
-    const double GasCorrectionFactor<OxygenGasAtmosphere_t>::value = 1.07;
-                                                                       
-    template <>                                                        
-    const double GasCorrectionFactor<NitrogenGasAtmosphere_t>::value = 0.97;
-                                                                       
-    template <>                                                        
-    const double GasCorrectionFactor<ArgonGasAtmosphere_t>::value = 0.98;
-                                                              
-    template <>                                               
-    const double GasCorrectionFactor<CarbonDioxideAtmosphere_t>::value = 0.56;
+    struct GasCorrectionFactor<DryAirAtmosphere_t>        { static constexpr double value = 1.0;  };
+
+    template <>
+    struct GasCorrectionFactor<OxygenGasAtmosphere_t>     { static constexpr double value = 1.07; };
+
+    template <>
+    struct GasCorrectionFactor<NitrogenGasAtmosphere_t>   { static constexpr double value = 0.97; };
+
+    template <>
+    struct GasCorrectionFactor<ArgonGasAtmosphere_t>      { static constexpr double value = 0.98; };
+
+    template <>
+    struct GasCorrectionFactor<CarbonDioxideAtmosphere_t> { static constexpr double value = 0.56; };
+
+    // \" ΔPeff = ΔPSensor x gas correction factor \", where ΔPSensor is
+    // in turn the counts divided by the scale factor. Both are folded,
+    // at compile-time, into the one coefficient (i.e. the reciprocal of
+    // the scale factor pre-multiplied by the gas correction factor) so
+    // that each conversion costs precisely a single multiply.
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    struct PressureCoefficient
+    {
+        static_assert(ScalingFactorMap<S>::VALUE > 0.0,
+                      "Unsupported LDE Series sensor type; scale factor must be positive.");
+        static_assert(GasCorrectionFactor<A>::value > 0.0,
+                      "Unsupported atmospheric medium; gas correction factor must be positive.");
+
+        static constexpr double VALUE = GasCorrectionFactor<A>::value / ScalingFactorMap<S>::VALUE;
+    };
     
+    // Signed Q16.16 fixed-point, i.e. the value multiplied by 2^16. At
+    // the largest full-scale (±500 Pa x 1.07) and temperature readings
+    // this leaves ample integer headroom.
+    using FixedPoint_t = int32_t;
+    constexpr int FIXED_POINT_FRACTIONAL_BITS = 16;
+
+    constexpr double FixedPointToDouble(const FixedPoint_t& value)
+    {
+        return (static_cast<double>(value)
+              / static_cast<double>(Utilities::pown<int64_t>(2, FIXED_POINT_FRACTIONAL_BITS)));
+    }
+
+    // Fixed-point conversion multiplies by a coefficient pre-scaled with
+    // an additional 2^15 of precision, in a 64-bit product (a single
+    // SMULL on the Cortex-M7), then rounds that extra precision away.
+    constexpr int FIXED_POINT_COEFFICIENT_EXTRA_BITS = 15;
+
+    constexpr int32_t MakeFixedPointCoefficient(const double& coefficient)
+    {
+        constexpr double SCALE = static_cast<double>(int64_t{1} 
+                    << (FIXED_POINT_FRACTIONAL_BITS + FIXED_POINT_COEFFICIENT_EXTRA_BITS));
+        
+        // Round half away from zero, as std::lround() would, but constexpr.
+        return static_cast<int32_t>((coefficient * SCALE) + ((coefficient < 0.0) ? -0.5 : 0.5));
+    }
+
+    constexpr FixedPoint_t MakeFixedPoint(const double& value)
+    {
+        constexpr double SCALE = static_cast<double>(int64_t{1} << FIXED_POINT_FRACTIONAL_BITS);
+        
+        return static_cast<FixedPoint_t>((value * SCALE) + ((value < 0.0) ? -0.5 : 0.5));
+    }
+
+    constexpr FixedPoint_t ApplyFixedPointCoefficient(const int16_t& counts,
+                                                   const int32_t& coefficient,
+                                                   const FixedPoint_t& offset = 0)
+    {
+        constexpr int64_t ROUNDING = (int64_t{1} << (FIXED_POINT_COEFFICIENT_EXTRA_BITS - 1));
+
+        return (static_cast<FixedPoint_t>((static_cast<int64_t>(counts) * coefficient + ROUNDING)
+                   >> FIXED_POINT_COEFFICIENT_EXTRA_BITS) + offset);
+    }
+
+    // Fixed notation straight from Q16.16, in integer arithmetic only;
+    // handy where the float conversions are to be avoided altogether.
+    inline std::string_view FormatFixedPoint(std::span<char> buffer,
+                                             const FixedPoint_t& value,
+                                             const int& decimalDigits = 2)
+    {
+        if ((decimalDigits < 0) || (decimalDigits > Utilities::MAXIMUM_FORMAT_DECIMAL_DIGITS))
+        {
+            return Utilities::FormatFailure(buffer);
+        }
+
+        // Round half away from zero on the way out of Q16.16.
+        constexpr int64_t ROUNDING = (int64_t{1} << (FIXED_POINT_FRACTIONAL_BITS - 1));
+
+        const int64_t scaled = static_cast<int64_t>(value) 
+                             * Utilities::pown<int64_t>(10, static_cast<unsigned>(decimalDigits));
+        const int64_t rounded = (scaled < 0) 
+                              ? -((-scaled + ROUNDING) >> FIXED_POINT_FRACTIONAL_BITS)
+                              :  ((scaled + ROUNDING) >> FIXED_POINT_FRACTIONAL_BITS);
+
+        return Utilities::FormatScaledInteger(buffer, rounded, decimalDigits);
+    }
+
+    // The block (i.e. bulk) kernel underlying all float conversions:
+    //
+    // values[i] = counts[i] x scale + offset
+    //
+    // As many samples are converted as both spans allow, and that number
+    // is returned. The spans must not overlap.
+    inline std::size_t ScaleAndOffsetBlock(std::span<const int16_t> counts,
+                                           std::span<float> values,
+                                           const float& scale,
+                                           const float& offset = 0.0f)
+    {
+        const auto count = std::min(counts.size(), values.size());
+        
+#if LDE_SERIES_HAS_CMSIS_DSP
+        // arm_q15_to_float() divides by 2^15, which is folded back into
+        // the scale. Both CMSIS-DSP routines may operate in place.
+        constexpr float Q15_SCALE = 32768.0f;
+        const auto blockSize = static_cast<uint32_t>(count);
+        
+        arm_q15_to_float(reinterpret_cast<const q15_t*>(counts.data()), values.data(), blockSize);
+        arm_scale_f32(values.data(), scale * Q15_SCALE, values.data(), blockSize);
+        
+        if (offset != 0.0f)
+        {
+            arm_offset_f32(values.data(), offset, values.data(), blockSize);
+        }
+#else
+        // We build at -Os, where GCC will not unroll on our behalf. Four 
+        // samples per iteration keeps the Cortex-M7's dual-issue FPU 
+        // pipeline busy with independent VCVT/VMLA pairs.
+        const int16_t* __restrict pSource = counts.data();
+        float* __restrict pDestination = values.data();
+        std::size_t i = 0;
+        
+        for (; (i + 4) <= count; i += 4)
+        {
+            const float a = static_cast<float>(pSource[i]);
+            const float b = static_cast<float>(pSource[i + 1]);
+            const float c = static_cast<float>(pSource[i + 2]);
+            const float d = static_cast<float>(pSource[i + 3]);
+            
+            pDestination[i]     = a * scale + offset;
+            pDestination[i + 1] = b * scale + offset;
+            pDestination[i + 2] = c * scale + offset;
+            pDestination[i + 3] = d * scale + offset;
+        }
+        
+        for (; i < count; ++i)
+        {
+            pDestination[i] = static_cast<float>(pSource[i]) * scale + offset;
+        }
+#endif
+        return count;
+    }
+
+    // The lazy conversion layer. Buffers hold nothing but the 2-byte raw
+    // counts; conversion to floating- or fixed-point is deferred until
+    // the values are actually consumed, and then preferably in bulk. The
+    // per-sample cost is one single-precision (or integer) multiply, as
+    // the coefficients are all folded at compile-time.
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    struct PressureConversion
+    {
+        static constexpr float   COEFFICIENT = static_cast<float>(PressureCoefficient<S, A>::VALUE);
+        static constexpr int32_t FIXED_POINT_COEFFICIENT 
+                                     = MakeFixedPointCoefficient(PressureCoefficient<S, A>::VALUE);
+
+        static constexpr float ToFloat(const int16_t& counts)
+        {
+            return (static_cast<float>(counts) * COEFFICIENT);
+        }
+
+        static constexpr FixedPoint_t ToFixedPoint(const int16_t& counts)
+        {
+            return ApplyFixedPointCoefficient(counts, FIXED_POINT_COEFFICIENT);
+        }
+
+        // Bulk variants; convert as many as both spans allow and return that number.
+        static std::size_t ToFloat(std::span<const int16_t> counts, std::span<float> values)
+        {
+            return ScaleAndOffsetBlock(counts, values, COEFFICIENT);
+        }
+
+        static std::size_t ToFixedPoint(std::span<const int16_t> counts, std::span<FixedPoint_t> values)
+        {
+            const auto count = std::min(counts.size(), values.size());
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                values[i] = ApplyFixedPointCoefficient(counts[i], FIXED_POINT_COEFFICIENT);
+            }
+            return count;
+        }
+    };
+
+    template <IsTemperatureScaleType T>
+    struct TemperatureConversion
+    {
+        // °C = counts / TS; °F = °C x 9/5 + 32; K = °C + 273. Expressed
+        // uniformly as counts x scale + offset:
+        static constexpr double Scale()
+        {
+            if constexpr (std::is_same_v<T, Fahrenheit_t>)
+            {
+                return (9.0 / (5.0 * TEMPERATURE_SCALING_FACTOR));
+            }
+            else
+            {
+                return (1.0 / TEMPERATURE_SCALING_FACTOR);
+            }
+        }
+
+        static constexpr double Offset()
+        {
+            if constexpr (std::is_same_v<T, Fahrenheit_t>)
+            {
+                return 32.0;
+            }
+            else if constexpr (std::is_same_v<T, Kelvin_t>)
+            {
+                return 273.0;
+            }
+            else
+            {
+                return 0.0;
+            }
+        }
+
+        static constexpr float        SCALE  = static_cast<float>(Scale());
+        static constexpr float        OFFSET = static_cast<float>(Offset());
+        static constexpr int32_t      FIXED_POINT_SCALE  = MakeFixedPointCoefficient(Scale());
+        static constexpr FixedPoint_t FIXED_POINT_OFFSET = MakeFixedPoint(Offset());
+
+        static constexpr float ToFloat(const int16_t& counts)
+        {
+            return (static_cast<float>(counts) * SCALE + OFFSET);
+        }
+
+        static constexpr FixedPoint_t ToFixedPoint(const int16_t& counts)
+        {
+            return ApplyFixedPointCoefficient(counts, FIXED_POINT_SCALE, FIXED_POINT_OFFSET);
+        }
+
+        static std::size_t ToFloat(std::span<const int16_t> counts, std::span<float> values)
+        {
+            return ScaleAndOffsetBlock(counts, values, SCALE, OFFSET);
+        }
+
+        static std::size_t ToFixedPoint(std::span<const int16_t> counts, std::span<FixedPoint_t> values)
+        {
+            const auto count = std::min(counts.size(), values.size());
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                values[i] = ToFixedPoint(counts[i]);
+            }
+            return count;
+        }
+    };
+
+    // Raw-count sample types. The sensor range and gas medium travel in
+    // the type rather than in the sample, so each one costs but 2 bytes.
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    struct RawPressure_t
+    {
+        int16_t counts;
+
+        constexpr float        ToFloat() const { return PressureConversion<S, A>::ToFloat(counts); }
+        constexpr FixedPoint_t ToFixedPoint() const { return PressureConversion<S, A>::ToFixedPoint(counts); }
+    };
+
+    struct RawTemperature_t
+    {
+        int16_t counts;
+
+        template <IsTemperatureScaleType T>
+        constexpr float ToFloat() const { return TemperatureConversion<T>::ToFloat(counts); }
+
+        template <IsTemperatureScaleType T>
+        constexpr FixedPoint_t ToFixedPoint() const { return TemperatureConversion<T>::ToFixedPoint(counts); }
+    };
+
+    static_assert(sizeof(RawPressure_t<LDE_S250_B_t, DryAirAtmosphere_t>) == sizeof(int16_t));
+    static_assert(sizeof(RawTemperature_t) == sizeof(int16_t));
+
+    // Convenience spellings of the bulk conversions, for post-processing
+    // whole blocks of buffered samples in one call.
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    inline std::size_t ConvertPressureBlock(std::span<const int16_t> counts, std::span<float> values)
+    {
+        return PressureConversion<S, A>::ToFloat(counts, values);
+    }
+
+    template <IsTemperatureScaleType T>
+    inline std::size_t ConvertTemperatureBlock(std::span<const int16_t> counts, std::span<float> values)
+    {
+        return TemperatureConversion<T>::ToFloat(counts, values);
+    }
+
+    // Runtime counterpart of the sensor range and gas medium tag types,
+    // for heterogeneous device arrays. Every such device is then served
+    // by the one non-template acquisition path, rather than by a copy of
+    // it per sensor/gas type combination. Descriptors are generated from
+    // the tag types at compile-time and so reside in flash.
+    struct LDESeriesDescriptor_t
+    {
+        double       preciseCoefficient;    // As coefficient, for the double API.
+        float        scalingFactor;         // Counts per Pa, i.e. the sensor range.
+        float        gasCorrectionFactor;
+        float        coefficient;           // Pa per count, gas medium folded in.
+        int32_t      fixedPointCoefficient;
+
+        constexpr float ToFloat(const int16_t& counts) const
+        {
+            return (static_cast<float>(counts) * coefficient);
+        }
+
+        constexpr double ToDouble(const int16_t& counts) const
+        {
+            return (static_cast<double>(counts) * preciseCoefficient);
+        }
+
+        constexpr FixedPoint_t ToFixedPoint(const int16_t& counts) const
+        {
+            return ApplyFixedPointCoefficient(counts, fixedPointCoefficient);
+        }
+
+        std::size_t ToFloat(std::span<const int16_t> counts, std::span<float> values) const
+        {
+            return ScaleAndOffsetBlock(counts, values, coefficient);
+        }
+    };
+
+    static_assert(std::is_trivially_copyable_v<LDESeriesDescriptor_t>);
+    static_assert(sizeof(LDESeriesDescriptor_t) == 24);
+
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    constexpr LDESeriesDescriptor_t MakeLDESeriesDescriptor()
+    {
+        return LDESeriesDescriptor_t{PressureCoefficient<S, A>::VALUE,
+                                     static_cast<float>(ScalingFactorMap<S>::VALUE),
+                                     static_cast<float>(GasCorrectionFactor<A>::value),
+                                     PressureConversion<S, A>::COEFFICIENT,
+                                     PressureConversion<S, A>::FIXED_POINT_COEFFICIENT};
+    }
+
+    template <IsLDESeriesSensorType S, IsAtmosphericMediumType A>
+    inline constexpr LDESeriesDescriptor_t LDE_SERIES_DESCRIPTOR = MakeLDESeriesDescriptor<S, A>();
+
+    // \" (6) For example with a LDES500... sensor measuring CO2 gas, at 
+    // full-scale output the actual pressure will be: 
+    //
+    // ΔPeff = ΔPSensor x gas correction factor = 500 Pa x 0.56 = 280 Pa \"
+    static_assert(PressureConversion<LDE_S500_B_t, CarbonDioxideAtmosphere_t>::ToFixedPoint(30000) 
+               == MakeFixedPoint(280.0));
+    static_assert(LDE_SERIES_DESCRIPTOR<LDE_S500_B_t, CarbonDioxideAtmosphere_t>.ToFixedPoint(30000)
+               == MakeFixedPoint(280.0));
+    static_assert(LDE_SERIES_DESCRIPTOR<LDE_S500_B_t, CarbonDioxideAtmosphere_t>.ToDouble(30000)
+               == 30000 * PressureCoefficient<LDE_S500_B_t, CarbonDioxideAtmosphere_t>::VALUE);
+
+    // Temperature compensation. The pressure counts are corrected, still
+    // in counts, as counts x gain + offset, where the gain and offset are
+    // per-device and a function of the raw temperature counts.
+    //
+    // The function is given as calibration points, between which it is
+    // interpolated linearly, and is sampled at compile-time onto a grid
+    // of 2^shift temperature counts per entry. The table so generated
+    // resides in flash, and a lookup is but a subtraction, a shift and a
+    // clamp; there is neither search nor interpolation, let alone any
+    // transcendental maths, per sample.
+    struct TemperatureCalibrationPoint_t
+    {
+        int16_t temperatureCounts;
+        float   gain;
+        float   offset;              // Counts.
+    };
+
+    struct TemperatureCompensationEntry_t
+    {
+        float gain;
+        float offset;
+
+        constexpr float Apply(const int16_t& counts) const
+        {
+            return (static_cast<float>(counts) * gain + offset);
+        }
+    };
+
+    // Corrected counts, rounded back to the nearest that the int16 wire
+    // format can carry.
+    constexpr int16_t SaturateToCounts(const float& counts)
+    {
+        const float rounded = counts + ((counts < 0.0f) ? -0.5f : 0.5f);
+
+        return static_cast<int16_t>(std::clamp(rounded, static_cast<float>(INT16_MIN),
+                                                        static_cast<float>(INT16_MAX)));
+    }
+
+    // At 95 counts/°C, the defaults span -43 °C to +129 °C in steps of
+    // about 1.35 °C, in 1 KiB of flash.
+    constexpr int16_t     DEFAULT_COMPENSATION_BASE_COUNTS = -4096;
+    constexpr uint8_t     DEFAULT_COMPENSATION_SHIFT       = 7;
+    constexpr std::size_t DEFAULT_COMPENSATION_ENTRIES     = 128;
+
+    // Non-owning, and type-erased of the table size, for whoever need
+    // not know it, e.g. interrupt handlers.
+    struct TemperatureCompensationView_t
+    {
+        int16_t                                         baseCounts;
+        uint8_t                                         shift;
+        std::span<const TemperatureCompensationEntry_t> entries;
+
+        // Temperatures off either end of the grid take the end entries.
+        constexpr const TemperatureCompensationEntry_t& Lookup(const int16_t& temperatureCounts) const
+        {
+            const int32_t index = (static_cast<int32_t>(temperatureCounts) - baseCounts) >> shift;
+            const int32_t last  = static_cast<int32_t>(entries.size()) - 1;
+
+            return entries[static_cast<std::size_t>(std::clamp<int32_t>(index, 0, last))];
+        }
+
+        constexpr float Apply(const int16_t& pressureCounts, const int16_t& temperatureCounts) const
+        {
+            return Lookup(temperatureCounts).Apply(pressureCounts);
+        }
+    };
+
+    template <std::size_t N = DEFAULT_COMPENSATION_ENTRIES>
+    struct TemperatureCompensationTable_t
+    {
+        static_assert(N > 0);
+
+        int16_t                                       baseCounts;
+        uint8_t                                       shift;
+        std::array<TemperatureCompensationEntry_t, N> entries;
+
+        constexpr TemperatureCompensationView_t View() const
+        {
+            return TemperatureCompensationView_t{baseCounts, shift, entries};
+        }
+
+        constexpr float Apply(const int16_t& pressureCounts, const int16_t& temperatureCounts) const
+        {
+            return View().Apply(pressureCounts, temperatureCounts);
+        }
+    };
+
+    // Points sorted by temperature; beyond the first and the last, the
+    // correction is held constant rather than extrapolated.
+    template <std::size_t N = DEFAULT_COMPENSATION_ENTRIES, std::size_t M>
+    constexpr TemperatureCompensationTable_t<N> MakeTemperatureCompensationTable(
+        const std::array<TemperatureCalibrationPoint_t, M>& points,
+        const int16_t& baseCounts = DEFAULT_COMPENSATION_BASE_COUNTS,
+        const uint8_t& shift = DEFAULT_COMPENSATION_SHIFT)
+    {
+        static_assert(M > 0);
+
+        TemperatureCompensationTable_t<N> table{baseCounts, shift, {}};
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            // Each entry holds for its cell, hence is sampled at the centre of it.
+            const float t = static_cast<float>(baseCounts) 
+                          + (static_cast<float>(i) + 0.5f) * static_cast<float>(1 << shift);
+
+            std::size_t j = 0;
+            while (((j + 1) < M) && (points[j + 1].temperatureCounts <= t))
+            {
+                ++j;
+            }
+
+            if ((t <= points[0].temperatureCounts) || ((j + 1) == M))
+            {
+                const auto& point = (t <= points[0].temperatureCounts) ? points[0] : points[M - 1];
+                table.entries[i] = TemperatureCompensationEntry_t{point.gain, point.offset};
+            }
+            else
+            {
+                const auto& a = points[j];
+                const auto& b = points[j + 1];
+                const float fraction = (t - a.temperatureCounts) 
+                                     / static_cast<float>(b.temperatureCounts - a.temperatureCounts);
+
+                table.entries[i] = TemperatureCompensationEntry_t{
+                    a.gain + (b.gain - a.gain) * fraction,
+                    a.offset + (b.offset - a.offset) * fraction};
+            }
+        }
+
+        return table;
+    }
+
+    // No correction at all, for devices yet to be characterized.
+    inline constexpr auto IDENTITY_TEMPERATURE_COMPENSATION 
+        = MakeTemperatureCompensationTable<1>(std::array{TemperatureCalibrationPoint_t{0, 1.0f, 0.0f}});
+
+    static_assert(IDENTITY_TEMPERATURE_COMPENSATION.Apply(1234, 2375) == 1234.0f);
+    static_assert((SaturateToCounts(-2.5f) == -3) && (SaturateToCounts(40000.0f) == INT16_MAX));
+    static_assert(MakeTemperatureCompensationTable(std::array{
+                      TemperatureCalibrationPoint_t{0,    1.0f,  0.0f},
+                      TemperatureCalibrationPoint_t{3200, 1.0f, 64.0f}}).Apply(0, 1600) == 32.0f);
+
     // \"
     // Data read – pressure
     //
@@ -234,39 +743,124 @@ namespace ProtocolDefinitions
     constexpr char       LDE_SERIES_SPI_DUMMY_BYTE {0x00};
     constexpr SPIFrame_t LDE_SERIES_SPI_DUMMY_FRAME{0x00, 0x00};
 
+    // A command sequence is simply the concatenation, in bus order, of
+    // the individual frames that make up one complete exchange with the
+    // device. Being a std::array, it is composed entirely at compile-time
+    // and can be clocked out in one single SPI transaction, with the
+    // Slave Select line asserted but once.
+    template <std::size_t N>
+    using SPICommandSequence_t = std::array<char, N>;
+
     template <IsLDESeriesSPIFrameType T>
-    inline void DisplaySPIFrame(const T& frame)
-    {        
-        if constexpr(std::is_same_v<T, SPIFrame_t>)
+    constexpr std::size_t SPIFrameSize()
+    {
+        if constexpr (std::is_same_v<T, SPIFrame_t>)
         {
-            if (!frame.empty())
-            {
-                std::ostringstream oss;
+            return NUMBER_OF_SPI_FRAME_BYTES;
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
+    template <IsLDESeriesSPIFrameType... Frames>
+    constexpr auto MakeCommandSequence(const Frames&... frames)
+    {
+        SPICommandSequence_t<(SPIFrameSize<Frames>() + ...)> sequence{};
+        std::size_t index{0};
 
-                oss << "\n\t0x";
-                for (auto& byte : frame)
+        auto append = [&sequence, &index](const auto& frame)
+        {
+            if constexpr (std::is_same_v<std::decay_t<decltype(frame)>, SPIFrame_t>)
+            {
+                for (const auto& byte : frame)
                 {
-                    oss << std::setfill('0') << std::setw(2) << std::hex 
-                        << std::uppercase << static_cast<unsigned>(byte);
+                    sequence[index++] = byte;
                 }
-                oss << '\n';
-                
-                printf("%s\n", oss.str().c_str());
             }
+            else
+            {
+                sequence[index++] = static_cast<char>(frame);
+            }
+        };
+
+        (append(frames), ...);
+
+        return sequence;
+    }
+
+    // \" To initiate data transfer from the sensor, the following three
+    // unique bytes must be written sequentially, MSB first, to the MOSI
+    // pin \" ... \" The entire 16 bit content of the LDE register is then
+    // read out on the MISO pin \"
+    constexpr auto PRESSURE_READ_SEQUENCE = MakeCommandSequence(
+                       static_cast<char>(POLL_CURRENT_PRESSURE_MEASUREMENT),
+                       static_cast<char>(SEND_RESULT_TO_DATA_REGISTER),
+                       static_cast<char>(READ_DATA_REGISTER),
+                       LDE_SERIES_SPI_DUMMY_FRAME);
+
+    constexpr auto TEMPERATURE_READ_SEQUENCE = MakeCommandSequence(
+                       static_cast<char>(POLL_CURRENT_TEMPERATURE_MEASUREMENT),
+                       static_cast<char>(SEND_RESULT_TO_DATA_REGISTER),
+                       static_cast<char>(READ_DATA_REGISTER),
+                       LDE_SERIES_SPI_DUMMY_FRAME);
+
+    // The same exchanges split at the point where the sensor latches its
+    // measurement. Between the poll and the read-out, /CS may be released
+    // and the bus put to use with another device on it.
+    constexpr auto PRESSURE_POLL_SEQUENCE = MakeCommandSequence(
+                       static_cast<char>(POLL_CURRENT_PRESSURE_MEASUREMENT));
+
+    constexpr auto TEMPERATURE_POLL_SEQUENCE = MakeCommandSequence(
+                       static_cast<char>(POLL_CURRENT_TEMPERATURE_MEASUREMENT));
+
+    constexpr auto RESULT_READOUT_SEQUENCE = MakeCommandSequence(
+                       static_cast<char>(SEND_RESULT_TO_DATA_REGISTER),
+                       static_cast<char>(READ_DATA_REGISTER),
+                       LDE_SERIES_SPI_DUMMY_FRAME);
+
+    // Both read sequences share the one shape:
+    using LDESeriesReadSequence_t = std::decay_t<decltype(PRESSURE_READ_SEQUENCE)>;
+
+    static_assert(std::is_same_v<LDESeriesReadSequence_t,
+                                 std::decay_t<decltype(TEMPERATURE_READ_SEQUENCE)>>);
+
+    // The response to a read sequence carries the register contents in
+    // its trailing frame; everything before it is the sensor's echo of
+    // the command bytes and is of no interest.
+    template <std::size_t N>
+    inline SPIFrame_t ExtractResponseFrame(const SPICommandSequence_t<N>& response)
+    {
+        static_assert(N >= NUMBER_OF_SPI_FRAME_BYTES);
+
+        return SPIFrame_t{response[N - 2], response[N - 1]};
+    }
+
+    // Renders a frame, or a single command byte, as hexadecimal into the
+    // caller's buffer; no heap, no iostreams.
+    template <IsLDESeriesSPIFrameType T>
+    inline std::string_view FormatSPIFrame(std::span<char> buffer, const T& frame)
+    {
+        if constexpr(std::is_same_v<T, SPIFrame_t>)
+        {
+            return Utilities::FormatHex(buffer, std::span<const char>(frame));
         }
         else
         {
-            std::ostringstream oss;
-
-            oss << "\n\t0x";
-            oss << std::setfill('0') << std::setw(2) << std::hex 
-                << std::uppercase << static_cast<unsigned>(frame);    
-            oss << '\n';
-            
-            printf("%s\n", oss.str().c_str());
+            const char byte = static_cast<char>(frame);
+            return Utilities::FormatHex(buffer, std::span<const char>(&byte, 1));
         }
     }
 
+    template <IsLDESeriesSPIFrameType T>
+    inline void DisplaySPIFrame(const T& frame)
+    {        
+        Utilities::FormatBuffer_t buffer{};
+
+        printf("\n\t%s\n\n", FormatSPIFrame(buffer, frame).data());
+    }
+
     inline int16_t Deserialize(const SPIFrame_t& frame)
     {
         // \" (10) The digital output signal is a signed, two complement
@@ -0,0 +1,128 @@
+/***********************************************************************
+* @file      SPSCRingBuffer.h
+*
+*    Single-producer/single-consumer lock-free ring buffer, suitable for
+*    handing data from an ISR (the producer) to a thread (the consumer),
+*    or vice versa, without either side ever taking a mutex or entering
+*    a critical section.
+*
+* @brief
+*
+* @note    The producer only ever writes m_Head and the consumer only
+*          ever writes m_Tail. Each side reads the other's index with
+*          acquire semantics and publishes its own with release
+*          semantics, which is all the ordering that is required on a
+*          single-core Cortex-M. The indices are free-running and are
+*          masked on access, hence the capacity must be a power of two.
+*
+* @warning Exactly one producer context and one consumer context. If
+*          several threads must drain the buffer, serialize them above
+*          this class, never inside the ISR.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <span>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+namespace Utilities
+{
+    template <typename T, std::size_t N>
+    class SPSCRingBuffer
+    {
+        static_assert((N >= 2) && ((N & (N - 1)) == 0),
+                      "Capacity must be a power of two.");
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Elements are copied in and out from interrupt context.");
+        static_assert(std::atomic<std::size_t>::is_always_lock_free,
+                      "Indices must be lock-free to be usable from an ISR.");
+
+        static constexpr std::size_t MASK = N - 1;
+
+    public:
+        SPSCRingBuffer() = default;
+
+        SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+        SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+        static constexpr std::size_t Capacity() { return N; }
+
+        // Producer side. Returns false, leaving the buffer untouched, if
+        // it is full; the caller decides whether that counts as a drop.
+        bool Push(const T& item)
+        {
+            const auto head = m_Head.load(std::memory_order_relaxed);
+            const auto tail = m_Tail.load(std::memory_order_acquire);
+
+            if ((head - tail) == N)
+            {
+                return false;
+            }
+
+            m_Buffer[head & MASK] = item;
+            m_Head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Consumer side.
+        bool Pop(T& item)
+        {
+            const auto tail = m_Tail.load(std::memory_order_relaxed);
+            const auto head = m_Head.load(std::memory_order_acquire);
+
+            if (head == tail)
+            {
+                return false;
+            }
+
+            item = m_Buffer[tail & MASK];
+            m_Tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Consumer side. Drains up to items.size() elements in one go,
+        // publishing the new tail but once. Returns the number drained.
+        std::size_t Pop(std::span<T> items)
+        {
+            const auto tail = m_Tail.load(std::memory_order_relaxed);
+            const auto head = m_Head.load(std::memory_order_acquire);
+
+            const auto count = std::min<std::size_t>(head - tail, items.size());
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                items[i] = m_Buffer[(tail + i) & MASK];
+            }
+
+            m_Tail.store(tail + count, std::memory_order_release);
+
+            return count;
+        }
+
+        // Either side. Only a snapshot, as the other side may be running.
+        std::size_t Size() const
+        {
+            return (m_Head.load(std::memory_order_acquire)
+                  - m_Tail.load(std::memory_order_acquire));
+        }
+
+        bool Empty() const { return (Size() == 0); }
+        bool Full() const { return (Size() == N); }
+
+    private:
+        std::array<T, N>           m_Buffer{};
+        std::atomic<std::size_t>   m_Head{0};
+        std::atomic<std::size_t>   m_Tail{0};
+    };
+} // End of namespace Utilities.
@@ -0,0 +1,310 @@
+/***********************************************************************
+* @file      SignalProcessing.h
+*
+*    Allocation-free, streaming signal processing building blocks, each
+*    fed one sample at a time at a cost fixed per sample:
+*
+*    - CICDecimator, an M-stage cascaded integrator-comb decimator. No
+*      multiplies at all; M integer additions per input sample and M
+*      subtractions per output sample.
+*    - FIRDecimator, a T-tap windowed-sinc low-pass FIR that is only
+*      evaluated for the samples it keeps, i.e. T multiply-accumulates
+*      per output sample, or T/R per input sample.
+*    - FirstOrderLowPass, the exponential smoother y += a (x - y).
+*    - WindowStatistics, the count, min, max, sum and sum of squares of
+*      a window of raw counts, from which the mean, RMS and variance.
+*
+* @brief
+*
+* @note    The CIC integrators are deliberately unsigned, hence wrap
+*          modulo 2^64 rather than overflow. As long as the register is
+*          wider than the worst-case output, 16 + M log2(R) bits, the
+*          combs undo any such wraparound exactly.
+*
+*          WindowStatistics accumulates in integers, and is thus exact
+*          regardless of the window length; the floating-point division
+*          is left to the once per window that the results are read.
+*
+* @warning The CIC response droops towards the output Nyquist frequency,
+*          and aliases more than the FIR does; it is the better choice
+*          for high decimation ratios, the FIR for low ones.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include <cmath>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+
+namespace Utilities
+{
+    template <std::size_t M = 3>
+    class CICDecimator
+    {
+        static_assert(M > 0);
+
+    public:
+        CICDecimator() { Configure(1); }
+
+        void Configure(const uint16_t& decimation)
+        {
+            m_Decimation = std::max<uint16_t>(decimation, 1);
+
+            // The DC gain, (RD)^M, with a differential delay D of 1.
+            double gain = 1.0;
+            for (std::size_t i = 0; i < M; ++i)
+            {
+                gain *= m_Decimation;
+            }
+            m_InverseGain = static_cast<float>(1.0 / gain);
+
+            Reset();
+        }
+
+        void Reset()
+        {
+            m_Integrators.fill(0);
+            m_Combs.fill(0);
+            m_Phase = 0;
+        }
+
+        // Returns true, output having been written, every R'th input.
+        bool Push(const int16_t& input, float& output)
+        {
+            m_Integrators[0] += static_cast<uint64_t>(static_cast<int64_t>(input));
+
+            for (std::size_t i = 1; i < M; ++i)
+            {
+                m_Integrators[i] += m_Integrators[i - 1];
+            }
+
+            if (++m_Phase < m_Decimation)
+            {
+                return false;
+            }
+            m_Phase = 0;
+
+            uint64_t value = m_Integrators[M - 1];
+
+            for (std::size_t i = 0; i < M; ++i)
+            {
+                const uint64_t difference = value - m_Combs[i];
+                m_Combs[i] = value;
+                value = difference;
+            }
+
+            output = static_cast<float>(static_cast<int64_t>(value)) * m_InverseGain;
+            return true;
+        }
+
+        uint16_t GetDecimation() const { return m_Decimation; }
+
+    private:
+        std::array<uint64_t, M>  m_Integrators{};
+        std::array<uint64_t, M>  m_Combs{};
+        uint16_t                 m_Decimation{1};
+        uint16_t                 m_Phase{0};
+        float                    m_InverseGain{1.0f};
+    };
+
+    template <std::size_t T = 32>
+    class FIRDecimator
+    {
+        static_assert(T > 0);
+
+    public:
+        // Of the output Nyquist frequency; the remainder is the transition band.
+        static constexpr float PASSBAND_FRACTION = 0.8f;
+
+        FIRDecimator() { Configure(1); }
+
+        // Designs a Hamming-windowed sinc low-pass for the ratio, of unity
+        // DC gain. A ratio of 1 makes it a pass-through.
+        void Configure(const uint16_t& decimation)
+        {
+            m_Decimation = std::max<uint16_t>(decimation, 1);
+
+            if (m_Decimation == 1)
+            {
+                m_Coefficients.fill(0.0f);
+                m_Coefficients[T - 1] = 1.0f;
+            }
+            else
+            {
+                constexpr float PI = std::numbers::pi_v<float>;
+                const float cutoff = PASSBAND_FRACTION * 0.5f / m_Decimation; // Cycles per sample.
+                const float centre = 0.5f * (T - 1);
+                float sum = 0.0f;
+
+                for (std::size_t k = 0; k < T; ++k)
+                {
+                    const float x = static_cast<float>(k) - centre;
+                    const float sinc = (x == 0.0f) ? (2.0f * cutoff)
+                                                   : (std::sin(2.0f * PI * cutoff * x) / (PI * x));
+                    const float window = (T > 1) ? (0.54f - 0.46f * std::cos(2.0f * PI * k / (T - 1))) : 1.0f;
+
+                    m_Coefficients[k] = sinc * window;
+                    sum += m_Coefficients[k];
+                }
+
+                for (auto& coefficient : m_Coefficients)
+                {
+                    coefficient /= sum;
+                }
+            }
+
+            Reset();
+        }
+
+        void Reset()
+        {
+            m_History.fill(0.0f);
+            m_Index = 0;
+            m_Phase = 0;
+        }
+
+        bool Push(const float& input, float& output)
+        {
+            // Written twice over, so that the last T inputs always lie
+            // contiguously, oldest first, from m_Index onwards.
+            m_History[m_Index] = input;
+            m_History[m_Index + T] = input;
+            m_Index = (m_Index + 1) % T;
+
+            if (++m_Phase < m_Decimation)
+            {
+                return false;
+            }
+            m_Phase = 0;
+
+            const float* pHistory = &m_History[m_Index];
+            float accumulator = 0.0f;
+
+            for (std::size_t k = 0; k < T; ++k)
+            {
+                accumulator += m_Coefficients[k] * pHistory[k];
+            }
+
+            output = accumulator;
+            return true;
+        }
+
+        uint16_t GetDecimation() const { return m_Decimation; }
+
+    private:
+        std::array<float, T>      m_Coefficients{};
+        std::array<float, 2 * T>  m_History{};
+        std::size_t               m_Index{0};
+        uint16_t                  m_Decimation{1};
+        uint16_t                  m_Phase{0};
+    };
+
+    class FirstOrderLowPass
+    {
+    public:
+        // A cutoff of zero, or at or above Nyquist, disables the filter.
+        void Configure(const float& cutoff, const float& sampleRate)
+        {
+            m_Alpha = ((cutoff <= 0.0f) || (sampleRate <= 0.0f) || ((2.0f * cutoff) >= sampleRate))
+                    ? 1.0f
+                    : (1.0f - std::exp(-2.0f * std::numbers::pi_v<float> * cutoff / sampleRate));
+            Reset();
+        }
+
+        void Reset() { m_Primed = false; }
+
+        float Filter(const float& input)
+        {
+            // Primed with the first input, rather than slewing up from zero.
+            if (!m_Primed)
+            {
+                m_Output = input;
+                m_Primed = true;
+            }
+            else
+            {
+                m_Output += m_Alpha * (input - m_Output);
+            }
+            return m_Output;
+        }
+
+        float GetAlpha() const { return m_Alpha; }
+
+    private:
+        float m_Alpha{1.0f};
+        float m_Output{0.0f};
+        bool  m_Primed{false};
+    };
+
+    class WindowStatistics
+    {
+    public:
+        void Reset()
+        {
+            m_Count = 0;
+            m_Sum = 0;
+            m_SumOfSquares = 0;
+        }
+
+        void Add(const int16_t& value)
+        {
+            if (m_Count == 0)
+            {
+                m_Minimum = value;
+                m_Maximum = value;
+            }
+            else
+            {
+                m_Minimum = std::min(m_Minimum, value);
+                m_Maximum = std::max(m_Maximum, value);
+            }
+
+            m_Sum += value;
+            m_SumOfSquares += static_cast<int32_t>(value) * value;
+            m_Count++;
+        }
+
+        uint32_t GetCount() const { return m_Count; }
+        int16_t  GetMinimum() const { return m_Minimum; }
+        int16_t  GetMaximum() const { return m_Maximum; }
+        int64_t  GetSum() const { return m_Sum; }
+        int64_t  GetSumOfSquares() const { return m_SumOfSquares; }
+
+        double GetMean() const
+        {
+            return (m_Count ? (static_cast<double>(m_Sum) / m_Count) : 0.0);
+        }
+
+        double GetRootMeanSquare() const
+        {
+            return (m_Count ? std::sqrt(static_cast<double>(m_SumOfSquares) / m_Count) : 0.0);
+        }
+
+        // Of the population, i.e. over N.
+        double GetVariance() const
+        {
+            if (m_Count == 0)
+            {
+                return 0.0;
+            }
+
+            const double mean = GetMean();
+            return std::max(0.0, (static_cast<double>(m_SumOfSquares) / m_Count) - (mean * mean));
+        }
+
+    private:
+        uint32_t m_Count{0};
+        int16_t  m_Minimum{0};
+        int16_t  m_Maximum{0};
+        int64_t  m_Sum{0};
+        int64_t  m_SumOfSquares{0};
+    };
+} // End of namespace Utilities.
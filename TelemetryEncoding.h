@@ -0,0 +1,169 @@
+/***********************************************************************
+* @file      TelemetryEncoding.h
+*
+*    Payload encodings for batches of LDE Series raw counts, written
+*    into caller-provided buffers without any heap allocation.
+*
+*    JSON, for backends that must have it:
+*
+*    {"seq":7,"t":123456,"dt":1000,"counts":[-12,40,...]}
+*
+*    A packed binary record, for metered (e.g. cellular) links; all
+*    fields little-endian:
+*
+*    Offset  Size  Field
+*    0       1     Magic, 'L'
+*    1       1     Version, 1
+*    2       2     Number of readings, N
+*    4       4     Sequence number
+*    8       4     Timestamp of the first reading, ms since boot
+*    12      4     Sample period, us; reading i was taken at t + (i x dt)
+*    16      2N    Raw counts, int16 two's complement
+*
+* @brief
+*
+* @note    The binary record is a third or less the size of the JSON for
+*          typical readings, and costs but two byte stores per value to
+*          produce, versus the decimal formatting of the JSON.
+*
+* @author    Nuertey Odzeyem
+*
+* @date      November 28, 2021
+*
+* @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
+***********************************************************************/
+#pragma once
+
+#include "JSONStreamWriter.h"
+#include "Instrumentation.h"
+
+namespace Utilities
+{
+    enum class TelemetryEncoding_t : uint8_t
+    {
+        JSON,
+        BINARY
+    };
+
+    struct TelemetryBatchHeader_t
+    {
+        uint32_t sequenceNumber;
+        uint32_t timestamp;      // ms since boot, of the first reading.
+        uint32_t samplePeriod;   // us between successive readings.
+    };
+
+    // The JSON batch header, as a compile-time schema.
+    inline constexpr auto TELEMETRY_BATCH_HEADER_SCHEMA = std::make_tuple(
+        JSONField_t<TelemetryBatchHeader_t, uint32_t>{"seq", &TelemetryBatchHeader_t::sequenceNumber},
+        JSONField_t<TelemetryBatchHeader_t, uint32_t>{"t",   &TelemetryBatchHeader_t::timestamp},
+        JSONField_t<TelemetryBatchHeader_t, uint32_t>{"dt",  &TelemetryBatchHeader_t::samplePeriod});
+
+    static_assert(IsPlainJSONSchema(TELEMETRY_BATCH_HEADER_SCHEMA));
+
+    constexpr uint8_t     BINARY_TELEMETRY_MAGIC       = 'L';
+    constexpr uint8_t     BINARY_TELEMETRY_VERSION     = 1;
+    constexpr std::size_t BINARY_TELEMETRY_HEADER_SIZE = 16;
+
+    // {"seq":4294967295,"t":4294967295,"dt":4294967295,"counts":[]} and
+    // the NUL, plus at most six characters and a separator per reading.
+    constexpr std::size_t JSON_TELEMETRY_HEADER_CAPACITY = 64;
+
+    constexpr std::size_t JSONBatchCapacity(const std::size_t& readings)
+    {
+        return (JSON_TELEMETRY_HEADER_CAPACITY + (readings * 7));
+    }
+
+    constexpr std::size_t BinaryBatchCapacity(const std::size_t& readings)
+    {
+        return (BINARY_TELEMETRY_HEADER_SIZE + (readings * sizeof(int16_t)));
+    }
+
+    constexpr std::size_t TelemetryBatchCapacity(const std::size_t& readings)
+    {
+        return std::max(JSONBatchCapacity(readings), BinaryBatchCapacity(readings));
+    }
+
+    template <std::unsigned_integral T>
+    inline char* StoreLittleEndian(char* pDestination, const T& value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            *pDestination++ = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        return pDestination;
+    }
+
+    template <std::unsigned_integral T>
+    inline T LoadLittleEndian(const char* pSource)
+    {
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            value |= static_cast<T>(static_cast<T>(static_cast<uint8_t>(pSource[i])) << (8 * i));
+        }
+        return value;
+    }
+
+    // Each returns the number of bytes written, or zero should the
+    // buffer be too small for the batch.
+    inline std::size_t EncodeBinaryBatch(std::span<char> buffer,
+                                         const TelemetryBatchHeader_t& header,
+                                         std::span<const int16_t> readings)
+    {
+        const auto length = BinaryBatchCapacity(readings.size());
+
+        if ((buffer.size() < length) || (readings.size() > UINT16_MAX))
+        {
+            return 0;
+        }
+
+        auto p = buffer.data();
+
+        *p++ = static_cast<char>(BINARY_TELEMETRY_MAGIC);
+        *p++ = static_cast<char>(BINARY_TELEMETRY_VERSION);
+        p = StoreLittleEndian(p, static_cast<uint16_t>(readings.size()));
+        p = StoreLittleEndian(p, header.sequenceNumber);
+        p = StoreLittleEndian(p, header.timestamp);
+        p = StoreLittleEndian(p, header.samplePeriod);
+
+        for (const auto& reading : readings)
+        {
+            p = StoreLittleEndian(p, static_cast<uint16_t>(reading));
+        }
+
+        return length;
+    }
+
+    inline std::size_t EncodeJSONBatch(std::span<char> buffer,
+                                       const TelemetryBatchHeader_t& header,
+                                       std::span<const int16_t> readings)
+    {
+        INSTRUMENT_SCOPE(Probe_t::JSON_SERIALIZATION);
+
+        JSONStreamWriter writer(buffer);
+
+        writer.BeginObject();
+        WriteJSONMembers(writer, TELEMETRY_BATCH_HEADER_SCHEMA, header);
+
+        writer.Key("counts").BeginArray();
+        for (const auto& reading : readings)
+        {
+            writer.Value(reading);
+        }
+        writer.EndArray().EndObject();
+
+        return (writer.Good() ? writer.Size() : 0);
+    }
+
+    inline std::size_t EncodeTelemetryBatch(const TelemetryEncoding_t& encoding,
+                                            std::span<char> buffer,
+                                            const TelemetryBatchHeader_t& header,
+                                            std::span<const int16_t> readings)
+    {
+        if (encoding == TelemetryEncoding_t::BINARY)
+        {
+            return EncodeBinaryBatch(buffer, header, readings);
+        }
+        return EncodeJSONBatch(buffer, header, readings);
+    }
+} // End of namespace Utilities.
@@ -1,16 +1,43 @@
 #include "Utilities.h"
+#include "JSONStreamWriter.h"
+#include "Instrumentation.h"
 
 namespace Utilities
 {
-    // System identification and composed statistics variables.
-    std::string                      g_NetworkInterfaceInfo;
-    std::string                      g_SystemProfile;
-    std::string                      g_BaseRegisterValues;
-    std::string                      g_HeapStatistics;
+    MessagePool_t                    g_MessagePool;
 
     // By default enough buffer space for 32 Callbacks, i.e. 32*EVENTS_EVENT_SIZE
     // Reduce this amount if the target device has severely limited RAM.
     EventQueue                       gs_MasterEventQueue;
+
+    // Sensor work alone, isolated from gs_MasterEventQueue rather than
+    // chained to it, so that a TLS handshake or a DNS lookup there cannot
+    // hold up, say, the pipeline here. Nothing posted to this queue may
+    // block, be it on the network, a sleep_for() or the console; it runs
+    // above lwIP, and each pass is to be short and bounded. Publishing,
+    // printing and the low-power bursts stay on gs_MasterEventQueue.
+    //
+    // The sampling itself is timed by the Ticker and SPI completion IRQs,
+    // hence its jitter is that of interrupt latency, microseconds, come
+    // what may; this thread is for draining and processing the readings,
+    // which must keep up with the ring buffer however busy the network.
+    //
+    // Stack budget, of ACQUISITION_THREAD_STACK_SIZE (4 KiB by default,
+    // main() having 12 KiB): the dispatch loop and a queued Callback,
+    // ~0.5 KiB; a pipeline or trigger pass, its 64-reading block on the
+    // stack and the filter state in the object, ~0.5 KiB; the rest, with
+    // no printf() here, is headroom.
+    // Check it with mbed_stats_stack_get_each() after a soak, and raise
+    // acquisition-thread-stack-size in mbed_app.json should it run short.
+    EventQueue                       gs_AcquisitionEventQueue(16 * EVENTS_EVENT_SIZE);
+
+    // Statically allocated, so that the budget is accounted for in .bss
+    // at link time rather than being found short of heap at runtime.
+    MBED_ALIGN(8) static unsigned char gs_AcquisitionThreadStack[ACQUISITION_THREAD_STACK_SIZE];
+    Thread                           gs_AcquisitionThread(ACQUISITION_THREAD_PRIORITY,
+                                                          ACQUISITION_THREAD_STACK_SIZE,
+                                                          gs_AcquisitionThreadStack,
+                                                          "Acquisition");
     int                              gs_NetworkDisconnectEventIdentifier(0);
     int                              gs_SensorEventIdentifier(0);
     int                              gs_HTTPEventIdentifier(0);
@@ -19,9 +46,6 @@ namespace Utilities
     int                              gs_PrimeEventIdentifier(0);
     int                              gs_CloudCommunicationsEventIdentifier(0);
 
-    size_t                           g_MessageLength = 0;
-    std::unique_ptr<MQTT::Message>   g_pMessage; // MQTT messages' lifeline must last until yield occurs for actual transmission.
-
     // Protect the platform STDIO object so it is shared politely between 
     // threads, periodic events and periodic callbacks (not in IRQ context
     // but when safely translated into the EventQueue context). Essentially,
@@ -29,7 +53,23 @@ namespace Utilities
     PlatformMutex                    g_STDIOMutex; 
     EthernetInterface                g_EthernetInterface;
     //NTPClient                        g_NTPClient(&g_EthernetInterface);
-    NuerteyNTPClient                 g_NTPClient(&g_EthernetInterface);
+
+    // Shared by the NTP client, and by whatever else connects by name.
+    NuerteyDNSCache                  g_DNSCache(&g_EthernetInterface, &gs_MasterEventQueue);
+    NuerteyNTPClient                 g_NTPClient(&g_EthernetInterface, &gs_MasterEventQueue, &g_DNSCache);
+
+    // Disciplined UTC for the sample timestamps, polled off the NTP server.
+    NuerteyClockService              g_ClockService(&g_NTPClient, &gs_MasterEventQueue);
+
+    // Reconnects, with exponential backoff, after the link has flapped,
+    // and tells its observers, the clock service foremost, as it does.
+    NuerteyConnectionManager         g_ConnectionManager(&g_EthernetInterface, &gs_MasterEventQueue);
+
+    // The MQTT session atop the Ethernet interface, as (re)established by
+    // the connection manager; the telemetry publisher publishes through it.
+    TCPSocket                        g_MQTTSocket;
+    MQTTNetworkMbedOs                g_MQTTNetwork(&g_MQTTSocket);
+    MQTTClient_t                     g_MQTTClient(g_MQTTNetwork);
 
     void NetworkStatusCallback(nsapi_event_t status, intptr_t param)
     {
@@ -51,20 +91,6 @@ namespace Utilities
         case NSAPI_STATUS_DISCONNECTED:
             printf("Socket disconnected from network!\r\n");
             g_STDIOMutex.unlock();
-
-            // Since disconnection has been detected, cancel the periodic
-            // task of attempting to publish acquired sensor MQTT data.
-            if (gs_SensorEventIdentifier)
-            {
-                gs_MasterEventQueue.cancel(gs_SensorEventIdentifier);
-            }
-
-            // TBD, Nuertey Odzeyem; what about cancelling gs_NetworkDisconnectEventIdentifier? cancelAll()??
-
-            // TBD, Nuertey Odzeyem; does the embedded application's
-            // requirements necessarily warrant me performing such an action?
-            // It is 'embedded' after all and I may just want to 'run forever'.
-            gs_MasterEventQueue.break_dispatch();
             break;
         case NSAPI_STATUS_CONNECTING:
             printf("Connecting to network!\r\n");
@@ -75,43 +101,263 @@ namespace Utilities
             g_STDIOMutex.unlock();
             break;
         }
+
+        // Rather than cancelling the acquisition and breaking the dispatch
+        // of gs_MasterEventQueue, as was, the session is simply brought
+        // back up once the link allows. Acquisition carries on meanwhile.
+        g_ConnectionManager.OnNetworkStatus(status, param);
     }
 
+    // No longer scheduled by the second; the connection manager tracks the
+    // link off NetworkStatusCallback() and supervises but as a watchdog,
+    // every NETWORK_WATCHDOG_PERIOD_MSECS. Kept for an on-demand check.
     void NetworkDisconnectQuery()
     {
-        //printf("About to query if socket disconnected from network!\r\n");
+        g_ConnectionManager.Supervise();
+    }
 
-        if (NSAPI_STATUS_DISCONNECTED == g_EthernetInterface.get_connection_status())
+    bool EstablishMQTTSession()
+    {
+        // Whatever session there was is gone; start afresh on a new socket.
+        if (g_MQTTClient.isConnected())
         {
-            // Since disconnection has been detected, cancel the periodic
-            // task of attempting to publish acquired sensor MQTT data.
-            if (gs_SensorEventIdentifier)
-            {
-                g_STDIOMutex.lock();
-                printf("Cancelling Sensor Acquisition Event on gs_MasterEventQueue!\r\n");
-                g_STDIOMutex.unlock();
-                gs_MasterEventQueue.cancel(gs_SensorEventIdentifier);
-            }
+            g_MQTTClient.disconnect();
+        }
+        g_MQTTSocket.close();
 
-            // TBD, Nuertey Odzeyem; what about cancelling gs_NetworkDisconnectEventIdentifier? cancelAll()??
+        SocketAddress brokerAddress;
+        nsapi_error_t status = g_DNSCache.Resolve(MQTT_BROKER_HOST_NAME, &brokerAddress);
 
-            //printf("Breaking gs_MasterEventQueue dispatch!\r\n");
+        if (status == NSAPI_ERROR_OK)
+        {
+            brokerAddress.set_port(MQTT_BROKER_PORT);
+            status = g_MQTTSocket.open(&g_EthernetInterface);
+        }
 
-            // TBD, Nuertey Odzeyem; does the embedded application's
-            // requirements necessarily warrant me performing such an action?
-            // It is 'embedded' after all and I may just want to 'run forever'.
-            //gs_MasterEventQueue.break_dispatch();
+        if (status == NSAPI_ERROR_OK)
+        {
+            status = g_MQTTSocket.connect(brokerAddress);
         }
+
+        if (status != NSAPI_ERROR_OK)
+        {
+            g_STDIOMutex.lock();
+            printf("[%s]: Error! Connecting to %s returned: [%d] -> %s\n",
+                __PRETTY_FUNCTION__, MQTT_BROKER_HOST_NAME, status, ToString(status).data());
+            g_STDIOMutex.unlock();
+            g_MQTTSocket.close();
+            return false;
+        }
+
+        MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
+        connectData.MQTTVersion       = 4; // 3.1.1
+        connectData.clientID.cstring  = const_cast<char *>(MQTT_CLIENT_IDENTIFIER);
+        connectData.keepAliveInterval = MQTT_KEEP_ALIVE_INTERVAL;
+        connectData.cleansession      = 1;
+
+        const int rc = g_MQTTClient.connect(connectData);
+
+        if (rc != MQTT::SUCCESS)
+        {
+            g_STDIOMutex.lock();
+            printf("[%s]: Error! MQTT connect returned: [%d] -> %s\n",
+                __PRETTY_FUNCTION__, rc, ToString(ToEnum<MQTTConnectionError_t, int>(rc)).data());
+            g_STDIOMutex.unlock();
+            g_MQTTSocket.close();
+            return false;
+        }
+
+        return true;
+    }
+
+    // On every watchdog period; yielding to the client has it ping the
+    // broker, and so keeps the session alive through lulls in publishing.
+    bool IsMQTTSessionAlive()
+    {
+        g_MQTTClient.yield(10);
+
+        return g_MQTTClient.isConnected();
+    }
+
+    // Each section is streamed straight into the writer; the alphabetic
+    // key prefixes are kept from the picojson days, when they were what
+    // ordered the (sorted) keys in the preferred display format.
+    void WriteNetworkInterfaceInfo(JSONStreamWriter& writer)
+    {
+        // Show the network address:
+        SocketAddress socketAddress;
+        g_EthernetInterface.get_ip_address(&socketAddress);
+        const char * ip = socketAddress.get_ip_address();
+        
+        SocketAddress socketAddress1;
+        g_EthernetInterface.get_netmask(&socketAddress1);        
+        const char * netmask = socketAddress1.get_ip_address();
+        
+        SocketAddress socketAddress2;
+        g_EthernetInterface.get_gateway(&socketAddress2);
+        const char * gateway = socketAddress2.get_ip_address();
+        
+        // "Provided MAC address is intended for info or debug purposes
+        // and may be not provided if the underlying network interface
+        // does not provide a MAC address."
+        const char * mac = g_EthernetInterface.get_mac_address();
+
+        char timeBuffer[32];
+        time_t seconds = time(NULL);
+        std::size_t length = std::strftime(timeBuffer, sizeof(timeBuffer), 
+                                           "%Y-%m-%d %H:%M:%S", std::localtime(&seconds));
+
+        writer.BeginObject()
+              .Member("[a] Module", "Nuertey Odzeyem - Nucleo-F767ZI Device Statistics")
+              .Member("[b] RTC Current Time", std::string_view(timeBuffer, length))
+              .Member("[c] MAC Address", mac ? mac : "None")
+              .Member("[d] IP Address", ip ? ip : "None")
+              .Member("[e] Netmask", netmask ? netmask : "None")
+              .Member("[f] Gateway", gateway ? gateway : "None")
+              .EndObject();
+    }
+
+    void WriteSystemProfile(JSONStreamWriter& writer)
+    {
+        mbed_stats_sys_t stats;
+        mbed_stats_sys_get(&stats);
+
+        const char * compiler = (stats.compiler_id == ARM) ? "ARM"
+                              : (stats.compiler_id == GCC_ARM) ? "GCC_ARM"
+                              : (stats.compiler_id == IAR) ? "IAR" : "";
+
+        writer.BeginObject();
+        #ifdef MBED_MAJOR_VERSION
+            char version[16];
+            snprintf(version, sizeof(version), "%d.%d.%d", 
+                     MBED_MAJOR_VERSION, MBED_MINOR_VERSION, MBED_PATCH_VERSION);
+            writer.Member("[g] MBED OS Version", version);
+        #endif
+        writer.Member("[h] MBED OS Version (populated only for tagged releases)", stats.os_version)
+              .Member("[i] Compiler ID", compiler)
+              .Member("[j] Compiler Version", stats.compiler_version)
+              .Member("[k] Device SystemClock (Hz)", SystemCoreClock)
+              .EndObject();
+    }
+
+    void WriteBaseRegisterValues(JSONStreamWriter& writer)
+    {
+        mbed_stats_sys_t stats;
+        mbed_stats_sys_get(&stats);
+
+        uint8_t implementer = ((stats.cpu_id >> 24) & 0xff);
+        uint8_t variant = ((stats.cpu_id >> 20) & 0x0f);
+        uint8_t architecture = ((stats.cpu_id >> 16) & 0x0f);
+        uint16_t partno = ((stats.cpu_id >> 4) & 0x0fff);
+        uint8_t revno = (stats.cpu_id & 0x0f);
+
+        const char * partName = (partno == 0x0c20) ? "Cortex-M0"
+                              : (partno == 0x0c60) ? "Cortex-M0+"
+                              : (partno == 0x0c23) ? "Cortex-M3"
+                              : (partno == 0x0c24) ? "Cortex-M4"
+                              : (partno == 0x0c27) ? "Cortex-M7"
+                              : (partno == 0x0d20) ? "Cortex-M23"
+                              : (partno == 0x0d21) ? "Cortex-M33" : "";
+
+        const char * architectureName = (architecture == 0x0c) ? "Baseline"
+                                      : (architecture == 0x0f) ? "Constant i.e. Mainline" : "";
+
+        // As IntegerToHex() would have it; zero-filled to the full width.
+        char cpuId[16];
+        char implementerId[8];
+        char revision[8];
+        snprintf(cpuId, sizeof(cpuId), "0X%08" PRIX32, static_cast<uint32_t>(stats.cpu_id));
+        snprintf(implementerId, sizeof(implementerId), "0X%02X", static_cast<unsigned>(implementer));
+        snprintf(revision, sizeof(revision), "0X%02X", static_cast<unsigned>(revno));
+
+        writer.BeginObject()
+              .Member("[l] CPUID Base Register Values (Cortex-M only supported)", cpuId)
+              .Member("[m] Implementer", (implementer == 0x41) ? "ARM" : implementerId)
+              .Member("[n] Variant", variant)
+              .Member("[o] Architecture", architectureName)
+              .Member("[p] Part Number", partName)
+              .Member("[q] Revision", revision)
+              .EndObject();
+    }
+
+    void WriteHeapStatistics(JSONStreamWriter& writer)
+    {
+        // Note that enabling heap statistics (effected in mbed_app.json)
+        // MAY expose a 'Memory out-of-bound access' vulnerability due
+        // to integer overflow. Hence it is NOT recommended that you 
+        // enable in production software. Fixed in Mbed OS 5.15.7 and 6.9. 
+        //
+        // https://os.mbed.com/blog/entry/Memory-out-of-bound-access-vulnerability/ 
+        mbed_stats_heap_t heapStats;
+        mbed_stats_heap_get(&heapStats);
+
+        writer.BeginObject()
+              .Member("[r] Bytes allocated on heap", heapStats.current_size)
+              .Member("[s] Maximum bytes allocated on heap at one time since reset", heapStats.max_size)
+              .Member("[t] Cumulative sum of bytes allocated on heap not freed", heapStats.total_size)
+              .Member("[u] Number of bytes reserved for heap", heapStats.reserved_size)
+              .Member("[v] Number of allocations not freed since reset", heapStats.alloc_cnt)
+              .Member("[w] Number of failed allocations since reset", heapStats.alloc_fail_cnt);
+
+        // Alongside, the pool the messages, these among them, come from.
+        const auto poolStats = g_MessagePool.GetStatistics();
+
+        writer.Member("[x] Bytes in use of message pool, of its capacity", poolStats.inUse)
+              .Member("[y] Maximum bytes in use of message pool at one time", poolStats.highWater)
+              .Member("[z] Number of message pool allocations that fell back to the heap", poolStats.fallbacks)
+              .EndObject();
+    }
+
+    std::tuple<std::pmr::string, std::pmr::string, std::pmr::string, std::pmr::string> ComposeSystemStatistics()
+    {
+        // Large enough for the largest prettified section, and so, less
+        // its terminator, for a pool block. Being static, it lives in .bss
+        // rather than on the (main) stack.
+        static std::array<char, SYSTEM_STATISTICS_SECTION_SIZE> buffer;
+
+        auto compose = [](void (*write)(JSONStreamWriter&))
+        {
+            JSONStreamWriter writer(buffer, true);
+            write(writer);
+
+            if (!writer.Good())
+            {
+                printf("[%s]: Error! System statistics section truncated.\n", 
+                    __PRETTY_FUNCTION__);
+            }
+            return std::pmr::string(writer.View(), &g_MessagePool);
+        };
+
+        return std::make_tuple(compose(&WriteNetworkInterfaceInfo),
+                               compose(&WriteSystemProfile),
+                               compose(&WriteBaseRegisterValues),
+                               compose(&WriteHeapStatistics));
     }
 
     // To prevent order of initialization defects.
     bool InitializeGlobalResources()
     {
-        // Defensive programming; start from a clean slate.
-        g_pMessage.reset();
-
         randLIB_seed_random();
 
+        // Ahead of the first probe, and of the clock service.
+        EnableCycleCounter();
+
+        // Timestamps run off the RTC from now, network or no network;
+        // the NTP discipline starts once the network is up.
+        g_ClockService.Anchor();
+
+        // Ahead of the network, which acquisition does not depend upon.
+        osStatus threadStatus = gs_AcquisitionThread.start(
+            callback(&gs_AcquisitionEventQueue, &EventQueue::dispatch_forever));
+
+        if (threadStatus != osOK)
+        {
+            g_STDIOMutex.lock();
+            printf("\r\n\r\nError! gs_AcquisitionThread.start() returned: [%d]\n", threadStatus);
+            g_STDIOMutex.unlock();
+            return false;
+        }
+
         //g_pNetworkInterface = NetworkInterface::get_default_instance();
         //
         //if (!g_pNetworkInterface)
@@ -132,7 +378,7 @@ namespace Utilities
         if (status < NSAPI_ERROR_OK)
         {
             g_STDIOMutex.lock();
-            printf("\r\n\r\nError! g_EthernetInterface.connect() returned: [%d] -> %s\n", status, ToString(status).c_str());
+            printf("\r\n\r\nError! g_EthernetInterface.connect() returned: [%d] -> %s\n", status, ToString(status).data());
             g_STDIOMutex.unlock();
             return false;
         }
@@ -145,8 +391,11 @@ namespace Utilities
             //g_NTPClient.set_server("time.google.com", 123);
             //time_t now = g_NTPClient.get_timestamp();
             //set_time(now);
-            g_NTPClient.SynchronizeRTCTimestamp();
-            std::tie(g_NetworkInterfaceInfo, g_SystemProfile, g_BaseRegisterValues, g_HeapStatistics) = ComposeSystemStatistics();
+            // The first poll, on gs_MasterEventQueue, steps the RTC too.
+            g_ClockService.Start();
+            g_ConnectionManager.SetSession(EstablishMQTTSession, IsMQTTSessionAlive);
+            g_ConnectionManager.Subscribe(mbed::callback(&g_ClockService, &NuerteyClockService::OnLinkStateChanged));
+            g_ConnectionManager.Start();
             return true;
         }
     }
@@ -154,8 +403,21 @@ namespace Utilities
     // For symmetry and to encourage correct and explicit cleanups.
     void ReleaseGlobalResources()
     {
-        // Bring down the Ethernet interface.
+        g_ConnectionManager.Stop();
+        g_ClockService.Stop();
+
+        // Bring down the MQTT session, then the Ethernet interface.
+        if (g_MQTTClient.isConnected())
+        {
+            g_MQTTClient.disconnect();
+        }
+        g_MQTTSocket.close();
+
         g_EthernetInterface.disconnect();
+
+        // Whatever work is already queued is abandoned.
+        gs_AcquisitionEventQueue.break_dispatch();
+        gs_AcquisitionThread.join();
     }
 } // namespace
 
@@ -37,7 +37,11 @@
 #include <type_traits>
 #include <algorithm>
 #include <functional>
+#include <concepts>
+#include <charconv>
+#include <string_view>
 #include <optional>
+#include <atomic>
 #include <iomanip>
 #include <ostream>
 #include <sstream>
@@ -51,7 +55,13 @@
 #include "nsapi_types.h"
 #include "EthernetInterface.h"
 #include "MQTTClient.h"
+#include "MQTTNetworkMbedOs.h"
+#include "MQTTmbed.h"
+#include "NuerteyDNSCache.h"
 #include "NuerteyNTPClient.h"
+#include "NuerteyClockService.h"
+#include "NuerteyConnectionManager.h"
+#include "MemoryResources.h"
 //#include "mbed_mem_trace.h"
 #include "randLIB.h"
 #include "mbed_events.h"   // thread and irq safe
@@ -83,9 +93,13 @@ static const uint32_t SENSOR_ACQUISITION_PERIOD_MSECS        =  30000;
 static const uint32_t HTTP_REQUEST_PERIOD_MSECS              =  15000;
 static const uint32_t WEBSOCKET_MESSAGING_PERIOD_MSECS       =  20000;
 static const uint32_t WEBSOCKET_STREAMING_PERIOD_MSECS       =  40000;
-static const uint32_t NETWORK_DISCONNECT_QUERY_PERIOD_MSECS  =   1000;
+static const uint32_t NETWORK_WATCHDOG_PERIOD_MSECS          =  30000;
 static const uint32_t CLOUD_COMMUNICATIONS_EVENT_DELAY_MSECS =      3;
 
+// Continuous (Ticker-driven) acquisition; hundreds of Hz to a few kHz.
+static const uint32_t CONTINUOUS_ACQUISITION_PERIOD_USECS    =   1000; // 1 kHz
+static const uint32_t MINIMUM_ACQUISITION_PERIOD_USECS       =    100; // 10 kHz
+
 enum class MQTTConnectionError_t : int8_t
 {
     SUCCESS_NO_ERROR                 = 0,
@@ -110,79 +124,99 @@ enum class MQTTConnectionError_t : int8_t
     MQTTCLIENT_WRONG_MQTT_VERSION    = -16
 };
 
-using MQTTConnectionErrorMap_t = std::map<MQTTConnectionError_t, std::string>;
-using IndexElementMQTT_t       = MQTTConnectionErrorMap_t::value_type;
+// Error descriptions, as constexpr tables sorted by code, so that they
+// live in flash, cost nothing at static-init time and are looked up
+// without ever touching the heap. The descriptions are views of string
+// literals, hence NUL-terminated, and may be handed to printf() as is.
+template <typename K>
+struct ErrorDescription_t
+{
+    K                code;
+    std::string_view description;
+};
 
-inline static auto make_mqtt_connection_error_map()
+template <typename K, std::size_t N>
+constexpr bool IsSortedByCode(const std::array<ErrorDescription_t<K>, N> & table)
 {
-    MQTTConnectionErrorMap_t eMap;
-    
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::SUCCESS_NO_ERROR, std::string("\"Connection succeeded: no errors\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::UNACCEPTABLE_PROTOCOL_VERSION, std::string("\"Connection refused: Unacceptable protocol version\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::IDENTIFIER_REJECTED, std::string("\"Connection refused: Identifier rejected\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::SERVER_UNAVAILABLE, std::string("\"Connection refused: Server unavailable\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::BAD_USER_NAME_OR_PASSWORD, std::string("\"Connection refused: Bad user name or password\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::NOT_AUTHORIZED, std::string("\"Connection refused: Not authorized\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::RESERVED, std::string("\"Reserved for future use\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_FAILURE, std::string("\"Generic MQTT client operation failure\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_DISCONNECTED, std::string("\"The client is disconnected.\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_MAX_MESSAGES_INFLIGHT, std::string("\"The maximum number of messages allowed to be simultaneously in-flight has been reached.\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_BAD_UTF8_STRING, std::string("\"An invalid UTF-8 string has been detected.\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_NULL_PARAMETER, std::string("\"A NULL parameter has been supplied when this is invalid.\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_TOPICNAME_TRUNCATED, std::string("\"The topic has been truncated (the topic string includes embedded NULL characters). String functions will not access the full topic. Use the topic length value to access the full topic.\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_BAD_STRUCTURE, std::string("\"A structure parameter does not have the correct eyecatcher and version number.\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_BAD_QOS, std::string("\"A QoS value that falls outside of the acceptable range (0,1,2)\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_SSL_NOT_SUPPORTED, std::string("\"Attempting SSL connection using non-SSL version of library\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_BAD_MQTT_VERSION, std::string("\"unrecognized MQTT version\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_BAD_PROTOCOL, std::string("\"protocol prefix in serverURI should be tcp:// or ssl://\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_BAD_MQTT_OPTION, std::string("\"option not applicable to the requested version of MQTT\"")));
-    eMap.insert(IndexElementMQTT_t(MQTTConnectionError_t::MQTTCLIENT_WRONG_MQTT_VERSION, std::string("\"call not applicable to the requested version of MQTT\"")));
-
-    return eMap;
+    for (std::size_t i = 1; i < N; ++i)
+    {
+        if (!(table[i - 1].code < table[i].code))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
-static MQTTConnectionErrorMap_t gs_MQTTConnectionErrorMap_t = make_mqtt_connection_error_map();
-
-inline std::string ToString(const MQTTConnectionError_t & key)
+// Binary search; unknown codes, e.g. a byte count passed as an error, get
+// the fallback rather than std::map::at()'s abort under -fno-exceptions.
+template <typename K, std::size_t N>
+constexpr std::string_view DescribeError(const std::array<ErrorDescription_t<K>, N> & table,
+                                         const K & code, const std::string_view & fallback)
 {
-    return (gs_MQTTConnectionErrorMap_t.at(key));
-}
+    auto it = std::lower_bound(table.begin(), table.end(), code,
+        [](const ErrorDescription_t<K> & entry, const K & key) { return (entry.code < key); });
 
-using ErrorCodesMap_t = std::map<nsapi_size_or_error_t, std::string>;
-using IndexElement_t  = ErrorCodesMap_t::value_type;
+    return ((it != table.end()) && (it->code == code)) ? it->description : fallback;
+}
 
-inline static auto make_error_codes_map()
+inline constexpr std::array MQTT_CONNECTION_ERROR_DESCRIPTIONS = std::to_array<ErrorDescription_t<MQTTConnectionError_t>>({
+    {MQTTConnectionError_t::MQTTCLIENT_WRONG_MQTT_VERSION,    "\"call not applicable to the requested version of MQTT\""},
+    {MQTTConnectionError_t::MQTTCLIENT_BAD_MQTT_OPTION,       "\"option not applicable to the requested version of MQTT\""},
+    {MQTTConnectionError_t::MQTTCLIENT_BAD_PROTOCOL,          "\"protocol prefix in serverURI should be tcp:// or ssl://\""},
+    {MQTTConnectionError_t::MQTTCLIENT_BAD_MQTT_VERSION,      "\"unrecognized MQTT version\""},
+    {MQTTConnectionError_t::MQTTCLIENT_SSL_NOT_SUPPORTED,     "\"Attempting SSL connection using non-SSL version of library\""},
+    {MQTTConnectionError_t::MQTTCLIENT_BAD_QOS,               "\"A QoS value that falls outside of the acceptable range (0,1,2)\""},
+    {MQTTConnectionError_t::MQTTCLIENT_BAD_STRUCTURE,         "\"A structure parameter does not have the correct eyecatcher and version number.\""},
+    {MQTTConnectionError_t::MQTTCLIENT_TOPICNAME_TRUNCATED,   "\"The topic has been truncated (the topic string includes embedded NULL characters). String functions will not access the full topic. Use the topic length value to access the full topic.\""},
+    {MQTTConnectionError_t::MQTTCLIENT_NULL_PARAMETER,        "\"A NULL parameter has been supplied when this is invalid.\""},
+    {MQTTConnectionError_t::MQTTCLIENT_BAD_UTF8_STRING,       "\"An invalid UTF-8 string has been detected.\""},
+    {MQTTConnectionError_t::MQTTCLIENT_MAX_MESSAGES_INFLIGHT, "\"The maximum number of messages allowed to be simultaneously in-flight has been reached.\""},
+    {MQTTConnectionError_t::MQTTCLIENT_DISCONNECTED,          "\"The client is disconnected.\""},
+    {MQTTConnectionError_t::MQTTCLIENT_FAILURE,               "\"Generic MQTT client operation failure\""},
+    {MQTTConnectionError_t::SUCCESS_NO_ERROR,                 "\"Connection succeeded: no errors\""},
+    {MQTTConnectionError_t::UNACCEPTABLE_PROTOCOL_VERSION,    "\"Connection refused: Unacceptable protocol version\""},
+    {MQTTConnectionError_t::IDENTIFIER_REJECTED,              "\"Connection refused: Identifier rejected\""},
+    {MQTTConnectionError_t::SERVER_UNAVAILABLE,               "\"Connection refused: Server unavailable\""},
+    {MQTTConnectionError_t::BAD_USER_NAME_OR_PASSWORD,        "\"Connection refused: Bad user name or password\""},
+    {MQTTConnectionError_t::NOT_AUTHORIZED,                   "\"Connection refused: Not authorized\""},
+    {MQTTConnectionError_t::RESERVED,                         "\"Reserved for future use\""}});
+
+static_assert(IsSortedByCode(MQTT_CONNECTION_ERROR_DESCRIPTIONS));
+
+constexpr std::string_view ToString(const MQTTConnectionError_t & key)
 {
-    ErrorCodesMap_t eMap;
-    
-    eMap.insert(IndexElement_t(NSAPI_ERROR_OK, std::string("\"no error\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_WOULD_BLOCK, std::string("\"no data is not available but call is non-blocking\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_UNSUPPORTED, std::string("\"unsupported functionality\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_PARAMETER, std::string("\"invalid configuration\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_NO_CONNECTION, std::string("\"not connected to a network\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_NO_SOCKET, std::string("\"socket not available for use\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_NO_ADDRESS, std::string("\"IP address is not known\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_NO_MEMORY, std::string("\"memory resource not available\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_NO_SSID, std::string("\"ssid not found\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_DNS_FAILURE, std::string("\"DNS failed to complete successfully\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_DHCP_FAILURE, std::string("\"DHCP failed to complete successfully\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_AUTH_FAILURE, std::string("\"connection to access point failed\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_DEVICE_ERROR, std::string("\"failure interfacing with the network processor\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_IN_PROGRESS, std::string("\"operation (eg connect) in progress\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_ALREADY, std::string("\"operation (eg connect) already in progress\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_IS_CONNECTED, std::string("\"socket is already connected\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_CONNECTION_LOST, std::string("\"connection lost\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_CONNECTION_TIMEOUT, std::string("\"connection timed out\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_ADDRESS_IN_USE, std::string("\"Address already in use\"")));
-    eMap.insert(IndexElement_t(NSAPI_ERROR_TIMEOUT, std::string("\"operation timed out\"")));    
-    return eMap;
+    return DescribeError(MQTT_CONNECTION_ERROR_DESCRIPTIONS, key, "\"Unrecognized MQTT error\"");
 }
 
-static ErrorCodesMap_t gs_ErrorCodesMap = make_error_codes_map();
-
-inline std::string ToString(const nsapi_size_or_error_t & key)
+inline constexpr std::array NSAPI_ERROR_DESCRIPTIONS = std::to_array<ErrorDescription_t<nsapi_size_or_error_t>>({
+    {NSAPI_ERROR_BUSY,               "\"device is busy and cannot accept new operation\""},
+    {NSAPI_ERROR_TIMEOUT,            "\"operation timed out\""},
+    {NSAPI_ERROR_ADDRESS_IN_USE,     "\"Address already in use\""},
+    {NSAPI_ERROR_CONNECTION_TIMEOUT, "\"connection timed out\""},
+    {NSAPI_ERROR_CONNECTION_LOST,    "\"connection lost\""},
+    {NSAPI_ERROR_IS_CONNECTED,       "\"socket is already connected\""},
+    {NSAPI_ERROR_ALREADY,            "\"operation (eg connect) already in progress\""},
+    {NSAPI_ERROR_IN_PROGRESS,        "\"operation (eg connect) in progress\""},
+    {NSAPI_ERROR_DEVICE_ERROR,       "\"failure interfacing with the network processor\""},
+    {NSAPI_ERROR_AUTH_FAILURE,       "\"connection to access point failed\""},
+    {NSAPI_ERROR_DHCP_FAILURE,       "\"DHCP failed to complete successfully\""},
+    {NSAPI_ERROR_DNS_FAILURE,        "\"DNS failed to complete successfully\""},
+    {NSAPI_ERROR_NO_SSID,            "\"ssid not found\""},
+    {NSAPI_ERROR_NO_MEMORY,          "\"memory resource not available\""},
+    {NSAPI_ERROR_NO_ADDRESS,         "\"IP address is not known\""},
+    {NSAPI_ERROR_NO_SOCKET,          "\"socket not available for use\""},
+    {NSAPI_ERROR_NO_CONNECTION,      "\"not connected to a network\""},
+    {NSAPI_ERROR_PARAMETER,          "\"invalid configuration\""},
+    {NSAPI_ERROR_UNSUPPORTED,        "\"unsupported functionality\""},
+    {NSAPI_ERROR_WOULD_BLOCK,        "\"no data is not available but call is non-blocking\""},
+    {NSAPI_ERROR_OK,                 "\"no error\""}});
+
+static_assert(IsSortedByCode(NSAPI_ERROR_DESCRIPTIONS));
+
+constexpr std::string_view ToString(const nsapi_size_or_error_t & key)
 {
-    return (gs_ErrorCodesMap.at(key));
+    return DescribeError(NSAPI_ERROR_DESCRIPTIONS, key, "\"unrecognized network error\"");
 }
     
 template <typename T, typename U>
@@ -203,12 +237,52 @@ constexpr auto ToEnum(V value) -> E
     
 namespace Utilities
 {
-    extern std::string                      g_NetworkInterfaceInfo;
-    extern std::string                      g_SystemProfile;
-    extern std::string                      g_BaseRegisterValues;
-    extern std::string                      g_HeapStatistics;
+    // The acquisition thread's stack, as budgeted in mbed_app.json; see
+    // gs_AcquisitionThread in Utilities.cpp for what it is sized for.
+#ifdef MBED_CONF_APP_ACQUISITION_THREAD_STACK_SIZE
+    constexpr uint32_t ACQUISITION_THREAD_STACK_SIZE = MBED_CONF_APP_ACQUISITION_THREAD_STACK_SIZE;
+#else
+    constexpr uint32_t ACQUISITION_THREAD_STACK_SIZE = 4096;
+#endif
+
+    // Above main() and lwIP's tcpip thread, both osPriorityNormal, so that
+    // sensor work preempts the protocol processing; yet below the EMAC
+    // receive thread, osPriorityHigh, and the RTOS timer thread, so that
+    // neither frames nor timeouts are ever held up behind a pipeline pass.
+    constexpr osPriority ACQUISITION_THREAD_PRIORITY = osPriorityAboveNormal;
+
+    // The broker that the telemetry is published to; a public test one,
+    // for want of the installation's own.
+    constexpr const char * MQTT_BROKER_HOST_NAME    = "test.mosquitto.org";
+    constexpr uint16_t     MQTT_BROKER_PORT         = 1883;
+    constexpr const char * MQTT_CLIENT_IDENTIFIER   = "Nuertey-LDESeries-Mbed";
+    constexpr uint16_t     MQTT_KEEP_ALIVE_INTERVAL = 60; // s; twice NETWORK_WATCHDOG_PERIOD_MSECS.
+
+    // A telemetry publisher's largest batch, plus its topic and the
+    // PUBLISH headers; the client has a send and a read buffer of this.
+    constexpr int MQTT_MAXIMUM_PACKET_SIZE = 2048;
+
+    using MQTTClient_t = MQTT::Client<MQTTNetworkMbedOs, Countdown, MQTT_MAXIMUM_PACKET_SIZE>;
+
+    // The largest prettified system statistics section.
+    constexpr std::size_t SYSTEM_STATISTICS_SECTION_SIZE = 768;
+
+    // A block per message composed: at boot, the four system statistics
+    // sections, released once printed; thereafter, every period, a health
+    // record, and the one before it until the next is composed. Four, the
+    // peak, so that the one pool serves both in turn.
+    constexpr std::size_t MESSAGE_BLOCK_SIZE  = 1024;
+    constexpr std::size_t MESSAGE_BLOCK_COUNT = 4;
+
+    static_assert(SYSTEM_STATISTICS_SECTION_SIZE <= MESSAGE_BLOCK_SIZE);
+
+    using MessagePool_t = FixedBlockPool<MESSAGE_BLOCK_SIZE, MESSAGE_BLOCK_COUNT>;
+
+    extern MessagePool_t                    g_MessagePool;
 
     extern EventQueue                       gs_MasterEventQueue;
+    extern EventQueue                       gs_AcquisitionEventQueue;
+    extern Thread                           gs_AcquisitionThread;
     extern int                              gs_NetworkDisconnectEventIdentifier;
     extern int                              gs_SensorEventIdentifier;
     extern int                              gs_HTTPEventIdentifier;
@@ -217,20 +291,42 @@ namespace Utilities
     extern int                              gs_PrimeEventIdentifier;
     extern int                              gs_CloudCommunicationsEventIdentifier;
 
-    extern size_t                           g_MessageLength;
-    extern std::unique_ptr<MQTT::Message>   g_pMessage;
-
     extern PlatformMutex                    g_STDIOMutex;
     extern EthernetInterface                g_EthernetInterface;
     //extern NTPClient                        g_NTPClient;
+    extern NuerteyDNSCache                  g_DNSCache;
     extern NuerteyNTPClient                 g_NTPClient;
+    extern NuerteyClockService              g_ClockService;
+    extern NuerteyConnectionManager         g_ConnectionManager;
+    extern TCPSocket                        g_MQTTSocket;
+    extern MQTTNetworkMbedOs                g_MQTTNetwork;
+    extern MQTTClient_t                     g_MQTTClient;
 
     void NetworkStatusCallback(nsapi_event_t status, intptr_t param);
     void NetworkDisconnectQuery();
+
+    // The g_ConnectionManager session; in the gs_MasterEventQueue context.
+    bool EstablishMQTTSession();
+    bool IsMQTTSessionAlive();
+
     bool InitializeGlobalResources();
     void ReleaseGlobalResources();
 
-    // This custom clock type obtains the time from RTC too whilst noting the Processor speed.
+    // System statistics, each section as one JSON object. These stream
+    // straight into the writer; see JSONStreamWriter.h.
+    class JSONStreamWriter;
+
+    void WriteNetworkInterfaceInfo(JSONStreamWriter& writer);
+    void WriteSystemProfile(JSONStreamWriter& writer);
+    void WriteBaseRegisterValues(JSONStreamWriter& writer);
+    void WriteHeapStatistics(JSONStreamWriter& writer);
+
+    // Prettified, for display; in the order above.
+    // Allocated from g_MessagePool, a block apiece; drop them once printed.
+    std::tuple<std::pmr::string, std::pmr::string, std::pmr::string, std::pmr::string> ComposeSystemStatistics();
+
+    // This custom clock type obtains the time from the disciplined clock
+    // service, at the resolution of the Processor speed.
     struct NucleoF767ZIClock_t
     {
         using rep        = std::int64_t;
@@ -239,10 +335,13 @@ namespace Utilities
         using time_point = std::chrono::time_point<NucleoF767ZIClock_t>;
         static constexpr bool is_steady = true;
 
-        // This method/approach has been proven to work. Yay!
+        // Split, as ns x 216 would overflow the rep.
         static time_point now() noexcept
         {
-            return from_time_t(time(NULL));
+            const int64_t utc = g_ClockService.Now();
+
+            return from_time_t(static_cast<std::time_t>(utc / 1'000'000'000))
+                + duration((utc % 1'000'000'000) * period::den / 1'000'000'000);
         }
 
         // This method/approach has been proven to work. Yay!
@@ -326,14 +425,178 @@ namespace Utilities
         return result;
     }
     
+    // Allocation-free formatting into caller-provided buffers, suitable
+    // for the acquisition hot path. None of these touch the heap or the
+    // iostream/locale machinery. Each returns a view of the characters
+    // written; the buffer is always NUL-terminated as well, so that the
+    // view's data() may be handed straight to printf("%s"). Should the
+    // buffer be too small, an empty view (and empty string) results.
+    constexpr std::size_t FORMAT_BUFFER_SIZE = 32;
+    using FormatBuffer_t = std::array<char, FORMAT_BUFFER_SIZE>;
+
+    // Sufficient for 64-bit values; more would overflow the scaling.
+    constexpr int MAXIMUM_FORMAT_DECIMAL_DIGITS = 9;
+
+    inline std::string_view FormatFailure(std::span<char> buffer)
+    {
+        if (buffer.empty())
+        {
+            return std::string_view();
+        }
+
+        // Empty, yet data() still refers to a valid (empty) C string.
+        buffer[0] = '\0';
+        return std::string_view(buffer.data(), 0);
+    }
+
+    template <std::integral T>
+    std::string_view FormatInteger(std::span<char> buffer, const T& value)
+    {
+        if (buffer.empty())
+        {
+            return FormatFailure(buffer);
+        }
+
+        // Reserve the last character for the terminating NUL.
+        auto [last, ec] = std::to_chars(buffer.data(), 
+                                        buffer.data() + buffer.size() - 1, 
+                                        value);
+        if (ec != std::errc())
+        {
+            return FormatFailure(buffer);
+        }
+
+        *last = '\0';
+        return std::string_view(buffer.data(), static_cast<std::size_t>(last - buffer.data()));
+    }
+
+    // Renders scaled / 10^decimalDigits in fixed notation, using integer
+    // arithmetic only. The building block of the formatters below.
+    inline std::string_view FormatScaledInteger(std::span<char> buffer, 
+                                                const int64_t& scaled, 
+                                                const int& decimalDigits)
+    {
+        if (buffer.empty() || (decimalDigits < 0) 
+                           || (decimalDigits > MAXIMUM_FORMAT_DECIMAL_DIGITS))
+        {
+            return FormatFailure(buffer);
+        }
+
+        char*       first = buffer.data();
+        char* const end   = buffer.data() + buffer.size() - 1; // Room for NUL.
+
+        // Negate in the unsigned domain to tolerate INT64_MIN.
+        uint64_t magnitude = (scaled < 0) ? (uint64_t{0} - static_cast<uint64_t>(scaled))
+                                          : static_cast<uint64_t>(scaled);
+        if (scaled < 0)
+        {
+            if (first == end)
+            {
+                return FormatFailure(buffer);
+            }
+            *first++ = '-';
+        }
+
+        const auto divisor = pown<uint64_t>(10, static_cast<unsigned>(decimalDigits));
+
+        auto [last, ec] = std::to_chars(first, end, magnitude / divisor);
+        if (ec != std::errc())
+        {
+            return FormatFailure(buffer);
+        }
+
+        if (decimalDigits > 0)
+        {
+            if ((end - last) < (decimalDigits + 1))
+            {
+                return FormatFailure(buffer);
+            }
+
+            *last++ = '.';
+
+            // Fractional digits, zero-padded, least significant first.
+            auto fraction = magnitude % divisor;
+            for (int i = decimalDigits - 1; i >= 0; --i)
+            {
+                last[i] = static_cast<char>('0' + (fraction % 10));
+                fraction /= 10;
+            }
+            last += decimalDigits;
+        }
+
+        *last = '\0';
+        return std::string_view(buffer.data(), static_cast<std::size_t>(last - buffer.data()));
+    }
+
+    // std::fixed with the given precision, as TruncateAndToString below,
+    // only without any allocation. (GCC 10 has no floating-point 
+    // std::to_chars, hence the value is rounded to a scaled integer.)
+    template <std::floating_point T>
+    std::string_view FormatFixed(std::span<char> buffer, const T& x, const int& decimalDigits = 2)
+    {
+        if ((decimalDigits < 0) || (decimalDigits > MAXIMUM_FORMAT_DECIMAL_DIGITS))
+        {
+            return FormatFailure(buffer);
+        }
+
+        // Widen first, so that float inputs lose nothing in the scaling.
+        const double scaled = static_cast<double>(x) 
+                            * static_cast<double>(pown<int64_t>(10, static_cast<unsigned>(decimalDigits)));
+
+        // Also catches NaN, for which both comparisons are false.
+        constexpr double LIMIT = 9.0e18;
+        if (!((scaled > -LIMIT) && (scaled < LIMIT)))
+        {
+            const std::string_view text = std::isnan(scaled) ? "nan" 
+                                        : ((scaled < 0.0) ? "-inf" : "inf");
+
+            if (buffer.size() <= text.size())
+            {
+                return FormatFailure(buffer);
+            }
+            std::copy(text.begin(), text.end(), buffer.begin());
+            buffer[text.size()] = '\0';
+            return std::string_view(buffer.data(), text.size());
+        }
+
+        // Round half away from zero, as the iostreams would.
+        const auto rounded = static_cast<int64_t>((scaled < 0.0) ? (scaled - 0.5) : (scaled + 0.5));
+
+        return FormatScaledInteger(buffer, rounded, decimalDigits);
+    }
+
+    // "0x" followed by two upper-case hexadecimal digits per byte.
+    inline std::string_view FormatHex(std::span<char> buffer, std::span<const char> bytes)
+    {
+        constexpr char DIGITS[] = "0123456789ABCDEF";
+
+        if (buffer.size() < (2 + (bytes.size() * 2) + 1))
+        {
+            return FormatFailure(buffer);
+        }
+
+        auto last = buffer.begin();
+        *last++ = '0';
+        *last++ = 'x';
+
+        for (const auto& byte : bytes)
+        {
+            const auto value = static_cast<uint8_t>(byte);
+            *last++ = DIGITS[value >> 4];
+            *last++ = DIGITS[value & 0x0F];
+        }
+        *last = '\0';
+
+        return std::string_view(buffer.data(), static_cast<std::size_t>(last - buffer.begin()));
+    }
+
+    // Kept for the non-critical paths; now formatted by FormatFixed() so
+    // the only remaining cost is the std::string itself.
     template <typename T>
     constexpr auto TruncateAndToString = [](const T& x, const int& decimalDigits = 2)
     {
-        std::ostringstream oss;  
-        oss << std::fixed;
-        oss.precision(decimalDigits);
-        oss << x;
-        return oss.str();
+        FormatBuffer_t buffer{};
+        return std::string(FormatFixed(buffer, x, decimalDigits));
     };
     
     const auto TemperatureToString = [](const float& temperature)
@@ -388,21 +651,18 @@ namespace Utilities
             {
                 domainName.emplace(address);
                 SocketAddress serverSocketAddress;
-                nsapi_size_or_error_t retVal;
 
-                // Resolve Domain Name :
-                do
+                // Resolve Domain Name, from the cache if at all possible.
+                // Failures are backed off from, rather than spun on; the
+                // IP address is then empty.
+                if (g_DNSCache.Resolve(address.c_str(), &serverSocketAddress) == NSAPI_ERROR_OK)
+                {
+                    ipAddress = std::string(serverSocketAddress.get_ip_address());
+                }
+                else
                 {
-                    printf("\r\nPerforming DNS lookup for : \"%s\" ...", address.c_str());
-                    retVal = g_EthernetInterface.gethostbyname(address.c_str(), &serverSocketAddress);
-                    if (retVal < 0)
-                    {
-                        printf("\r\nError! On DNS lookup, Network returned: [%d] -> %s", retVal, ToString(retVal).c_str());
-                    }
-                }  while (retVal < 0);
-
-                //g_EthernetInterface.get_ip_address(&serverSocketAddress);
-                ipAddress = std::string(serverSocketAddress.get_ip_address());
+                    ipAddress.clear();
+                }
             }
         }
 
@@ -428,126 +688,5 @@ namespace Utilities
         stream << std::dec << std::to_string(i);
         return stream.str();
     }
-
-    const auto ComposeSystemStatistics = []()
-    {
-        // Show the network address:
-        SocketAddress socketAddress;
-        g_EthernetInterface.get_ip_address(&socketAddress);
-        const char * ip = socketAddress.get_ip_address();
-        
-        SocketAddress socketAddress1;
-        g_EthernetInterface.get_netmask(&socketAddress1);        
-        const char * netmask = socketAddress1.get_ip_address();
-        
-        SocketAddress socketAddress2;
-        g_EthernetInterface.get_gateway(&socketAddress2);
-        const char * gateway = socketAddress2.get_ip_address();
-        
-        // "Provided MAC address is intended for info or debug purposes
-        // and may be not provided if the underlying network interface
-        // does not provide a MAC address."
-        const char * mac = g_EthernetInterface.get_mac_address();
-
-        mbed_stats_sys_t stats;
-        mbed_stats_sys_get(&stats);
-
-        uint8_t implementer = ((stats.cpu_id >> 24) & 0xff);
-        uint8_t variant = ((stats.cpu_id >> 20) & 0x0f);
-        uint8_t architecture = ((stats.cpu_id >> 16) & 0x0f);
-        uint16_t partno = ((stats.cpu_id >> 4) & 0x0fff);
-        uint8_t revno = (stats.cpu_id & 0x0f);
-
-        // Note that enabling heap statistics (effected in mbed_app.json)
-        // MAY expose a 'Memory out-of-bound access' vulnerability due
-        // to integer overflow. Hence it is NOT recommended that you 
-        // enable in production software. Fixed in Mbed OS 5.15.7 and 6.9. 
-        //
-        // https://os.mbed.com/blog/entry/Memory-out-of-bound-access-vulnerability/ 
-        mbed_stats_heap_t heapStats;
-        mbed_stats_heap_get(&heapStats);
-
-        // An alternative to the previous manual serialization approach is to
-        // simply employ picojson with int64_t support and exceptions disabled.
-        picojson::object jsonObject1;
-        picojson::object jsonObject2;
-        picojson::object jsonObject3;
-        picojson::object jsonObject4;
-        
-        // Populate the object keys with an arbitrarily contrived alphabetic
-        // prefix so that the eventual serialized prettified string would
-        // be arranged in some manner conducive to use (i.e. preferred display format). 
-        jsonObject1["[a] Module"] 
-            = picojson::value("Nuertey Odzeyem - Nucleo-F767ZI Device Statistics");
-        jsonObject1["[b] RTC Current Time"] 
-            = picojson::value(WhatTimeNow());
-        
-        // Note that ternary operators must work on the same type for the
-        // second and third operands, or implicitly convertible types anyway.
-        jsonObject1["[c] MAC Address"] = picojson::value(std::string(mac ? mac : "None"));
-        jsonObject1["[d] IP Address"] = picojson::value(std::string(ip ? ip : "None"));
-        jsonObject1["[e] Netmask"] = picojson::value(std::string(netmask ? netmask : "None"));
-        jsonObject1["[f] Gateway"] = picojson::value(std::string(gateway ? gateway : "None"));
-        
-        #ifdef MBED_MAJOR_VERSION
-            jsonObject2["[g] MBED OS Version"] = picojson::value(
-                              std::to_string(MBED_MAJOR_VERSION) + "."
-                            + std::to_string(MBED_MINOR_VERSION) + "."
-                            + std::to_string(MBED_PATCH_VERSION));
-        #endif
-        jsonObject2["[h] MBED OS Version (populated only for tagged releases)"] 
-            = picojson::value(std::to_string(stats.os_version));
-        jsonObject2["[i] Compiler ID"] 
-            = picojson::value(std::string((stats.compiler_id == ARM) ? "ARM" : "")
-            + std::string((stats.compiler_id == GCC_ARM) ? "GCC_ARM" : "")
-            + std::string((stats.compiler_id == IAR) ? "IAR" : ""));
-        jsonObject2["[j] Compiler Version"] 
-            = picojson::value(std::to_string(stats.compiler_version));
-        jsonObject2["[k] Device SystemClock"] 
-            = picojson::value(std::to_string(SystemCoreClock) 
-            + std::string(" Hz"));
-
-        jsonObject3["[l] CPUID Base Register Values (Cortex-M only supported)"] 
-            = picojson::value(IntegerToHex(stats.cpu_id));
-        jsonObject3["[m] Implementer"] 
-            = picojson::value(std::string((implementer == 0x41) ? "ARM" 
-                                          : IntegerToHex(implementer)));
-        jsonObject3["[n] Variant"] 
-            = picojson::value(std::to_string(variant));
-        jsonObject3["[o] Architecture"] 
-            = picojson::value(std::string((architecture == 0x0c) ? "Baseline" : "")
-            + std::string((architecture == 0x0f) ? "Constant i.e. Mainline" : ""));
-        jsonObject3["[p] Part Number"] 
-            = picojson::value(std::string((partno == 0x0c20) ? "Cortex-M0" : "")
-            + std::string((partno == 0x0c60) ? "Cortex-M0+" : "")
-            + std::string((partno == 0x0c23) ? "Cortex-M3" : "")
-            + std::string((partno == 0x0c24) ? "Cortex-M4" : "")
-            + std::string((partno == 0x0c27) ? "Cortex-M7" : "")
-            + std::string((partno == 0x0d20) ? "Cortex-M23" : "")
-            + std::string((partno == 0x0d21) ? "Cortex-M33" : ""));
-        jsonObject3["[q] Revision"] = picojson::value(IntegerToHex(revno));
-
-        jsonObject4["[r] Bytes allocated on heap"] 
-            = picojson::value(std::to_string(heapStats.current_size));
-        jsonObject4["[s] Maximum bytes allocated on heap at one time since reset"] 
-            = picojson::value(std::to_string(heapStats.max_size));
-        jsonObject4["[t] Cumulative sum of bytes allocated on heap not freed"] 
-            = picojson::value(std::to_string(heapStats.total_size));
-        jsonObject4["[u] Number of bytes reserved for heap"] 
-            = picojson::value(std::to_string(heapStats.reserved_size));
-        jsonObject4["[v] Number of allocations not freed since reset"] 
-            = picojson::value(std::to_string(heapStats.alloc_cnt));
-        jsonObject4["[w] Number of failed allocations since reset"] 
-            = picojson::value(std::to_string(heapStats.alloc_fail_cnt));
-
-        // The boolean is to enable prettified output with newlines.
-        // JSON was not invented for humans after all, so otherwise things would look ugly. 
-        std::string rawString1 = picojson::value(jsonObject1).serialize(true);
-        std::string rawString2 = picojson::value(jsonObject2).serialize(true);
-        std::string rawString3 = picojson::value(jsonObject3).serialize(true);
-        std::string rawString4 = picojson::value(jsonObject4).serialize(true);
-        
-        return std::make_tuple(rawString1, rawString2, rawString3, rawString4);
-    };
 } //end of namespace
 
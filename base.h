@@ -1,7 +1,11 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <array>
+#include <algorithm>
+#include <cstdint>
 #include <type_traits>
 #include <system_error>
 #include <cstdlib>
@@ -147,204 +151,294 @@ namespace jwt
 {
     namespace alphabet
     {
+        // Sextets with the top bit set, i.e. 0xFF, are not of the alphabet.
+        constexpr uint8_t INVALID_SEXTET = 0xFF;
+
+        constexpr std::array<uint8_t, 256> make_decode_table(const std::array<char, 64>& alphabet)
+        {
+            std::array<uint8_t, 256> table{};
+            for (auto& sextet : table)
+            {
+                sextet = INVALID_SEXTET;
+            }
+            for (size_t i = 0; i < alphabet.size(); i++)
+            {
+                table[static_cast<unsigned char>(alphabet[i])] = static_cast<uint8_t>(i);
+            }
+            return table;
+        }
+
         struct base64
         {
-            static const std::array<char, 64>& data()
+            static constexpr std::array<char, 64> encode_table =
             {
-                static std::array<char, 64> data =
                 {
-                    {
-                        'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
-                        'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
-                        'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
-                        'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
-                    }
-                };
-                return data;
+                    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+                    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+                    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+                    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+                }
+            };
+            static constexpr std::array<uint8_t, 256> decode_table = make_decode_table(encode_table);
+            static constexpr std::string_view fill_sequence = "=";
+
+            static const std::array<char, 64>& data()
+            {
+                return encode_table;
             };
             static const std::string& fill()
             {
-                static std::string fill = "=";
+                static std::string fill(fill_sequence);
                 return fill;
             }
         };
         struct base64url
         {
-            static const std::array<char, 64>& data()
+            static constexpr std::array<char, 64> encode_table =
             {
-                static std::array<char, 64> data =
                 {
-                    {
-                        'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
-                        'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
-                        'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
-                        'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '_'
-                    }
-                };
-                return data;
+                    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+                    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+                    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+                    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '_'
+                }
+            };
+            static constexpr std::array<uint8_t, 256> decode_table = make_decode_table(encode_table);
+            static constexpr std::string_view fill_sequence = "%3d";
+
+            static const std::array<char, 64>& data()
+            {
+                return encode_table;
             };
             static const std::string& fill()
             {
-                static std::string fill = "%3d";
+                static std::string fill(fill_sequence);
                 return fill;
             }
         };
     }
 
+    // The std::string overloads merely size the result exactly, the once,
+    // and then encode or decode into it in place. The std::span overloads
+    // allocate nothing at all; both the lookup tables are constexpr, hence
+    // in flash. Decoding accepts input with or without the fill.
     class base
     {
     public:
         template<typename T>
-        static std::string encode(const std::string& bin)
+        static std::string encode(const std::string& bin, bool pad = true)
         {
-            return encode(bin, T::data(), T::fill());
+            std::string res(encoded_size<T>(bin.size(), pad), '\0');
+            encode<T>(std::span<char>(res), 
+                      std::span<const unsigned char>(reinterpret_cast<const unsigned char*>(bin.data()), bin.size()),
+                      pad);
+            return res;
         }
         template<typename T>
         static std::string decode(const std::string& base, std::error_code& ec)
         {
-            return decode(base, T::data(), T::fill(), ec);
+            std::string res(decoded_size<T>(base, ec), '\0');
+            if (ec)
+                return "";
+
+            decode<T>(std::span<unsigned char>(reinterpret_cast<unsigned char*>(res.data()), res.size()), base, ec);
+            if (ec)
+                return "";
+
+            return res;
         }
 
-    private:
-        static std::string encode(const std::string& bin, const std::array<char, 64>& alphabet, const std::string& fill)
+        // Exact number of characters bin_size bytes encode to.
+        template<typename T>
+        static constexpr size_t encoded_size(size_t bin_size, bool pad = true)
         {
-            size_t size = bin.size();
-            std::string res;
+            const size_t mod = bin_size % 3;
+            size_t size = bin_size / 3 * 4;
 
-            // clear incomplete bytes
-            size_t fast_size = size - size % 3;
-            for (size_t i = 0; i < fast_size;)
+            if (mod != 0)
             {
-                uint32_t octet_a = (unsigned char)bin[i++];
-                uint32_t octet_b = (unsigned char)bin[i++];
-                uint32_t octet_c = (unsigned char)bin[i++];
+                size += mod + 1;
+                if (pad)
+                    size += (3 - mod) * T::fill_sequence.size();
+            }
+            return size;
+        }
+
+        // Exact number of bytes base decodes to, were it valid.
+        template<typename T>
+        static size_t decoded_size(std::string_view base, std::error_code& ec)
+        {
+            const size_t size = unfilled_size<T>(base, ec);
+            if (ec)
+                return 0;
 
-                uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+            return size / 4 * 3 + ((size % 4) ? (size % 4 - 1) : 0);
+        }
 
-                res += alphabet[(triple >> 3 * 6) & 0x3F];
-                res += alphabet[(triple >> 2 * 6) & 0x3F];
-                res += alphabet[(triple >> 1 * 6) & 0x3F];
-                res += alphabet[(triple >> 0 * 6) & 0x3F];
+        // Returns the number of characters written to out, which must have
+        // room for encoded_size() of them; zero, and ec set, otherwise.
+        template<typename T>
+        static size_t encode(std::span<char> out, std::span<const unsigned char> bin, bool pad, std::error_code& ec)
+        {
+            if (out.size() < encoded_size<T>(bin.size(), pad))
+            {
+                tr_error("Output buffer too small");
+                ec = make_error_code(ErrorStatus_t::BUFFER_SIZE_INSUFFICIENT_ERROR);
+                return 0;
             }
+            return encode<T>(out, bin, pad);
+        }
 
-            if (fast_size == size)
-                return res;
+        // Returns the number of bytes written to out, which must have room
+        // for decoded_size() of them; zero, and ec set, otherwise.
+        template<typename T>
+        static size_t decode(std::span<unsigned char> out, std::string_view base, std::error_code& ec)
+        {
+            const size_t size = unfilled_size<T>(base, ec);
+            if (ec)
+                return 0;
 
-            size_t mod = size % 3;
+            const size_t out_size = size / 4 * 3 + ((size % 4) ? (size % 4 - 1) : 0);
+            if (out.size() < out_size)
+            {
+                tr_error("Output buffer too small");
+                ec = make_error_code(ErrorStatus_t::BUFFER_SIZE_INSUFFICIENT_ERROR);
+                return 0;
+            }
 
-            uint32_t octet_a = fast_size < size ? (unsigned char)bin[fast_size++] : 0;
-            uint32_t octet_b = fast_size < size ? (unsigned char)bin[fast_size++] : 0;
-            uint32_t octet_c = fast_size < size ? (unsigned char)bin[fast_size++] : 0;
+            const auto& table = T::decode_table;
+            auto sextet = [&](size_t offset)
+            {
+                return static_cast<uint32_t>(table[static_cast<unsigned char>(base[offset])]);
+            };
 
-            uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+            // Invalid characters are accumulated, and checked but the once
+            // per block.
+            uint32_t invalid = 0;
+            size_t j = 0;
 
-            switch (mod)
+            size_t fast_size = size - size % 4;
+            for (size_t i = 0; i < fast_size; i += 4)
             {
-            case 1:
-                res += alphabet[(triple >> 3 * 6) & 0x3F];
-                res += alphabet[(triple >> 2 * 6) & 0x3F];
-                res += fill;
-                res += fill;
-                break;
-            case 2:
-                res += alphabet[(triple >> 3 * 6) & 0x3F];
-                res += alphabet[(triple >> 2 * 6) & 0x3F];
-                res += alphabet[(triple >> 1 * 6) & 0x3F];
-                res += fill;
-                break;
-            default:
-                break;
-            }
+                uint32_t sextet_a = sextet(i);
+                uint32_t sextet_b = sextet(i + 1);
+                uint32_t sextet_c = sextet(i + 2);
+                uint32_t sextet_d = sextet(i + 3);
 
-            return res;
-        }
+                invalid |= sextet_a | sextet_b | sextet_c | sextet_d;
 
-        static std::string decode(const std::string& base, 
-                                  const std::array<char, 64>& alphabet, 
-                                  const std::string& fill,
-                                  std::error_code& ec)
-        {
-            size_t size = base.size();
+                uint32_t triple = (sextet_a << 3 * 6)
+                                  + (sextet_b << 2 * 6)
+                                  + (sextet_c << 1 * 6)
+                                  + (sextet_d << 0 * 6);
 
-            size_t fill_cnt = 0;
-            while (size > fill.size())
+                out[j++] = (triple >> 2 * 8) & 0xFF;
+                out[j++] = (triple >> 1 * 8) & 0xFF;
+                out[j++] = (triple >> 0 * 8) & 0xFF;
+            }
+
+            if (size != fast_size)
             {
-                if (base.substr(size - fill.size(), fill.size()) == fill)
-                {
-                    fill_cnt++;
-                    size -= fill.size();
-                    if (fill_cnt > 2)
-                    {
-                        tr_error("Invalid input");
-                        ec = make_error_code(ErrorStatus_t::INVALID_INPUT_RUNTIME_ERROR);
-                        return "";
-                    }
-                }
-                else break;
+                uint32_t sextet_a = sextet(fast_size);
+                uint32_t sextet_b = sextet(fast_size + 1);
+                uint32_t sextet_c = (size % 4 == 3) ? sextet(fast_size + 2) : 0;
+
+                invalid |= sextet_a | sextet_b | sextet_c;
+
+                uint32_t triple = (sextet_a << 3 * 6)
+                                  + (sextet_b << 2 * 6)
+                                  + (sextet_c << 1 * 6);
+
+                out[j++] = (triple >> 2 * 8) & 0xFF;
+                if (size % 4 == 3)
+                    out[j++] = (triple >> 1 * 8) & 0xFF;
             }
 
-            if ((size + fill_cnt) % 4 != 0)
+            if (invalid & 0x80)
             {
                 tr_error("Invalid input");
                 ec = make_error_code(ErrorStatus_t::INVALID_INPUT_RUNTIME_ERROR);
-                return "";
+                return 0;
             }
 
-            size_t out_size = size / 4 * 3;
-            std::string res;
-            res.reserve(out_size);
+            return j;
+        }
 
-            auto get_sextet = [&](size_t offset, std::error_code& ec)
-            {
-                for (size_t i = 0; i < alphabet.size(); i++)
-                {
-                    if (alphabet[i] == base[offset])
-                        return i;
-                }
-                tr_error("Invalid input");
-                ec = make_error_code(ErrorStatus_t::INVALID_INPUT_RUNTIME_ERROR);
-                return (size_t)0;
-            };
+    private:
+        template<typename T>
+        static size_t encode(std::span<char> out, std::span<const unsigned char> bin, bool pad)
+        {
+            const auto& alphabet = T::encode_table;
+            size_t size = bin.size();
+            size_t j = 0;
 
-            size_t fast_size = size - size % 4;
-            for (size_t i = 0; i < fast_size;)
+            // clear incomplete bytes
+            size_t fast_size = size - size % 3;
+            for (size_t i = 0; i < fast_size; i += 3)
             {
-                uint32_t sextet_a = get_sextet(i++, ec);
-                uint32_t sextet_b = get_sextet(i++, ec);
-                uint32_t sextet_c = get_sextet(i++, ec);
-                uint32_t sextet_d = get_sextet(i++, ec);
+                uint32_t triple = (uint32_t(bin[i]) << 0x10) + (uint32_t(bin[i + 1]) << 0x08) + bin[i + 2];
 
-                uint32_t triple = (sextet_a << 3 * 6)
-                                  + (sextet_b << 2 * 6)
-                                  + (sextet_c << 1 * 6)
-                                  + (sextet_d << 0 * 6);
+                out[j++] = alphabet[(triple >> 3 * 6) & 0x3F];
+                out[j++] = alphabet[(triple >> 2 * 6) & 0x3F];
+                out[j++] = alphabet[(triple >> 1 * 6) & 0x3F];
+                out[j++] = alphabet[(triple >> 0 * 6) & 0x3F];
+            }
+
+            if (fast_size == size)
+                return j;
 
-                res += (triple >> 2 * 8) & 0xFF;
-                res += (triple >> 1 * 8) & 0xFF;
-                res += (triple >> 0 * 8) & 0xFF;
+            size_t mod = size % 3;
+
+            uint32_t octet_a = bin[fast_size];
+            uint32_t octet_b = (mod == 2) ? bin[fast_size + 1] : 0;
+
+            uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08);
+
+            out[j++] = alphabet[(triple >> 3 * 6) & 0x3F];
+            out[j++] = alphabet[(triple >> 2 * 6) & 0x3F];
+            if (mod == 2)
+                out[j++] = alphabet[(triple >> 1 * 6) & 0x3F];
+
+            if (pad)
+            {
+                for (size_t k = mod; k < 3; k++)
+                {
+                    j = std::copy(T::fill_sequence.begin(), T::fill_sequence.end(), out.begin() + j) - out.begin();
+                }
             }
 
-            if (fill_cnt == 0)
-                return res;
+            return j;
+        }
 
-            uint32_t triple = (get_sextet(fast_size, ec) << 3 * 6)
-                              + (get_sextet((fast_size + 1), ec) << 2 * 6);
+        // Length of base less its trailing fill, which is validated.
+        template<typename T>
+        static size_t unfilled_size(std::string_view base, std::error_code& ec)
+        {
+            constexpr auto fill = T::fill_sequence;
+            size_t size = base.size();
+
+            size_t fill_cnt = 0;
+            while ((size >= fill.size()) && (base.substr(size - fill.size(), fill.size()) == fill))
+            {
+                fill_cnt++;
+                size -= fill.size();
+                if (fill_cnt > 2)
+                {
+                    tr_error("Invalid input");
+                    ec = make_error_code(ErrorStatus_t::INVALID_INPUT_RUNTIME_ERROR);
+                    return 0;
+                }
+            }
 
-            switch (fill_cnt)
+            // Unpadded input, as in a JWT, is as acceptable as padded.
+            if ((size % 4 == 1) || (fill_cnt && ((size + fill_cnt) % 4 != 0)))
             {
-            case 1:
-                triple |= (get_sextet((fast_size + 2), ec) << 1 * 6);
-                res += (triple >> 2 * 8) & 0xFF;
-                res += (triple >> 1 * 8) & 0xFF;
-                break;
-            case 2:
-                res += (triple >> 2 * 8) & 0xFF;
-                break;
-            default:
-                break;
+                tr_error("Invalid input");
+                ec = make_error_code(ErrorStatus_t::INVALID_INPUT_RUNTIME_ERROR);
+                return 0;
             }
 
-            return res;
+            return size;
         }
     };
 }
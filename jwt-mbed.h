@@ -1713,39 +1713,8 @@ namespace jwt
             payload = payload_base64 = token.substr(hdr_end + 1, payload_end - hdr_end - 1);
             signature = signature_base64 = token.substr(payload_end + 1);
 
-            // Fix padding: JWT requires padding to get removed
-            auto fix_padding = [](std::string& str)
-            {
-                switch (str.size() % 4)
-                {
-                case 1:
-                    str += alphabet::base64url::fill();
-#ifdef __cpp_attributes
-#if __has_cpp_attribute(fallthrough)
-                    [[fallthrough]];
-#endif
-#endif
-                case 2:
-                    str += alphabet::base64url::fill();
-#ifdef __cpp_attributes
-#if __has_cpp_attribute(fallthrough)
-                    [[fallthrough]];
-#endif
-#endif
-                case 3:
-                    str += alphabet::base64url::fill();
-#ifdef __cpp_attributes
-#if __has_cpp_attribute(fallthrough)
-                    [[fallthrough]];
-#endif
-#endif
-                default:
-                    break;
-                }
-            };
-            fix_padding(header);
-            fix_padding(payload);
-            fix_padding(signature);
+            // JWT requires padding to get removed; base::decode() accepts
+            // input without it.
 
             std::error_code ec1;
             std::error_code ec2;
@@ -2025,10 +1994,7 @@ namespace jwt
 
             auto encode = [](const std::string& data)
             {
-                auto base = base::encode<alphabet::base64url>(data);
-                auto pos = base.find(alphabet::base64url::fill());
-                base = base.substr(0, pos);
-                return base;
+                return base::encode<alphabet::base64url>(data, false);
             };
 
             std::string headerTemp = picojson::value(obj_header).serialize();
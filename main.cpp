@@ -30,6 +30,14 @@
 * @copyright Copyright (c) 2021 Nuertey Odzeyem. All Rights Reserved.
 ***********************************************************************/
 #include "NuerteyLDESeriesDevice.h"
+#include "NuerteyLDESeriesBusManager.h"
+#include "NuerteyLDESeriesSampler.h"
+#include "NuerteyLDESeriesPipeline.h"
+#include "NuerteyLDESeriesLowPowerSampler.h"
+#include "NuerteyTelemetryPublisher.h"
+#include "NuerteyLDESeriesTrigger.h"
+#include "NuerteyHealthMonitor.h"
+#include "FlashIAPBlockDevice.h"
 
 #define LED_ON  1
 #define LED_OFF 0
@@ -97,6 +105,77 @@
 //        PinName ssel
 NuerteyLDESeriesDevice g_LDESeriesDevice(D11, D12, D13, D10); 
 
+// A rig of further sensors, sharing a second SPI bus, SPI3 on CN8, each on
+// its own chip select; devices on it are driven through the manager alone.
+//
+// TBD, do actually connect these pins to the sensors once they arrive.
+//
+//        PinName mosi (PC_12)
+//        PinName miso (PC_11)
+//        PinName sclk (PC_10)
+//        Chip selects PG_2, PG_3
+NuerteyLDESeriesBusManager g_LDESeriesBusManager(PC_12, PC_11, PC_10);
+
+// Tracks, and persists across reboots, the above device's zero offset.
+NuerteyLDESeriesAutoZero g_LDESeriesAutoZero(&Utilities::gs_MasterEventQueue);
+
+// Continuous, high-rate acquisition of the above device's raw pressure counts.
+NuerteyLDESeriesSampler<> g_LDESeriesSampler(g_LDESeriesDevice);
+
+// Per-device temperature compensation, as characterized over the
+// installation's temperature range; the figures here are illustrative.
+// Generated at compile-time, hence in flash.
+constexpr auto g_LDESeriesCompensation = MakeTemperatureCompensationTable(std::array{
+    TemperatureCalibrationPoint_t{static_cast<int16_t>(0 * TEMPERATURE_SCALING_FACTOR),  1.000f,  0.0f},
+    TemperatureCalibrationPoint_t{static_cast<int16_t>(25 * TEMPERATURE_SCALING_FACTOR), 1.000f,  0.0f},
+    TemperatureCalibrationPoint_t{static_cast<int16_t>(50 * TEMPERATURE_SCALING_FACTOR), 0.995f, -8.0f}});
+
+// Decimation, filtering and windowed statistics of the sampler's readings.
+NuerteyLDESeriesPipeline<LDE_S250_B_t, DryAirAtmosphere_t,
+                         decltype(g_LDESeriesSampler)::SampleBuffer_t>
+    g_LDESeriesPipeline(g_LDESeriesSampler.GetSampleBuffer());
+
+// Or, on battery, duty-cycled bursts in between deep sleep.
+NuerteyLDESeriesLowPowerSampler<LDE_S250_B_t, DryAirAtmosphere_t> g_LDESeriesLowPowerSampler(g_LDESeriesDevice);
+
+// The last 256 KiB of the 2 MiB of flash, i.e. sector 11, or sectors 22
+// and 23 of bank 2 in dual bank mode; there, erasing does not stall the
+// code in bank 1. See mbed_app.json.
+#if defined(MBED_CONF_APP_JOURNAL_BASE_ADDRESS) && defined(MBED_CONF_APP_JOURNAL_SIZE)
+FlashIAPBlockDevice g_JournalBlockDevice(MBED_CONF_APP_JOURNAL_BASE_ADDRESS, MBED_CONF_APP_JOURNAL_SIZE);
+#else
+FlashIAPBlockDevice g_JournalBlockDevice(0x081C0000, 0x40000);
+#endif
+
+// Store-and-forward of the publisher's readings across outages and reboots.
+NuerteyFlashJournal g_FlashJournal(&g_JournalBlockDevice);
+
+// Batches the sampler's raw readings to the broker, over the session that
+// the connection manager keeps up; stores-and-forwards whilst it is down.
+NuerteyTelemetryPublisher<Utilities::MQTTClient_t, decltype(g_LDESeriesSampler)::SampleBuffer_t>
+    g_TelemetryPublisher(Utilities::g_MQTTClient, g_LDESeriesSampler.GetSampleBuffer(), "lde/pressure",
+                         TelemetryEncoding_t::JSON,
+                         std::chrono::microseconds(CONTINUOUS_ACQUISITION_PERIOD_USECS),
+                         MQTT::QOS1, &Utilities::g_ConnectionManager);
+
+// A backlog batch, with room for its topic and the PUBLISH headers.
+static_assert(Utilities::MQTT_MAXIMUM_PACKET_SIZE
+              >= std::tuple_size_v<decltype(g_TelemetryPublisher)::Payload_t> + 64);
+
+// Or, but the pressure excursions, at the full rate: 128 readings either
+// side of each trigger, so that a burst fits the client's packet size.
+NuerteyLDESeriesTrigger<LDE_S250_B_t, DryAirAtmosphere_t, Utilities::MQTTClient_t,
+                        decltype(g_LDESeriesSampler)::SampleBuffer_t, 128, 128>
+    g_LDESeriesTrigger(Utilities::g_MQTTClient, g_LDESeriesSampler.GetSampleBuffer(), "lde/burst", "lde/trigger",
+                       TelemetryEncoding_t::BINARY,
+                       std::chrono::microseconds(CONTINUOUS_ACQUISITION_PERIOD_USECS),
+                       MQTT::QOS1, &Utilities::g_ConnectionManager);
+
+static_assert(Utilities::MQTT_MAXIMUM_PACKET_SIZE >= TelemetryBatchCapacity(128 + 128) + 64);
+
+// Compact, periodic runtime health records, for the publisher to send.
+NuerteyHealthMonitor g_HealthMonitor;
+
 // TBD Nuertey Odzeyem; FYI: Innovations for future usage:
 
 // "The current pin name feature is focused on two specific areas:
@@ -142,10 +221,23 @@ int main()
 
     if (Utilities::InitializeGlobalResources())
     {
-        printf("\r\n%s\r\n", Utilities::g_NetworkInterfaceInfo.c_str());
-        printf("\r\n%s\r\n", Utilities::g_SystemProfile.c_str());
-        printf("\r\n%s\r\n", Utilities::g_BaseRegisterValues.c_str());
-        printf("\r\n%s\r\n", Utilities::g_HeapStatistics.c_str());
+        {
+            // Printed the once; their pool blocks go to the health records.
+            const auto [networkInterfaceInfo, systemProfile, baseRegisterValues, heapStatistics]
+                = Utilities::ComposeSystemStatistics();
+
+            printf("\r\n%s\r\n", networkInterfaceInfo.c_str());
+            printf("\r\n%s\r\n", systemProfile.c_str());
+            printf("\r\n%s\r\n", baseRegisterValues.c_str());
+            printf("\r\n%s\r\n", heapStatistics.c_str());
+        }
+
+        // NTP completes on gs_MasterEventQueue; give it the chance to,
+        // for a few seconds at most, ere the samples are timestamped.
+        for (int i = 0; (i < 50) && !Utilities::g_ClockService.IsSynchronized(); ++i)
+        {
+            Utilities::gs_MasterEventQueue.dispatch_for(100ms);
+        }
 
         // Allow the sensor device time to stabilize from powering on 
         // and time enough for it to accumulate continuously measuring
@@ -157,43 +249,326 @@ int main()
         // pressure. \"
         ThisThread::sleep_for(25ms);        
 
+        // Readings are formatted into these, rather than into heap-allocated
+        // strings, so that they may as well be printed from the acquisition
+        // thread itself.
+        FormatBuffer_t valueBuffer{};
+        FormatBuffer_t secondValueBuffer{};
+
         // Poll and query temperature and pressure measurements from LDE
         // sensor part number, LDES250BF6S, for example:
         printf("True differential pressure as measured in a Dry Air atmosphere:\n\t->%s Pa\n\n", 
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, DryAirAtmosphere_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, DryAirAtmosphere_t>()).data());
 
         printf("True differential pressure as measured in an Oxygen Gas atmosphere (O2):\n\t-> %s Pa\n\n", 
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, OxygenGasAtmosphere_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, OxygenGasAtmosphere_t>()).data());
             
         printf("True differential pressure as measured in a Nitrogen Gas atmosphere (N2):\n\t-> %s Pa\n\n", 
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, NitrogenGasAtmosphere_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, NitrogenGasAtmosphere_t>()).data());
             
         printf("True differential pressure as measured in an Argon Gas atmosphere (Ar):\n\t-> %s Pa\n\n", 
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, ArgonGasAtmosphere_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, ArgonGasAtmosphere_t>()).data());
             
         printf("True differential pressure as measured in a Carbon Dioxide atmosphere (CO2):\n\t-> %s Pa\n\n", 
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, CarbonDioxideAtmosphere_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetPressure<LDE_S250_B_t, CarbonDioxideAtmosphere_t>()).data());
         
         printf("On-chip temperature sensor:\n\t-> %s °C\n", 
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetTemperature<Celsius_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetTemperature<Celsius_t>()).data());
         
         printf("On-chip temperature sensor:\n\t-> %s °F\n", 
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetTemperature<Fahrenheit_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetTemperature<Fahrenheit_t>()).data());
         
         printf("On-chip temperature sensor:\n\t-> %s K\n",  
-            TruncateAndToString<double>(
-            g_LDESeriesDevice.GetTemperature<Kelvin_t>()).c_str());
+            FormatFixed(valueBuffer,
+            g_LDESeriesDevice.GetTemperature<Kelvin_t>()).data());
+
+        // Or, both measurements coherently in the one bus transaction:
+        auto sample = g_LDESeriesDevice.GetSample<LDE_S250_B_t, DryAirAtmosphere_t, Celsius_t>();
+        
+        if (sample.valid)
+        {
+            printf("Combined sample at [%lld ms] since boot:\n\t-> %s Pa, %s °C\n\n",
+                sample.timestamp.time_since_epoch().count(),
+                FormatFixed(valueBuffer, sample.pressure).data(),
+                FormatFixed(secondValueBuffer, sample.temperature).data());
+
+            // The same sample as a telemetry record, streamed as JSON:
+            std::array<char, 128> recordBuffer{};
+            JSONStreamWriter writer(recordBuffer);
+            
+            if (WriteJSONRecord(writer, LDE_SERIES_SAMPLE_SCHEMA, sample).Good())
+            {
+                printf("Combined sample as a JSON record:\n\t-> %s\n\n", writer.View().data());
+            }
+        }
+
+        // The same, compensated for the temperature read alongside:
+        auto compensatedSample = g_LDESeriesDevice.GetSample<LDE_S250_B_t, DryAirAtmosphere_t>(
+            g_LDESeriesCompensation);
+
+        if (compensatedSample.valid)
+        {
+            printf("Temperature-compensated sample:\n\t-> %s Pa, %s °C\n\n",
+                FormatFixed(valueBuffer, compensatedSample.pressure).data(),
+                FormatFixed(secondValueBuffer, compensatedSample.temperature).data());
+        }
+
+        // Sensor range and gas medium may also be selected at runtime, by
+        // descriptor, with the one non-template acquisition path serving
+        // every combination:
+        constexpr std::array<LDESeriesDescriptor_t, 3> descriptors{
+            LDE_SERIES_DESCRIPTOR<LDE_S250_B_t, DryAirAtmosphere_t>,
+            LDE_SERIES_DESCRIPTOR<LDE_S250_B_t, OxygenGasAtmosphere_t>,
+            LDE_SERIES_DESCRIPTOR<LDE_S250_B_t, CarbonDioxideAtmosphere_t>};
+
+        for (const auto& descriptor : descriptors)
+        {
+            printf("Differential pressure with gas correction factor [%s]:\n\t-> %s Pa\n\n",
+                FormatFixed(valueBuffer, descriptor.gasCorrectionFactor).data(),
+                FormatFixed(secondValueBuffer, g_LDESeriesDevice.GetPressure(descriptor)).data());
+        }
+
+        // Or, from every sensor of the rig in the one round, each polled
+        // whilst the previous one is being read out:
+        g_LDESeriesBusManager.RegisterDevice<LDE_S250_B_t, DryAirAtmosphere_t>(PG_2);
+        g_LDESeriesBusManager.RegisterDevice<LDE_S500_B_t, CarbonDioxideAtmosphere_t>(PG_3);
+
+        std::array<float, NuerteyLDESeriesBusManager::MAXIMUM_NUMBER_OF_DEVICES> rigPressures{};
+
+        if (g_LDESeriesBusManager.AcquireAll(rigPressures))
+        {
+            for (std::size_t i = 0; i < g_LDESeriesBusManager.GetDeviceCount(); ++i)
+            {
+                printf("Differential pressure of rig sensor [%u]:\n\t-> %s Pa\n\n",
+                    i, FormatFixed(valueBuffer, rigPressures[i]).data());
+            }
+        }
+
+        // The same, only without blocking the calling thread for the
+        // duration of the SPI exchange. The converted measurement is
+        // delivered on gs_MasterEventQueue, so dispatch it for a while:
+        g_LDESeriesDevice.GetPressureAsync<LDE_S250_B_t, DryAirAtmosphere_t>(
+            [](double pressure)
+            {
+                FormatBuffer_t buffer{};
+                
+                printf("Asynchronously acquired differential pressure (Dry Air):\n\t-> %s Pa\n\n",
+                    FormatFixed(buffer, pressure).data());
+            });
+        Utilities::gs_MasterEventQueue.dispatch_for(100ms);
+
+        // Readings are zeroed as of the offset last persisted, and the
+        // offset tracked thereafter whenever the line is found at rest.
+        if (!g_LDESeriesAutoZero.Load())
+        {
+            printf("[%s]: Error! Failed to restore the LDE sensor zero offset; starting from zero.\n",
+                __PRETTY_FUNCTION__);
+        }
+        g_LDESeriesDevice.SetAutoZero(&g_LDESeriesAutoZero);
+
+        // Sample continuously at 1 kHz for a short while, then drain. The
+        // temperature is read every 50 ms, and the readings compensated:
+        g_LDESeriesSampler.SetTemperatureCompensation(g_LDESeriesCompensation, 50);
+
+        // The records go out through the publisher, at QoS 0, along with
+        // its queue depth, latency and failures.
+        g_HealthMonitor.SetCounterSource([](HealthCounters_t& counters)
+        {
+            counters.samples               = g_LDESeriesSampler.GetSampleCount();
+            counters.droppedSamples        = g_LDESeriesSampler.GetDroppedSampleCount()
+                                           + g_LDESeriesSampler.GetOverrunCount();
+            counters.queueDepth            = g_LDESeriesSampler.GetSampleBuffer().Size()
+                                           + g_TelemetryPublisher.GetStoredReadingCount();
+            counters.publishLatency        = static_cast<uint32_t>(
+                                                 g_TelemetryPublisher.GetPublishLatency().count());
+            counters.maximumPublishLatency = static_cast<uint32_t>(
+                                                 g_TelemetryPublisher.GetMaximumPublishLatency().count());
+            counters.publishFailures       = g_TelemetryPublisher.GetPublishFailureCount();
+        });
+        g_HealthMonitor.SetEmitter(mbed::callback(&g_TelemetryPublisher,
+                                                  &decltype(g_TelemetryPublisher)::PublishRecord));
+        g_HealthMonitor.Start();
+
+        if (g_LDESeriesSampler.Start())
+        {
+            ThisThread::sleep_for(100ms);
+            g_LDESeriesSampler.Stop();
+            
+            std::array<int16_t, 128> rawCounts{};
+            auto drained = g_LDESeriesSampler.Drain(rawCounts);
+            
+            printf("Continuous acquisition:\n\t-> %u drained, %lu acquired, %lu dropped, %lu overruns, %lu temperatures\n\n",
+                drained,
+                g_LDESeriesSampler.GetSampleCount(),
+                g_LDESeriesSampler.GetDroppedSampleCount(),
+                g_LDESeriesSampler.GetOverrunCount(),
+                g_LDESeriesSampler.GetTemperatureReadingCount());
+
+            printf("Auto-zero:\n\t-> offset %d counts, %lu quiescent windows, %lu updates\n\n",
+                g_LDESeriesAutoZero.GetOffset(),
+                g_LDESeriesAutoZero.GetQuiescentWindowCount(),
+                g_LDESeriesAutoZero.GetUpdateCount());
+                
+            // Conversion is deferred until now, and done in bulk:
+            std::array<float, rawCounts.size()> pressures{};
+            ConvertPressureBlock<LDE_S250_B_t, DryAirAtmosphere_t>(
+                std::span<const int16_t>(rawCounts.data(), drained), pressures);
+            
+            if (drained > 0)
+            {
+                printf("First and last differential pressures of the burst:\n\t-> %s Pa, %s Pa\n\n",
+                    FormatFixed(valueBuffer, pressures.front()).data(),
+                    FormatFixed(secondValueBuffer, pressures.at(drained - 1)).data());
+            }
+
+            // Over the burst, rather than waiting out the period.
+            g_HealthMonitor.Report();
+        }
+
+        // Or, rather than drain the raw readings, have them processed on
+        // the MCU: decimated 1 kHz -> 100 Hz, and summarized every 50 ms.
+        g_LDESeriesPipeline.Configure({DecimationFilter_t::CIC, 10, 20.0f, 50, true, false});
+
+        if (g_LDESeriesSampler.Start())
+        {
+            ThisThread::sleep_for(100ms);
+            g_LDESeriesSampler.Stop();
+
+            auto processed = g_LDESeriesPipeline.Process();
+
+            printf("Signal processing pipeline:\n\t-> %u processed, %u filtered pressures at [%lld us]\n\n",
+                processed,
+                g_LDESeriesPipeline.GetPressureBuffer().Size(),
+                g_LDESeriesPipeline.GetOutputPeriod().count());
+
+            LDESeriesStatistics_t statistics{};
+
+            while (g_LDESeriesPipeline.GetStatisticsBuffer().Pop(statistics))
+            {
+                std::array<char, 160> statisticsBuffer{};
+                JSONStreamWriter writer(statisticsBuffer);
+
+                if (WriteJSONRecord(writer, LDE_SERIES_STATISTICS_SCHEMA, statistics).Good())
+                {
+                    printf("Statistics window as a JSON record:\n\t-> %s\n\n", writer.View().data());
+                }
+            }
+        }
+
+        // Whatever the last boot journaled and did not get acknowledged is
+        // replayed first; outages too long for RAM are journaled anew.
+        if (g_FlashJournal.Mount())
+        {
+            g_TelemetryPublisher.SetJournal(&g_FlashJournal);
+        }
+        else
+        {
+            printf("[%s]: Error! Failed to mount the telemetry journal; storing-and-forwarding in RAM only.\n",
+                __PRETTY_FUNCTION__);
+        }
+
+        // Or, rather than process the readings on the MCU, publish them as
+        // they are, 64 to a message. Publishing happens on gs_MasterEventQueue,
+        // hence dispatch it for a while, as acquisition carries on.
+        if (g_TelemetryPublisher.Start())
+        {
+            if (g_LDESeriesSampler.Start())
+            {
+                Utilities::gs_MasterEventQueue.dispatch_for(500ms);
+                g_LDESeriesSampler.Stop();
+
+                // The partial batch remaining, of the readings since the last tick.
+                g_TelemetryPublisher.Flush();
+
+                // With the publish latencies of the above.
+                g_HealthMonitor.Report();
+            }
+            g_TelemetryPublisher.Stop();
+
+            printf("Telemetry publisher:\n\t-> %lu published, %lu failed, %u stored, %lu discarded, %lld us latency\n\n",
+                g_TelemetryPublisher.GetPublishedMessageCount(),
+                g_TelemetryPublisher.GetPublishFailureCount(),
+                g_TelemetryPublisher.GetStoredReadingCount(),
+                g_TelemetryPublisher.GetDiscardedReadingCount(),
+                g_TelemetryPublisher.GetMaximumPublishLatency().count());
+        }
+
+        // Or, rather than publish every reading, but the excursions: the
+        // readings around a crossing of +/-100 Pa, or a 20 Pa departure
+        // from the baseline, at most every 5 s.
+        g_LDESeriesTrigger.Configure({true, 100.0f, -100.0f, 0.0f, 10, 20.0f, 30.0f, 5s});
+
+        if (g_LDESeriesTrigger.Start())
+        {
+            if (g_LDESeriesSampler.Start())
+            {
+                Utilities::gs_MasterEventQueue.dispatch_for(500ms);
+                g_LDESeriesSampler.Stop();
+
+                // The readings since the last tick, and the burst they froze, if any.
+                g_LDESeriesTrigger.Process();
+                g_LDESeriesTrigger.Publish();
+            }
+            g_LDESeriesTrigger.Stop();
+
+            printf("Event-triggered capture:\n\t-> %lu triggers, %lu missed, %lu bursts published, %lu failed\n\n",
+                g_LDESeriesTrigger.GetTriggerCount(),
+                g_LDESeriesTrigger.GetMissedTriggerCount(),
+                g_LDESeriesTrigger.GetPublishedBurstCount(),
+                g_LDESeriesTrigger.GetPublishFailureCount());
+        }
+
+        // A burst of 8 samples every 500 ms, uplinked every 2 bursts. The
+        // network stays up here, hence the MCU never quite deep sleeps;
+        // on a remote unit, the uplink would rather connect, publish, and
+        // disconnect. The currents are illustrative, not measured.
+        g_LDESeriesLowPowerSampler.Configure({500ms, 8, 1ms, 2, 100.0f, 50.0f, 0.5f});
+        g_LDESeriesLowPowerSampler.SetUplink([](std::span<const LDESeriesSample_t> batch)
+        {
+            FormatBuffer_t pressureBuffer{};
+
+            printf("Low-power uplink:\n\t-> %u samples, the first at %s Pa\n\n",
+                batch.size(), FormatFixed(pressureBuffer, batch.front().pressure).data());
+            return true;
+        });
+
+        if (g_LDESeriesLowPowerSampler.Start())
+        {
+            Utilities::gs_MasterEventQueue.dispatch_for(2100ms);
+            g_LDESeriesLowPowerSampler.Stop();
+
+            std::array<char, 160> reportBuffer{};
+            JSONStreamWriter writer(reportBuffer);
+
+            if (WriteJSONRecord(writer, LDE_SERIES_LOW_POWER_REPORT_SCHEMA,
+                                g_LDESeriesLowPowerSampler.GetReport()).Good())
+            {
+                printf("Low-power duty cycle report:\n\t-> %s\n\n", writer.View().data());
+            }
+        }
+
+        // Of all the above; {} unless instrumentation-enabled is set.
+        std::array<char, 512> probeBuffer{};
+        JSONStreamWriter probeWriter(probeBuffer);
+        WriteProbeStatistics(probeWriter);
+
+        if (probeWriter.Good())
+        {
+            printf("Hot-path timings:\n\t-> %s\n\n", probeWriter.View().data());
+        }
 
         // Allow the user the chance to view the results:
         ThisThread::sleep_for(5s);
-    
+
+        g_HealthMonitor.Stop();
+        g_FlashJournal.Unmount();
         Utilities::ReleaseGlobalResources();
     }
     else